@@ -0,0 +1,196 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#include "GundamGreetings.h"
+#include "SplineBatch.h"
+
+#include "CmdLineParser.h"
+#include "Logger.h"
+#include "GenericToolbox.h"
+
+#include "TSpline.h"
+#include "TRandom3.h"
+
+#include "string"
+#include "vector"
+#include "chrono"
+#include "functional"
+#include "algorithm"
+#include <cstdlib>
+#include <cmath>
+
+
+LoggerInit([]{
+  Logger::setUserHeaderStr("[gundamSplineBenchmark.cxx]");
+});
+
+/*
+ * Compares the SplineBatch kernels with TSpline3::Eval on random splines. The spline data is packed the same way
+ * SplineDial::fillSplineData() does.
+ * */
+
+double measureNsPerEval(const std::function<void()>& evalAll_, size_t nEvalPerCall_);
+
+
+int main( int argc, char** argv ){
+  GundamGreetings g;
+  g.setAppName("SplineBenchmark");
+  g.hello();
+
+  CmdLineParser clp(argc, argv);
+  clp.addOption("nb-splines", {"-n"}, "Number of splines per kind (default: 10000).", 1);
+  clp.addOption("nb-knots", {"-k"}, "Number of knots per spline (default: 7).", 1);
+  clp.addOption("nb-x", {"-x"}, "Number of evaluated x values (default: 200).", 1);
+  clp.addOption("seed", {"-s"}, "Random seed (default: 1).", 1);
+
+  LogInfo << "Available options: " << std::endl;
+  LogInfo << clp.getConfigSummary() << std::endl;
+
+  clp.parseCmdLine();
+
+  size_t nSplines{10000};
+  int nKnots{7};
+  int nX{200};
+  int seed{1};
+  if( clp.isOptionTriggered("nb-splines") ){ nSplines = clp.getOptionVal<size_t>("nb-splines"); }
+  if( clp.isOptionTriggered("nb-knots") ){ nKnots = clp.getOptionVal<int>("nb-knots"); }
+  if( clp.isOptionTriggered("nb-x") ){ nX = clp.getOptionVal<int>("nb-x"); }
+  if( clp.isOptionTriggered("seed") ){ seed = clp.getOptionVal<int>("seed"); }
+  LogThrowIf(nKnots < 2, "At least 2 knots are needed.");
+  LogThrowIf(nSplines == 0, "No spline to evaluate.");
+
+  TRandom3 rng(seed);
+  const double xMin{-3};
+  const double xMax{3};
+
+  LogInfo << "Building " << nSplines << " splines of " << nKnots << " knots..." << std::endl;
+  std::vector<TSpline3> uniformSplineList;
+  std::vector<TSpline3> generalSplineList;
+  uniformSplineList.reserve(nSplines);
+  generalSplineList.reserve(nSplines);
+  int dimUniform{2 + 2*nKnots};
+  int dimGeneral{2 + 3*nKnots};
+  int dimMonotonic{2 + nKnots};
+  std::vector<double> uniformData, generalData, monotonicData;
+  uniformData.reserve(nSplines*dimUniform);
+  generalData.reserve(nSplines*dimGeneral);
+  monotonicData.reserve(nSplines*dimMonotonic);
+
+  std::vector<double> xKnots(nKnots), yKnots(nKnots);
+  for( size_t iSpline = 0 ; iSpline < nSplines ; iSpline++ ){
+    // Uniform knots: natural and monotonic data
+    for( int iKnot = 0 ; iKnot < nKnots ; iKnot++ ){
+      xKnots[iKnot] = xMin + (xMax - xMin)*iKnot/(nKnots-1.);
+      yKnots[iKnot] = 1 + 0.3*rng.Gaus();
+    }
+    uniformSplineList.emplace_back(Form("u%zu", iSpline), &xKnots[0], &yKnots[0], nKnots);
+    auto& uniformSpline = uniformSplineList.back();
+    uniformData.emplace_back(uniformSpline.GetXmin());
+    uniformData.emplace_back((uniformSpline.GetXmax() - uniformSpline.GetXmin())/(nKnots-1.));
+    monotonicData.emplace_back(uniformData[uniformData.size()-2]);
+    monotonicData.emplace_back(uniformData.back());
+    for( int iKnot = 0 ; iKnot < nKnots ; iKnot++ ){
+      double x, y;
+      uniformSpline.GetKnot(iKnot, x, y);
+      uniformData.emplace_back(y);
+      uniformData.emplace_back(uniformSpline.Derivative(x));
+      monotonicData.emplace_back(y);
+    }
+
+    // Non uniform knots
+    for( int iKnot = 1 ; iKnot < nKnots-1 ; iKnot++ ){
+      xKnots[iKnot] += 0.3*(xMax - xMin)/(nKnots-1.)*(rng.Uniform() - 0.5);
+    }
+    generalSplineList.emplace_back(Form("g%zu", iSpline), &xKnots[0], &yKnots[0], nKnots);
+    auto& generalSpline = generalSplineList.back();
+    generalData.emplace_back(generalSpline.GetXmin());
+    generalData.emplace_back((generalSpline.GetXmax() - generalSpline.GetXmin())/(nKnots-1.));
+    for( int iKnot = 0 ; iKnot < nKnots ; iKnot++ ){
+      double x, y;
+      generalSpline.GetKnot(iKnot, x, y);
+      generalData.emplace_back(y);
+      generalData.emplace_back(generalSpline.Derivative(x));
+      generalData.emplace_back(x);
+    }
+  }
+
+  std::vector<double> xList(nX);
+  for( auto& x : xList ){ x = rng.Uniform(xMin, xMax); }
+  std::vector<double> outList(std::max(nSplines, xList.size()));
+  double checksum{0}; // keeps the compiler from dropping the evaluations
+
+  // Reference
+  LogInfo << "Max SIMD level: " << SplineBatch::toString(SplineBatch::getMaxSimdLevel()) << std::endl;
+  LogInfo << "TSpline3::Eval (uniform):  " << measureNsPerEval([&]{
+    for( auto& x : xList ){ for( size_t iSpline = 0 ; iSpline < nSplines ; iSpline++ ){ checksum += uniformSplineList[iSpline].Eval(x); } }
+  }, nSplines*xList.size()) << " ns/eval" << std::endl;
+  LogInfo << "TSpline3::Eval (general):  " << measureNsPerEval([&]{
+    for( auto& x : xList ){ for( size_t iSpline = 0 ; iSpline < nSplines ; iSpline++ ){ checksum += generalSplineList[iSpline].Eval(x); } }
+  }, nSplines*xList.size()) << " ns/eval" << std::endl;
+
+  // Natural splines should agree with TSpline3 within the knot range
+  double maxDiff{0};
+  for( auto& x : xList ){
+    SplineBatch::setSimdLevel(SplineBatch::SimdLevel::Scalar);
+    SplineBatch::evalUniformSplines(x, uniformData.data(), dimUniform, nSplines, outList.data());
+    for( size_t iSpline = 0 ; iSpline < nSplines ; iSpline++ ){
+      maxDiff = std::max(maxDiff, std::abs(outList[iSpline] - uniformSplineList[iSpline].Eval(x)));
+    }
+    SplineBatch::evalGeneralSplines(x, generalData.data(), dimGeneral, nSplines, outList.data());
+    for( size_t iSpline = 0 ; iSpline < nSplines ; iSpline++ ){
+      maxDiff = std::max(maxDiff, std::abs(outList[iSpline] - generalSplineList[iSpline].Eval(x)));
+    }
+  }
+  LogInfo << "Max |scalar - TSpline3::Eval|: " << maxDiff << std::endl;
+
+  std::vector<double> referenceList(outList.size());
+  for( int iLevel = 0 ; iLevel <= int(SplineBatch::getMaxSimdLevel()) ; iLevel++ ){
+    auto simdLevel = SplineBatch::SimdLevel(iLevel);
+    SplineBatch::setSimdLevel(simdLevel);
+    LogWarning << SplineBatch::toString(simdLevel) << ":" << std::endl;
+
+    LogInfo << "  Uniform splines at one x:   " << measureNsPerEval([&]{
+      for( auto& x : xList ){ SplineBatch::evalUniformSplines(x, uniformData.data(), dimUniform, nSplines, outList.data()); checksum += outList[0]; }
+    }, nSplines*xList.size()) << " ns/eval" << std::endl;
+    LogInfo << "  General splines at one x:   " << measureNsPerEval([&]{
+      for( auto& x : xList ){ SplineBatch::evalGeneralSplines(x, generalData.data(), dimGeneral, nSplines, outList.data()); checksum += outList[0]; }
+    }, nSplines*xList.size()) << " ns/eval" << std::endl;
+    LogInfo << "  Monotonic splines at one x: " << measureNsPerEval([&]{
+      for( auto& x : xList ){ SplineBatch::evalMonotonicSplines(x, monotonicData.data(), dimMonotonic, nSplines, outList.data()); checksum += outList[0]; }
+    }, nSplines*xList.size()) << " ns/eval" << std::endl;
+    LogInfo << "  General spline scan:        " << measureNsPerEval([&]{
+      for( size_t iSpline = 0 ; iSpline < nSplines ; iSpline++ ){
+        SplineBatch::evalGeneralSpline(xList.data(), xList.size(), &generalData[iSpline*dimGeneral], dimGeneral, outList.data());
+        checksum += outList[0];
+      }
+    }, nSplines*xList.size()) << " ns/eval" << std::endl;
+
+    // Consistency with the scalar kernels
+    double maxSimdDiff{0};
+    for( auto& x : xList ){
+      SplineBatch::setSimdLevel(SplineBatch::SimdLevel::Scalar);
+      SplineBatch::evalMonotonicSplines(x, monotonicData.data(), dimMonotonic, nSplines, referenceList.data());
+      SplineBatch::setSimdLevel(simdLevel);
+      SplineBatch::evalMonotonicSplines(x, monotonicData.data(), dimMonotonic, nSplines, outList.data());
+      for( size_t iSpline = 0 ; iSpline < nSplines ; iSpline++ ){
+        maxSimdDiff = std::max(maxSimdDiff, std::abs(outList[iSpline] - referenceList[iSpline]));
+      }
+    }
+    LogInfo << "  Max |" << SplineBatch::toString(simdLevel) << " - scalar| (monotonic): " << maxSimdDiff << std::endl;
+  }
+
+  LogDebug << "Checksum: " << checksum << std::endl;
+
+  g.goodbye();
+  return EXIT_SUCCESS;
+}
+
+
+double measureNsPerEval(const std::function<void()>& evalAll_, size_t nEvalPerCall_){
+  evalAll_(); // warm up the caches
+  auto start = std::chrono::high_resolution_clock::now();
+  evalAll_();
+  auto stop = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::nano>(stop - start).count() / double(nEvalPerCall_);
+}
@@ -8,6 +8,7 @@
 #include "WeightMonotonicSpline.h"
 #include "WeightUniformSpline.h"
 #include "WeightGeneralSpline.h"
+#include "WeightGraph.h"
 
 #include "CacheIndexedSums.h"
 
@@ -56,6 +57,7 @@ private:
             int compactSplines, int compactPoints,
             int uniformSplines, int uniformPoints,
             int generalSplines, int generalPoints,
+            int graphs, int graphPoints,
             int histBins);
 
     static Manager* fSingleton;  // You get one guess...
@@ -91,6 +93,9 @@ private:
     /// The cache for the general splines (really compact splines for now).
     std::unique_ptr<Cache::Weight::GeneralSpline> fGeneralSplines;
 
+    /// The cache for the graphs (linear interpolation).
+    std::unique_ptr<Cache::Weight::Graph> fGraphs;
+
     /// The cache for the summed histgram weights
     std::unique_ptr<Cache::IndexedSums> fHistogramsCache;
 
@@ -10,6 +10,17 @@
 #include <vector>
 #include <array>
 
+// Do a definition here to "trick" nvcc which doesn't like the type to be
+// typedef'ed.  This is the type of the bulk data copied to the GPU (spline
+// knots, graph points, and initial event weights).  It is float with the
+// WITH_FLOAT_STORAGE build option, but the calculations (and the results)
+// stay in double.
+#ifdef GUNDAM_FLOAT_STORAGE
+#define WEIGHT_BUFFER_FLOAT float
+#else
+#define WEIGHT_BUFFER_FLOAT double
+#endif
+
 namespace Cache {
     class Weights;
     namespace Weight {
@@ -43,7 +54,7 @@ private:
 
     /// An array of the initial value for each result.  It's copied from the
     /// CPU to the GPU once at the beginning.
-    std::unique_ptr<hemi::Array<double>> fInitialValues;
+    std::unique_ptr<hemi::Array<WEIGHT_BUFFER_FLOAT>> fInitialValues;
 
     /// An array of pointers to objects that will calculate the weights
     /// (e.g. WeightNormalization and WeightUniformSpline).  The objects are
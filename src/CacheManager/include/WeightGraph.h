@@ -0,0 +1,149 @@
+#ifndef CacheGraph_hxx_seen
+#define CacheGraph_hxx_seen
+
+#include "CacheWeights.h"
+#include "WeightBase.h"
+
+#include "GraphDial.h"
+#include "hemi/array.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace Cache {
+    namespace Weight {
+        class Graph;
+    }
+}
+
+/// A class apply a graph weight parameter to the cached event weights.
+/// This will be used in Cache::Weights to run the GPU for this type of
+/// reweighting.  The weight is a linear interpolation between the points of
+/// the graph (see CalculateGraph).
+class Cache::Weight::Graph:
+    public Cache::Weight::Base {
+private:
+    Cache::Parameters::Clamps& fLowerClamp;
+    Cache::Parameters::Clamps& fUpperClamp;
+
+    ///////////////////////////////////////////////////////////////////////
+    /// An array of indices into the results that go for each graph.
+    /// This is copied from the CPU to the GPU once, and is then constant.
+    std::size_t fGraphsReserved;
+    std::size_t fGraphsUsed;
+    std::unique_ptr<hemi::Array<int>> fGraphResult;
+
+    /// An array of indices into the parameters that go for each graph.  This
+    /// is copied from the CPU to the GPU once, and is then constant.
+    std::unique_ptr<hemi::Array<short>> fGraphParameter;
+
+    /// An array of indices for the first point of each graph.  This is copied
+    /// from the CPU to the GPU once, and is then constant.
+    std::unique_ptr<hemi::Array<int>> fGraphIndex;
+
+    /// An array of the points to calculate the graphs.  This is copied from
+    /// the CPU to the GPU once, and is then constant.
+    std::size_t    fGraphPointsReserved;
+    std::size_t    fGraphPointsUsed;
+    std::unique_ptr<hemi::Array<WEIGHT_BUFFER_FLOAT>> fGraphPoints;
+
+public:
+    // A static method to return the number of points that will be used by
+    // this graph.
+    static int FindPoints(const GraphDial* g);
+
+    // Construct the class.  This should allocate all the memory on the host
+    // and on the GPU.  The "results" are the total number of results to be
+    // calculated (one result per event, often >1E+6).  The "parameters" are
+    // the number of input parameters that are used (often ~1000).  The graphs
+    // are the total number of graph dials used to calculate the results, and
+    // the points are the total number of points in all of the graphs.
+    Graph(Cache::Weights::Results& results,
+          Cache::Parameters::Values& parameters,
+          Cache::Parameters::Clamps& lowerClamps,
+          Cache::Parameters::Clamps& upperClamps,
+          std::size_t graphs,
+          std::size_t points);
+
+    // Deconstruct the class.  This should deallocate all the memory
+    // everyplace.
+    virtual ~Graph();
+
+    // Apply the kernel to the event weights.
+    virtual bool Apply();
+
+    /// Return the number of graphs that are reserved.
+    std::size_t GetGraphsReserved() {return fGraphsReserved;}
+
+    /// Return the number of graphs that are used.
+    std::size_t GetGraphsUsed() {return fGraphsUsed;}
+
+    /// Return the number of elements reserved to hold points.
+    std::size_t GetGraphPointsReserved() const {return fGraphPointsReserved;}
+
+    /// Return the number of elements currently used to hold points.
+    std::size_t GetGraphPointsUsed() const {return fGraphPointsUsed;}
+
+    /// Add a graph for the dial.  This may modify the dial if debugging is
+    /// enabled.
+    void AddGraph(int resultIndex, int parIndex, GraphDial* dial);
+
+    // Get the index of the parameter for the graph at gIndex.
+    int GetGraphParameterIndex(int gIndex);
+
+    // Get the parameter value for the graph at gIndex.
+    double GetGraphParameter(int gIndex);
+
+    // Get the number of points in the graph at gIndex.
+    int GetGraphPointCount(int gIndex);
+
+    // Get the place and the value for a point in the graph at gIndex
+    double GetGraphPointPlace(int gIndex,int point);
+    double GetGraphPointValue(int gIndex,int point);
+
+    ////////////////////////////////////////////////////////////////////
+    // This section is for the validation methods.  They should mostly be
+    // NOOPs and should mostly not be called.
+
+#ifdef CACHE_MANAGER_SLOW_VALIDATION
+    double* GetCachePointer(int gIndex);
+
+    /// An array of values for the result of each graph.  When this is
+    /// active, it is filled but the kernel, but only copied to the CPU if
+    /// it's access.  NOTE: Enabling this significantly slows the calculation
+    /// since it adds another large copy from the GPU.
+    std::unique_ptr<hemi::Array<double>> fGraphValue;
+#endif
+
+};
+
+// An MIT Style License
+
+// Copyright (c) 2022 Clark McGrew
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:4
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
+#endif
@@ -64,6 +64,7 @@ Cache::Manager::Manager(int events, int parameters,
                         int compactSplines, int compactPoints,
                         int uniformSplines, int uniformPoints,
                         int generalSplines, int generalPoints,
+                        int graphs, int graphPoints,
                         int histBins) {
     LogInfo << "Creating cache manager" << std::endl;
 
@@ -113,6 +114,15 @@ Cache::Manager::Manager(int events, int parameters,
         fWeightsCache->AddWeightCalculator(fGeneralSplines.get());
         fTotalBytes += fGeneralSplines->GetResidentMemory();
 
+        fGraphs.reset(new Cache::Weight::Graph(
+                                  fWeightsCache->GetWeights(),
+                                  fParameterCache->GetParameters(),
+                                  fParameterCache->GetLowerClamps(),
+                                  fParameterCache->GetUpperClamps(),
+                                  graphs, graphPoints));
+        fWeightsCache->AddWeightCalculator(fGraphs.get());
+        fTotalBytes += fGraphs->GetResidentMemory();
+
         fHistogramsCache.reset(new Cache::IndexedSums(
                                   fWeightsCache->GetWeights(),
                                   histBins));
@@ -204,6 +214,8 @@ bool Cache::Manager::Build(FitSampleSet& sampleList) {
                     = dynamic_cast<const GraphDial*>(dial);
                 if (gDial) {
                     ++graphs;
+                    graphPoints
+                        += Cache::Weight::Graph::FindPoints(gDial);
                 }
                 const NormDial* nDial
                     = dynamic_cast<const NormDial*>(dial);
@@ -301,6 +313,7 @@ bool Cache::Manager::Build(FitSampleSet& sampleList) {
                                  compactSplines,compactPoints,
                                  uniformSplines,uniformPoints,
                                  generalSplines,generalPoints,
+                                 graphs,graphPoints,
                                  histCells);
     }
 
@@ -403,6 +416,13 @@ bool Cache::Manager::Build(FitSampleSet& sampleList) {
                         throw std::runtime_error("Invalid spline type");
                     }
                 }
+                GraphDial* gDial = dynamic_cast<GraphDial*>(dial);
+                if (gDial) {
+                    ++dialUsed;
+                    Cache::Manager::Get()
+                        ->fGraphs
+                        ->AddGraph(resultIndex,parIndex,gDial);
+                }
                 if (!dialUsed) throw std::runtime_error("Unused dial");
             }
         }
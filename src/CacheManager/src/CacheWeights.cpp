@@ -31,7 +31,7 @@ Cache::Weights::Weights(
            << std::endl;
     fTotalBytes = 0;
     fTotalBytes += GetResultCount()*sizeof(double);   // fResults
-    fTotalBytes += GetResultCount()*sizeof(double);   // fInitialValues;
+    fTotalBytes += GetResultCount()*sizeof(WEIGHT_BUFFER_FLOAT);   // fInitialValues;
 
     LogInfo << "Cached Weights -- approximate memory size: " << fTotalBytes/1E+9
             << " GB" << std::endl;
@@ -42,7 +42,8 @@ Cache::Weights::Weights(
         // set.  The initial values are seldom changed, so they are not
         // pinned.
         fResults.reset(new hemi::Array<double>(GetResultCount(),true));
-        fInitialValues.reset(new hemi::Array<double>(GetResultCount(),false));
+        fInitialValues.reset(
+            new hemi::Array<WEIGHT_BUFFER_FLOAT>(GetResultCount(),false));
 
     }
     catch (std::bad_alloc&) {
@@ -118,7 +119,7 @@ namespace {
     // valid CUDA.  This sets all of the results to a fixed value.
     HEMI_KERNEL_FUNCTION(HEMISetKernel,
                          double* results,
-                         const double* values,
+                         const WEIGHT_BUFFER_FLOAT* values,
                          const int NP) {
         for (int i : hemi::grid_stride_range(0,NP)) {
             results[i] = values[i];
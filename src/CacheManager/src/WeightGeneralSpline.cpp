@@ -118,7 +118,7 @@ void Cache::Weight::GeneralSpline::AddSpline(int resIndex, int parIndex,
                << std::endl;
         throw std::runtime_error("Parameter index out of bounds");
     }
-    if (sDial->getSplineData().size() < 11) {
+    if (sDial->getSplineDataSize() < 11) {
         LogError << "Insufficient points in spline"
                << std::endl;
         throw std::runtime_error("Invalid number of spline points");
@@ -137,15 +137,15 @@ void Cache::Weight::GeneralSpline::AddSpline(int resIndex, int parIndex,
         throw std::runtime_error("Problem with control indices");
     }
     int knotIndex = fSplineKnotsUsed;
-    fSplineKnotsUsed += sDial->getSplineData().size();
+    fSplineKnotsUsed += sDial->getSplineDataSize();
     if (fSplineKnotsUsed > fSplineKnotsReserved) {
         LogError << "Not enough space reserved for spline knots"
                << std::endl;
         throw std::runtime_error("Not enough space reserved for spline knots");
     }
     fSplineIndex->hostPtr()[newIndex+1] = fSplineKnotsUsed;
-    for (std::size_t i = 0; i<sDial->getSplineData().size(); ++i) {
-        fSplineKnots->hostPtr()[knotIndex+i] = sDial->getSplineData().at(i);
+    for (std::size_t i = 0; i<std::size_t(sDial->getSplineDataSize()); ++i) {
+        fSplineKnots->hostPtr()[knotIndex+i] = sDial->getSplineData()[i];
     }
 
 #ifdef CACHE_MANAGER_SLOW_VALIDATION
@@ -316,6 +316,8 @@ double* Cache::Weight::GeneralSpline::GetCachePointer(int sIndex) {
 #undef CACHE_DEBUG
 #define PRINT_STEP 3
 
+// The data is stored as WEIGHT_BUFFER_FLOAT
+#define DEVICE_FLOATING_POINT WEIGHT_BUFFER_FLOAT
 #include "CalculateGeneralSpline.h"
 #include "CacheAtomicMult.h"
 
@@ -351,10 +353,6 @@ namespace {
             const double lClamp = lowerClamp[pIndex[i]];
             const double uClamp = upperClamp[pIndex[i]];
 
-#ifndef HEMI_DEV_CODE
-            if (dim>15) std::runtime_error("To many bins in spline");
-#endif
-
             double v = CalculateGeneralSpline(x, lClamp,uClamp,
                                               &knots[id0],dim);
 
@@ -0,0 +1,368 @@
+#include "CacheWeights.h"
+#include "WeightBase.h"
+#include "WeightGraph.h"
+
+#include <algorithm>
+#include <iostream>
+#include <exception>
+#include <limits>
+#include <cmath>
+
+#include <hemi/hemi_error.h>
+#include <hemi/launch.h>
+#include <hemi/grid_stride_range.h>
+
+#include "Logger.h"
+LoggerInit([]{
+  Logger::setUserHeaderStr("[Cache]");
+});
+
+// The constructor
+Cache::Weight::Graph::Graph(
+    Cache::Weights::Results& weights,
+    Cache::Parameters::Values& parameters,
+    Cache::Parameters::Clamps& lowerClamps,
+    Cache::Parameters::Clamps& upperClamps,
+    std::size_t graphs, std::size_t points)
+    : Cache::Weight::Base("graph",weights,parameters),
+      fLowerClamp(lowerClamps), fUpperClamp(upperClamps),
+      fGraphsReserved(graphs), fGraphsUsed(0),
+      fGraphPointsReserved(points), fGraphPointsUsed(0) {
+
+    LogInfo << "Reserved " << GetName() << " Graphs: "
+            << GetGraphsReserved() << std::endl;
+    if (GetGraphsReserved() < 1) return;
+
+    fTotalBytes += GetGraphsReserved()*sizeof(int);      // fGraphResult
+    fTotalBytes += GetGraphsReserved()*sizeof(short);    // fGraphParameter
+    fTotalBytes += (1+GetGraphsReserved())*sizeof(int);  // fGraphIndex
+
+    // Calculate the space needed to store the graph data.  This needs
+    // to know how the graph data is packed for CalculateGraph.
+    fGraphPointsReserved = 2*fGraphsReserved + 2*fGraphPointsReserved;
+
+#ifdef CACHE_MANAGER_SLOW_VALIDATION
+#warning Using SLOW VALIDATION in Cache::Weight::Graph::Graph
+        // Add validation code for the graph calculation.  This can be rather
+        // slow, so do not use if it is not required.
+    fTotalBytes += GetGraphsReserved()*sizeof(double);
+#endif
+
+    LogInfo << "Reserved " << GetName()
+            << " Graph Points: " << GetGraphPointsReserved()
+            << std::endl;
+    fTotalBytes += GetGraphPointsReserved()*sizeof(WEIGHT_BUFFER_FLOAT);  // fGraphPoints
+
+    LogInfo << "Approximate Memory Size for " << GetName()
+            << ": " << fTotalBytes/1E+9
+            << " GB" << std::endl;
+
+    try {
+        // Get the CPU/GPU memory for the graph index tables.  These are
+        // copied once during initialization so do not pin the CPU memory into
+        // the page set.
+        fGraphResult.reset(new hemi::Array<int>(GetGraphsReserved(),false));
+        fGraphParameter.reset(
+            new hemi::Array<short>(GetGraphsReserved(),false));
+        fGraphIndex.reset(new hemi::Array<int>(1+GetGraphsReserved(),false));
+
+#ifdef CACHE_MANAGER_SLOW_VALIDATION
+#warning Using SLOW VALIDATION in Cache::Weight::Graph::Graph
+        // Add validation code for the graph calculation.  This can be rather
+        // slow, so do not use if it is not required.
+        fGraphValue.reset(new hemi::Array<double>(GetGraphsReserved(),true));
+#endif
+
+        // Get the CPU/GPU memory for the graph points.  This is copied once
+        // during initialization so do not pin the CPU memory into the page
+        // set.
+        fGraphPoints.reset(
+            new hemi::Array<WEIGHT_BUFFER_FLOAT>(GetGraphPointsReserved(),false));
+    }
+    catch (std::bad_alloc&) {
+        LogError << "Failed to allocate memory, so stopping" << std::endl;
+        throw std::runtime_error("Not enough memory available");
+    }
+
+    // Initialize the caches.  Don't try to zero everything since the
+    // caches can be huge.
+    fGraphIndex->hostPtr()[0] = 0;
+}
+
+// The destructor
+Cache::Weight::Graph::~Graph() {}
+
+int Cache::Weight::Graph::FindPoints(const GraphDial* g) {
+    return g->getGraph().GetN();
+}
+
+void Cache::Weight::Graph::AddGraph(int resIndex, int parIndex,
+                                    GraphDial* gDial) {
+    if (resIndex < 0) {
+        LogError << "Invalid result index"
+               << std::endl;
+        throw std::runtime_error("Negative result index");
+    }
+    if (fWeights.size() <= resIndex) {
+        LogError << "Invalid result index"
+               << std::endl;
+        throw std::runtime_error("Result index out of bounds");
+    }
+    if (parIndex < 0) {
+        LogError << "Invalid parameter index"
+               << std::endl;
+        throw std::runtime_error("Negative parameter index");
+    }
+    if (fParameters.size() <= parIndex) {
+        LogError << "Invalid parameter index"
+               << std::endl;
+        throw std::runtime_error("Parameter index out of bounds");
+    }
+    const std::vector<double>& graphData = gDial->getGraphData();
+    if (graphData.size() < 4) {
+        LogError << "Insufficient points in graph"
+               << std::endl;
+        throw std::runtime_error("Invalid number of graph points");
+    }
+    int newIndex = fGraphsUsed++;
+    if (fGraphsUsed > fGraphsReserved) {
+        LogError << "Not enough space reserved for graphs"
+                  << std::endl;
+        throw std::runtime_error("Not enough space reserved for graphs");
+    }
+    fGraphResult->hostPtr()[newIndex] = resIndex;
+    fGraphParameter->hostPtr()[newIndex] = parIndex;
+    if (fGraphIndex->hostPtr()[newIndex] != fGraphPointsUsed) {
+        LogError << "Last graph point index should be at old end of graphs"
+                  << std::endl;
+        throw std::runtime_error("Problem with control indices");
+    }
+    int pointIndex = fGraphPointsUsed;
+    fGraphPointsUsed += graphData.size();
+    if (fGraphPointsUsed > fGraphPointsReserved) {
+        LogError << "Not enough space reserved for graph points"
+               << std::endl;
+        throw std::runtime_error("Not enough space reserved for graph points");
+    }
+    fGraphIndex->hostPtr()[newIndex+1] = fGraphPointsUsed;
+    for (std::size_t i = 0; i<graphData.size(); ++i) {
+        fGraphPoints->hostPtr()[pointIndex+i] = graphData[i];
+    }
+
+#ifdef CACHE_MANAGER_SLOW_VALIDATION
+#warning Using SLOW VALIDATION in Cache::Weight::Graph::AddGraph
+    gDial->setCacheManagerName(GetName());
+    gDial->setCacheManagerValuePointer(GetCachePointer(newIndex));
+#endif
+}
+
+int Cache::Weight::Graph::GetGraphParameterIndex(int gIndex) {
+    if (gIndex < 0) {
+        throw std::runtime_error("Graph index invalid");
+    }
+    if (GetGraphsUsed() <= gIndex) {
+        throw std::runtime_error("Graph index invalid");
+    }
+    return fGraphParameter->hostPtr()[gIndex];
+}
+
+double Cache::Weight::Graph::GetGraphParameter(int gIndex) {
+    int i = GetGraphParameterIndex(gIndex);
+    if (i<0) {
+        throw std::runtime_error("Graph parameter index out of bounds");
+    }
+    if (fParameters.size() <= i) {
+        throw std::runtime_error("Graph parameter index out of bounds");
+    }
+    return fParameters.hostPtr()[i];
+}
+
+int Cache::Weight::Graph::GetGraphPointCount(int gIndex) {
+    if (gIndex < 0) {
+        throw std::runtime_error("Graph index invalid");
+    }
+    if (GetGraphsUsed() <= gIndex) {
+        throw std::runtime_error("Graph index invalid");
+    }
+    int k = fGraphIndex->hostPtr()[gIndex+1]-fGraphIndex->hostPtr()[gIndex]-2;
+    return k/2;
+}
+
+double Cache::Weight::Graph::GetGraphPointValue(int gIndex, int point) {
+    int count = GetGraphPointCount(gIndex);
+    if (point < 0) {
+        throw std::runtime_error("Point index invalid");
+    }
+    if (count <= point) {
+        throw std::runtime_error("Point index invalid");
+    }
+    int pointsIndex = fGraphIndex->hostPtr()[gIndex];
+    return fGraphPoints->hostPtr()[pointsIndex+2+2*point];
+}
+
+double Cache::Weight::Graph::GetGraphPointPlace(int gIndex, int point) {
+    int count = GetGraphPointCount(gIndex);
+    if (point < 0) {
+        throw std::runtime_error("Point index invalid");
+    }
+    if (count <= point) {
+        throw std::runtime_error("Point index invalid");
+    }
+    int pointsIndex = fGraphIndex->hostPtr()[gIndex];
+    return fGraphPoints->hostPtr()[pointsIndex+2+2*point+1];
+}
+
+////////////////////////////////////////////////////////////////////
+// This section is for the validation methods.  They should mostly be
+// NOOPs and should mostly not be called.
+
+#ifdef CACHE_MANAGER_SLOW_VALIDATION
+#warning Using SLOW VALIDATION in Cache::Weight::Graph::GetGraphValue
+// Get the intermediate graph result that is used to calculate an event
+// weight.  This can trigger a copy from the GPU to CPU, and must only be
+// enabled during validation.  Using this validation code also significantly
+// increases the amount of GPU memory required.  In a short sentence, "Do not
+// use this method."
+double* Cache::Weight::Graph::GetCachePointer(int gIndex) {
+    if (gIndex < 0) {
+        throw std::runtime_error("GetGraphValue: Graph index invalid");
+    }
+    if (GetGraphsUsed() <= gIndex) {
+        throw std::runtime_error("GetGraphValue: Graph index invalid");
+    }
+    // This can trigger a *slow* copy of the graph values from the GPU to the
+    // CPU.
+    return fGraphValue->hostPtr() + gIndex;
+}
+#endif
+
+// Define CACHE_DEBUG to get lots of output from the host
+#undef CACHE_DEBUG
+#define PRINT_STEP 3
+
+// The data is stored as WEIGHT_BUFFER_FLOAT
+#define DEVICE_FLOATING_POINT WEIGHT_BUFFER_FLOAT
+#include "CalculateGraph.h"
+#include "CacheAtomicMult.h"
+
+namespace {
+
+    // A function to be used as the kernel on either the CPU or GPU.  This
+    // must be valid CUDA coda.
+    HEMI_KERNEL_FUNCTION(HEMIGraphsKernel,
+                         double* results,
+#ifdef CACHE_MANAGER_SLOW_VALIDATION
+#warning Using SLOW VALIDATION in Cache::Weight::Graph::HEMIGraphsKernel
+                         // inputs/output for validation
+                         double* graphValues,
+#endif
+                         const double* params,
+                         const double* lowerClamp,
+                         const double* upperClamp,
+                         const WEIGHT_BUFFER_FLOAT* points,
+                         const int* rIndex,
+                         const short* pIndex,
+                         const int* gIndex,
+                         const int NP) {
+#ifdef CACHE_DEBUG
+#ifndef HEMI_DEV_CODE
+        int printStep = 0;
+#endif
+#endif
+        for (int i : hemi::grid_stride_range(0,NP)) {
+            const int id0 = gIndex[i];
+            const int id1 = gIndex[i+1];
+            const int dim = id1-id0;
+            const double x = params[pIndex[i]];
+            const double lClamp = lowerClamp[pIndex[i]];
+            const double uClamp = upperClamp[pIndex[i]];
+
+            double v = CalculateGraph(x, lClamp, uClamp, &points[id0], dim);
+
+#ifdef CACHE_DEBUG
+#ifndef HEMI_DEV_CODE
+            if (printStep++ < PRINT_STEP) {
+                LogInfo << "CACHE_DEBUG: graph " << i
+                        << " iEvt " << rIndex[i]
+                        << " iPar " << pIndex[i]
+                        << " = " << params[pIndex[i]]
+                        << " m " << points[id0] << " d "  << points[id0+1]
+                        << " --> " << v
+                        << " l: " << lClamp
+                        << " u: " << uClamp
+                        << " d: " << dim
+                       << std::endl;
+                for (int k = 0; k < (dim-2)/2; ++k) {
+                    LogInfo << "CACHE_DEBUG:     " << k
+                           << " x: " << points[id0+2+2*k+1]
+                           << " y: " << points[id0+2+2*k]
+                           << std::endl;
+                }
+            }
+#endif
+#endif
+
+#ifdef CACHE_MANAGER_SLOW_VALIDATION
+#warning Using SLOW VALIDATION in Cache::Weight::Graph::HEMIGraphsKernel
+            graphValues[i] = v;
+#endif
+            CacheAtomicMult(&results[rIndex[i]], v);
+        }
+    }
+}
+
+bool Cache::Weight::Graph::Apply() {
+    if (GetGraphsUsed() < 1) return false;
+
+    HEMIGraphsKernel graphsKernel;
+    hemi::launch(graphsKernel,
+                 fWeights.writeOnlyPtr(),
+#ifdef CACHE_MANAGER_SLOW_VALIDATION
+#warning Using SLOW VALIDATION in Cache::Weight::Graph::Apply
+                 fGraphValue->writeOnlyPtr(),
+#endif
+                 fParameters.readOnlyPtr(),
+                 fLowerClamp.readOnlyPtr(),
+                 fUpperClamp.readOnlyPtr(),
+                 fGraphPoints->readOnlyPtr(),
+                 fGraphResult->readOnlyPtr(),
+                 fGraphParameter->readOnlyPtr(),
+                 fGraphIndex->readOnlyPtr(),
+                 GetGraphsUsed()
+        );
+
+#ifdef CACHE_MANAGER_SLOW_VALIDATION
+#warning Using SLOW VALIDATION and copying graph values
+    fGraphValue->hostPtr();
+#endif
+
+    return true;
+}
+
+// An MIT Style License
+
+// Copyright (c) 2022 Clark McGrew
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:4
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
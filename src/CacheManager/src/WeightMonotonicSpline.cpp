@@ -118,7 +118,7 @@ void Cache::Weight::MonotonicSpline::AddSpline(int resIndex,
                << std::endl;
         throw std::runtime_error("Parameter index out of bounds");
     }
-    if (sDial->getSplineData().size() < 5) {
+    if (sDial->getSplineDataSize() < 5) {
         LogError << "Insufficient points in spline"
                << std::endl;
         throw std::runtime_error("Invalid number of spline points");
@@ -137,15 +137,15 @@ void Cache::Weight::MonotonicSpline::AddSpline(int resIndex,
         throw std::runtime_error("Problem with control indices");
     }
     int knotIndex = fSplineKnotsUsed;
-    fSplineKnotsUsed += sDial->getSplineData().size();
+    fSplineKnotsUsed += sDial->getSplineDataSize();
     if (fSplineKnotsUsed > fSplineKnotsReserved) {
         LogError << "Not enough space reserved for spline knots"
                << std::endl;
         throw std::runtime_error("Not enough space reserved for spline knots");
     }
     fSplineIndex->hostPtr()[newIndex+1] = fSplineKnotsUsed;
-    for (std::size_t i = 0; i<sDial->getSplineData().size(); ++i) {
-        fSplineKnots->hostPtr()[knotIndex+i] = sDial->getSplineData().at(i);
+    for (std::size_t i = 0; i<std::size_t(sDial->getSplineDataSize()); ++i) {
+        fSplineKnots->hostPtr()[knotIndex+i] = sDial->getSplineData()[i];
     }
 
 #ifdef CACHE_MANAGER_SLOW_VALIDATION
@@ -302,6 +302,8 @@ double* Cache::Weight::MonotonicSpline::GetCachePointer(int sIndex) {
 #endif
 
 #include "CacheAtomicMult.h"
+// The data is stored as WEIGHT_BUFFER_FLOAT
+#define DEVICE_FLOATING_POINT WEIGHT_BUFFER_FLOAT
 #include "CalculateMonotonicSpline.h"
 
 // Define CACHE_DEBUG to get lots of output from the host
@@ -118,7 +118,7 @@ void Cache::Weight::UniformSpline::AddSpline(int resIndex, int parIndex,
                << std::endl;
         throw std::runtime_error("Parameter index out of bounds");
     }
-    int points = sDial->getSplineData().size();
+    int points = sDial->getSplineDataSize();
     if (points < 8) {
         LogError << "Insufficient points in spline"
                << std::endl;
@@ -145,8 +145,8 @@ void Cache::Weight::UniformSpline::AddSpline(int resIndex, int parIndex,
         throw std::runtime_error("Not enough space reserved for spline knots");
     }
     fSplineIndex->hostPtr()[newIndex+1] = fSplineKnotsUsed;
-    for (std::size_t i = 0; i<sDial->getSplineData().size(); ++i) {
-        fSplineKnots->hostPtr()[knotIndex+i] = sDial->getSplineData().at(i);
+    for (std::size_t i = 0; i<std::size_t(sDial->getSplineDataSize()); ++i) {
+        fSplineKnots->hostPtr()[knotIndex+i] = sDial->getSplineData()[i];
     }
 
 #ifdef CACHE_MANAGER_SLOW_VALIDATION
@@ -297,6 +297,8 @@ double* Cache::Weight::UniformSpline::GetCachePointer(int sIndex) {
 
 
 #include "CacheAtomicMult.h"
+// The data is stored as WEIGHT_BUFFER_FLOAT
+#define DEVICE_FLOATING_POINT WEIGHT_BUFFER_FLOAT
 #include "CalculateUniformSpline.h"
 
 // Define CACHE_DEBUG to get lots of output from the host
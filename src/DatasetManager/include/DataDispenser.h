@@ -28,27 +28,40 @@ struct DataDispenserParameters{
   std::map<std::string, std::string> overrideLeafDict{};
   std::vector<std::string> additionalLeavesStorage{};
   int iThrow{-1};
+  bool pruneIdentityDials{true}; // dials with a response of exactly 1 over their full knot range are not attached
 };
 struct DataDispenserCache{
   std::vector<FitSample*> samplesToFillList{};
   std::vector<size_t> sampleNbOfEvents;
+  size_t nbOfSelectedEntries{0}; // entries that belong to at least one sample
   std::vector<std::vector<bool>> eventIsInSamplesList{};
   std::vector<std::string> leavesRequestedForIndexing{};
   std::vector<std::string> leavesRequestedForStorage{};
   std::vector<GenericToolbox::CopiableAtomic<size_t>> sampleIndexOffsetList;
   std::vector< std::vector<PhysicsEvent>* > sampleEventListPtrToFill;
   std::map<FitParameterSet*, std::vector<DialSet*>> dialSetPtrMap;
+  // event-by-event dials: the selected entry claiming the slot k uses dialList[ offset[dialSet] + k ]
+  std::map<DialSet*, size_t> eventByEventDialOffsetMap;
+  GenericToolbox::CopiableAtomic<size_t> eventByEventDialSlotOffset;
+  // binned dials: is the dial i of the set an identity? (only filled if pruneIdentityDials)
+  std::map<const DialSet*, std::vector<char>> binnedDialIsIdentityMap;
+  std::map<const DialSet*, size_t> nbPrunedDialsMap;
   std::vector<std::string> leavesToOverrideList; // stores the leaves names to override in the right order
 
   void clear(){
     samplesToFillList.clear();
     sampleNbOfEvents.clear();
+    nbOfSelectedEntries = 0;
     eventIsInSamplesList.clear();
     leavesRequestedForIndexing.clear();
     leavesRequestedForStorage.clear();
     sampleIndexOffsetList.clear();
     sampleEventListPtrToFill.clear();
     dialSetPtrMap.clear();
+    eventByEventDialOffsetMap.clear();
+    eventByEventDialSlotOffset = 0;
+    binnedDialIsIdentityMap.clear();
+    nbPrunedDialsMap.clear();
     leavesToOverrideList.clear();
   }
 };
@@ -85,6 +98,7 @@ protected:
   void fetchRequestedLeaves();
   void preAllocateMemory();
   void readAndFill();
+  void deduplicateEventByEventDials();
 
 private:
   // Args
@@ -19,6 +19,11 @@
 #include "TChainElement.h"
 
 #include "sstream"
+#include "limits"
+#include "unordered_map"
+#include "algorithm"
+#include "cstring"
+#include "cmath"
 
 LoggerInit([]{
   Logger::setUserHeaderStr("[DataDispenser]");
@@ -43,6 +48,7 @@ void DataDispenser::readConfig(){
   _parameters_.filePathList = JsonUtils::fetchValue<std::vector<std::string>>(_config_, "filePathList", _parameters_.filePathList);
   _parameters_.additionalLeavesStorage = JsonUtils::fetchValue(_config_, "additionalLeavesStorage", _parameters_.additionalLeavesStorage);
   _parameters_.useMcContainer = JsonUtils::fetchValue(_config_, "useMcContainer", _parameters_.useMcContainer);
+  _parameters_.pruneIdentityDials = JsonUtils::fetchValue(_config_, "pruneIdentityDials", _parameters_.pruneIdentityDials);
 
   _parameters_.selectionCutFormulaStr = JsonUtils::buildFormula(_config_, "selectionCutFormula", "&&", _parameters_.selectionCutFormulaStr);
   _parameters_.nominalWeightFormulaStr = JsonUtils::buildFormula(_config_, "nominalWeightFormula", "*", _parameters_.nominalWeightFormulaStr);
@@ -131,6 +137,7 @@ void DataDispenser::load(){
   this->fetchRequestedLeaves();
   this->preAllocateMemory();
   this->readAndFill();
+  this->deduplicateEventByEventDials();
 
   LogWarning << "Loaded " << getTitle() << std::endl;
 }
@@ -253,10 +260,13 @@ void DataDispenser::doEventSelection(){
 
   LogInfo << "Counting requested event slots for each samples..." << std::endl;
   _cache_.sampleNbOfEvents.resize(_cache_.samplesToFillList.size(), 0);
+  _cache_.nbOfSelectedEntries = 0;
   for(auto & eventIsInSample : _cache_.eventIsInSamplesList){
+    bool isSelected{false};
     for(size_t iSample = 0 ; iSample < _cache_.samplesToFillList.size() ; iSample++ ){
-      if(eventIsInSample[iSample]) _cache_.sampleNbOfEvents[iSample]++;
+      if(eventIsInSample[iSample]){ _cache_.sampleNbOfEvents[iSample]++; isSelected = true; }
     }
+    if( isSelected ) _cache_.nbOfSelectedEntries++;
   }
 
   if( _owner_->isShowSelectedEventCount() ){
@@ -407,21 +417,32 @@ void DataDispenser::preAllocateMemory(){
             }
           }
 
-          // Reserve memory for additional dials (those on a tree leaf)
+          // Reserve memory for additional dials (those on a tree leaf): one slot per selected entry, appended after the
+          // dials already there (other datasets sharing this dial set). Unused slots are released after the loading.
           if( not dialSetPtr->getDialLeafName().empty() ){
 
             auto dialType = dialSetPtr->getGlobalDialType();
+            size_t dialOffset{dialSetPtr->getDialList().size()};
             if     ( dialType == DialType::Spline ){
-              dialSetPtr->getDialList().resize(treeChain.GetEntries(), DialWrapper(SplineDial()));
+              dialSetPtr->getDialList().resize(dialOffset + _cache_.nbOfSelectedEntries, DialWrapper(SplineDial()));
             }
             else if( dialType == DialType::Graph ){
-              dialSetPtr->getDialList().resize(treeChain.GetEntries(), DialWrapper(GraphDial()));
+              dialSetPtr->getDialList().resize(dialOffset + _cache_.nbOfSelectedEntries, DialWrapper(GraphDial()));
             }
             else{
               LogThrow("Invalid dial type for event-by-event dial: " << DialType::DialTypeEnumNamespace::toString(dialType))
             }
+            _cache_.eventByEventDialOffsetMap[dialSetPtr] = dialOffset;
 
           }
+          else if( _parameters_.pruneIdentityDials ){
+            // Binned dials are shared by the events: check them once
+            auto& isIdentityList = _cache_.binnedDialIsIdentityMap[dialSetPtr];
+            isIdentityList.resize(dialSetPtr->getDialList().size(), false);
+            for( size_t iDial = 0 ; iDial < dialSetPtr->getDialList().size() ; iDial++ ){
+              isIdentityList[iDial] = dialSetPtr->getDialList()[iDial]->isIdentity();
+            }
+          }
 
           // Add the dialSet to the list
           _cache_.dialSetPtrMap[&parSet].emplace_back( dialSetPtr );
@@ -500,8 +521,18 @@ void DataDispenser::readAndFill(){
 
     size_t sampleEventIndex;
     int threadDialIndex;
+    const DataBinSet* binningPtr;
     const std::vector<DataBin>* binsListPtr;
 
+    // event buffer index of the binning variables of each sample
+    std::vector<std::vector<int>> sampleBinVarIndexList(_cache_.samplesToFillList.size());
+    std::vector<double> binValueList;
+    for( size_t iSampleToFill = 0 ; iSampleToFill < _cache_.samplesToFillList.size() ; iSampleToFill++ ){
+      auto& binning = _cache_.samplesToFillList[iSampleToFill]->getBinning();
+      for( auto& varName : binning.getBinVariables() ){ sampleBinVarIndexList[iSampleToFill].emplace_back(eventBuffer.findVarIndex(varName)); }
+      binValueList.resize(std::max(binValueList.size(), binning.getBinVariables().size()), 0);
+    }
+
     // Loop vars
     bool isEventInDialBin{true};
     int iBin{0};
@@ -513,10 +544,20 @@ void DataDispenser::readAndFill(){
     size_t eventDialOffset;
     DialSet* dialSetPtr;
     size_t iDialSet, iDial;
+    size_t entryDialSlot;
     TGraph* grPtr{nullptr};
     SplineDial* spDialPtr;
     GraphDial* grDialPtr;
     const DataBin* applyConditionBinPtr;
+    const std::vector<char>* isIdentityListPtr;
+    std::map<const DialSet*, size_t> nbPrunedDialsMap;
+
+    // Event-by-event dials are checked right after their initialization. An identity dial is left unreferenced.
+    auto addEventByEventDial = [&](Dial* dial_){
+      if( _parameters_.pruneIdentityDials and dial_->isIdentity() ){ nbPrunedDialsMap[dialSetPtr]++; return; }
+      dial_->setIsReferenced(true);
+      eventPtr->getRawDialPtrList()[eventDialOffset++] = dial_;
+    };
 
     // Try to read TTree the closest to sequentially possible
     Long64_t nEvents = treeChain.GetEntries();
@@ -557,6 +598,9 @@ void DataDispenser::readAndFill(){
       }
       if( skipEvent ) continue;
 
+      // claimed by the first event-by-event dial of this entry, shared by the samples
+      entryDialSlot = std::numeric_limits<size_t>::max();
+
       nBytes = treeChain.GetEntry(iEntry);
       if( iThread_ == 0 ) readSpeed.addQuantity(nBytes);
 
@@ -591,22 +635,30 @@ void DataDispenser::readAndFill(){
           eventBuffer.copyData(copyDict, true);
 
           // Has valid bin?
-          binsListPtr = &_cache_.samplesToFillList[iSample]->getBinning().getBinsList();
-
-          for( iBin = 0 ; iBin < binsListPtr->size() ; iBin++ ){
-            auto& bin = (*binsListPtr)[iBin];
-            bool isInBin = true;
-            for( iVar = 0 ; iVar < bin.getVariableNameList().size() ; iVar++ ){
-              if( not bin.isBetweenEdges(iVar, eventBuffer.getVarAsDouble(bin.getVariableNameList()[iVar])) ){
-                isInBin = false;
+          binningPtr = &_cache_.samplesToFillList[iSample]->getBinning();
+          binsListPtr = &binningPtr->getBinsList();
+
+          if( binningPtr->isSearchIndexBuilt() ){
+            auto& varIndexList = sampleBinVarIndexList[iSample];
+            for( iVar = 0 ; iVar < varIndexList.size() ; iVar++ ){ binValueList[iVar] = eventBuffer.getVarAsDouble(varIndexList[iVar]); }
+            eventBuffer.setSampleBinIndex(binningPtr->findBin(binValueList.data()));
+          }
+          else{
+            for( iBin = 0 ; iBin < binsListPtr->size() ; iBin++ ){
+              auto& bin = (*binsListPtr)[iBin];
+              bool isInBin = true;
+              for( iVar = 0 ; iVar < bin.getVariableNameList().size() ; iVar++ ){
+                if( not bin.isBetweenEdges(iVar, eventBuffer.getVarAsDouble(bin.getVariableNameList()[iVar])) ){
+                  isInBin = false;
+                  break;
+                }
+              } // Var
+              if( isInBin ){
+                eventBuffer.setSampleBinIndex(int(iBin));
                 break;
               }
-            } // Var
-            if( isInBin ){
-              eventBuffer.setSampleBinIndex(int(iBin));
-              break;
-            }
-          } // Bin
+            } // Bin
+          }
 
           if( eventBuffer.getSampleBinIndex() == -1 ) {
             // Invalid bin -> next sample
@@ -643,26 +695,26 @@ void DataDispenser::readAndFill(){
 
               if( not dialSetPtr->getDialLeafName().empty() ){
                 // Event-by-event dial?
+                if( entryDialSlot == std::numeric_limits<size_t>::max() ){
+                  entryDialSlot = _cache_.eventByEventDialSlotOffset++;
+                }
+                iDial = _cache_.eventByEventDialOffsetMap.at(dialSetPtr) + entryDialSlot;
                 if     ( not strcmp(treeChain.GetLeaf(dialSetPtr->getDialLeafName().c_str())->GetTypeName(), "TClonesArray") ){
                   grPtr = (TGraph*) eventBuffer.getVariable<TClonesArray*>(dialSetPtr->getDialLeafName())->At(0);
                   if(grPtr->GetN() > 1){
                     if     ( dialSetPtr->getGlobalDialType() == DialType::Spline ){
-                      spDialPtr = (SplineDial*) dialSetPtr->getDialList()[iEntry].get();
+                      spDialPtr = (SplineDial*) dialSetPtr->getDialList()[iDial].get();
                       dialSetPtr->applyGlobalParameters(spDialPtr);
                       spDialPtr->createSpline( grPtr );
                       spDialPtr->initialize();
-                      spDialPtr->setIsReferenced(true);
-                      // Adding dial in the event
-                      eventPtr->getRawDialPtrList()[eventDialOffset++] = spDialPtr;
+                      addEventByEventDial(spDialPtr);
                     }
                     else if( dialSetPtr->getGlobalDialType() == DialType::Graph ){
-                      grDialPtr = (GraphDial*) dialSetPtr->getDialList()[iEntry].get();
+                      grDialPtr = (GraphDial*) dialSetPtr->getDialList()[iDial].get();
                       dialSetPtr->applyGlobalParameters(grDialPtr);
                       grDialPtr->setGraph(*grPtr);
                       grDialPtr->initialize();
-                      grDialPtr->setIsReferenced(true);
-                      // Adding dial in the event
-                      eventPtr->getRawDialPtrList()[eventDialOffset++] = grDialPtr;
+                      addEventByEventDial(grDialPtr);
                     }
                     else{
                       LogThrow("Unsupported event-by-event dial: " << DialType::DialTypeEnumNamespace::toString(dialSetPtr->getGlobalDialType()))
@@ -672,22 +724,18 @@ void DataDispenser::readAndFill(){
                 else if( not strcmp(treeChain.GetLeaf(dialSetPtr->getDialLeafName().c_str())->GetTypeName(), "TGraph") ){
                   grPtr = (TGraph*) eventBuffer.getVariable<TGraph*>(dialSetPtr->getDialLeafName());
                   if     ( dialSetPtr->getGlobalDialType() == DialType::Spline ){
-                    spDialPtr = (SplineDial*) dialSetPtr->getDialList()[iEntry].get();
+                    spDialPtr = (SplineDial*) dialSetPtr->getDialList()[iDial].get();
                     dialSetPtr->applyGlobalParameters(spDialPtr);
                     spDialPtr->createSpline(grPtr);
                     spDialPtr->initialize();
-                    spDialPtr->setIsReferenced(true);
-                    // Adding dial in the event
-                    eventPtr->getRawDialPtrList()[eventDialOffset++] = spDialPtr;
+                    addEventByEventDial(spDialPtr);
                   }
                   else if( dialSetPtr->getGlobalDialType() == DialType::Graph ){
-                    grDialPtr = (GraphDial*) dialSetPtr->getDialList()[iEntry].get();
+                    grDialPtr = (GraphDial*) dialSetPtr->getDialList()[iDial].get();
                     dialSetPtr->applyGlobalParameters(grDialPtr);
                     grDialPtr->setGraph(*grPtr);
                     grDialPtr->initialize();
-                    grDialPtr->setIsReferenced(true);
-                    // Adding dial in the event
-                    eventPtr->getRawDialPtrList()[eventDialOffset++] = grDialPtr;
+                    addEventByEventDial(grDialPtr);
                   }
                   else{
                     LogThrow("Unsupported event-by-event dial: " << DialType::DialTypeEnumNamespace::toString(dialSetPtr->getGlobalDialType()))
@@ -732,6 +780,13 @@ void DataDispenser::readAndFill(){
 
                   // <------------------
                   if( isEventInDialBin ) {
+                    // An identity dial is not attached, but the event is still considered in its bin
+                    isIdentityListPtr = nullptr;
+                    if( _parameters_.pruneIdentityDials ){ isIdentityListPtr = &_cache_.binnedDialIsIdentityMap.at(dialSetPtr); }
+                    if( isIdentityListPtr != nullptr and (*isIdentityListPtr)[iDial] ){
+                      nbPrunedDialsMap[dialSetPtr]++;
+                      break;
+                    }
                     dialSetPtr->getDialList()[iDial]->setIsReferenced(true);
                     eventPtr->getRawDialPtrList()[eventDialOffset++] = dialSetPtr->getDialList()[iDial].get();
                     break;
@@ -755,6 +810,11 @@ void DataDispenser::readAndFill(){
       } // samples
     } // entries
     if( iThread_ == 0 ) GenericToolbox::displayProgressBar(nEvents, nEvents, progressTitle);
+
+    if( not nbPrunedDialsMap.empty() ){
+      std::lock_guard<std::mutex> g(GlobalVariables::getThreadMutex());
+      for( auto& nbPrunedPair : nbPrunedDialsMap ){ _cache_.nbPrunedDialsMap[nbPrunedPair.first] += nbPrunedPair.second; }
+    }
   };
 
   LogWarning << "Loading and indexing..." << std::endl;
@@ -768,7 +828,138 @@ void DataDispenser::readAndFill(){
     if(_parameters_.useMcContainer) container = &_cache_.samplesToFillList[iSample]->getMcContainer();
     container->shrinkEventList(_cache_.sampleIndexOffsetList[iSample]);
   }
+
+  for( auto& nbPrunedPair : _cache_.nbPrunedDialsMap ){
+    LogInfo << "Identity dials pruned: \"" << nbPrunedPair.first->getOwner()->getFullTitle() << "\": "
+    << nbPrunedPair.second << " event dial references dropped" << std::endl;
+  }
+
+  if( not _cache_.eventByEventDialOffsetMap.empty() ){
+    LogInfo << "Releasing unused event-by-event dial slots..." << std::endl;
+    for( auto& dialSetPair : _cache_.dialSetPtrMap ){
+      for( auto* dialSetPtr : dialSetPair.second ){
+        auto offsetIt = _cache_.eventByEventDialOffsetMap.find(dialSetPtr);
+        if( offsetIt == _cache_.eventByEventDialOffsetMap.end() ) continue;
+        size_t nUsedSlots{_cache_.eventByEventDialSlotOffset};
+        auto& dialList = dialSetPtr->getDialList();
+        dialList.resize(offsetIt->second + nUsedSlots);
+        // pruned (or empty) dials are not referenced by any event
+        dialList.erase(std::remove_if(
+            dialList.begin() + long(offsetIt->second), dialList.end(),
+            [](const DialWrapper& dial_){ return not dial_->isReferenced(); }
+        ), dialList.end());
+        dialList.shrink_to_fit();
+      }
+    }
+  }
 }
 
 
 
+void DataDispenser::deduplicateEventByEventDials(){
+  if( _cache_.eventByEventDialOffsetMap.empty() ) return;
+
+  // knots of the response graph: (x0, y0, x1, y1, ...)
+  auto fetchKnots = [](const Dial* dial_, std::vector<double>& knots_){
+    knots_.clear();
+    if( dial_->getDialType() == DialType::Spline ){
+      const TSpline3* splinePtr = static_cast<const SplineDial*>(dial_)->getSplinePtr();
+      double x, y;
+      for( int iKnot = 0 ; iKnot < splinePtr->GetNp() ; iKnot++ ){
+        splinePtr->GetKnot(iKnot, x, y);
+        knots_.emplace_back(x); knots_.emplace_back(y);
+      }
+    }
+    else if( dial_->getDialType() == DialType::Graph ){
+      const TGraph& graph = static_cast<const GraphDial*>(dial_)->getGraph();
+      for( int iPt = 0 ; iPt < graph.GetN() ; iPt++ ){
+        knots_.emplace_back(graph.GetX()[iPt]); knots_.emplace_back(graph.GetY()[iPt]);
+      }
+    }
+  };
+  // values are hashed exactly, or on a grid of the tolerance step: matching knots that sit on both sides of a grid
+  // edge won't be merged
+  auto hashKnots = [](const std::vector<double>& knots_, double tolerance_){
+    size_t out{knots_.size()};
+    for( double knot : knots_ ){
+      uint64_t bits;
+      if( tolerance_ > 0 ){ bits = uint64_t(std::llround(knot / tolerance_)); }
+      else{
+        if( knot == 0 ) knot = 0; // -0 == +0
+        std::memcpy(&bits, &knot, sizeof(double));
+      }
+      out ^= std::hash<uint64_t>()(bits) + 0x9e3779b97f4a7c15ULL + (out << 6) + (out >> 2);
+    }
+    return out;
+  };
+  auto isMatching = [](const std::vector<double>& a_, const std::vector<double>& b_, double tolerance_){
+    if( a_.size() != b_.size() ) return false;
+    for( size_t i = 0 ; i < a_.size() ; i++ ){ if( std::abs(a_[i] - b_[i]) > tolerance_ ) return false; }
+    return true;
+  };
+
+  std::unordered_map<const Dial*, Dial*> duplicateDict; // duplicate -> shared dial
+  std::vector<double> knots;
+  for( auto& dialSetPair : _cache_.dialSetPtrMap ){
+    for( auto* dialSetPtr : dialSetPair.second ){
+      auto offsetIt = _cache_.eventByEventDialOffsetMap.find(dialSetPtr);
+      if( offsetIt == _cache_.eventByEventDialOffsetMap.end() or not dialSetPtr->isDeduplicateDials() ) continue;
+
+      double tolerance{dialSetPtr->getDialDeduplicationTolerance()};
+      std::unordered_map<size_t, std::vector<size_t>> uniqueDialDict; // hash -> indices in uniqueKnotsList
+      std::vector<std::vector<double>> uniqueKnotsList;
+      std::vector<Dial*> uniqueDialList;
+
+      auto& dialList = dialSetPtr->getDialList();
+      size_t nDials{0};
+      for( size_t iDial = offsetIt->second ; iDial < dialList.size() ; iDial++ ){
+        Dial* dialPtr = dialList[iDial].get();
+        if( not dialPtr->isReferenced() ) continue;
+        nDials++;
+
+        fetchKnots(dialPtr, knots);
+        auto& candidateList = uniqueDialDict[hashKnots(knots, tolerance)];
+        bool isDuplicate{false};
+        for( auto& iUnique : candidateList ){
+          if( not isMatching(knots, uniqueKnotsList[iUnique], tolerance) ) continue;
+          duplicateDict[dialPtr] = uniqueDialList[iUnique];
+          isDuplicate = true;
+          break;
+        }
+        if( isDuplicate ) continue;
+        candidateList.emplace_back(uniqueDialList.size());
+        uniqueKnotsList.emplace_back(knots);
+        uniqueDialList.emplace_back(dialPtr);
+      }
+
+      if( nDials == 0 ) continue;
+      LogInfo << "Dial deduplication: \"" << dialSetPtr->getOwner()->getFullTitle() << "\": "
+      << nDials << " -> " << uniqueDialList.size() << " dials (compression ratio: "
+      << double(nDials) / double(uniqueDialList.size()) << ")" << std::endl;
+    }
+  }
+  if( duplicateDict.empty() ) return;
+
+  // Point the events to the shared dials
+  for( auto* samplePtr : _cache_.samplesToFillList ){
+    auto* container = &samplePtr->getDataContainer();
+    if(_parameters_.useMcContainer) container = &samplePtr->getMcContainer();
+    for( auto& event : container->eventList ){
+      for( auto& dialPtr : event.getRawDialPtrList() ){
+        if( dialPtr == nullptr ) break; // trimmed list
+        auto it = duplicateDict.find(dialPtr);
+        if( it != duplicateDict.end() ) dialPtr = it->second;
+      }
+    }
+  }
+
+  // Release the duplicates: the dials are owned by unique pointers, moving the wrappers doesn't move them
+  for( auto& offsetPair : _cache_.eventByEventDialOffsetMap ){
+    auto& dialList = offsetPair.first->getDialList();
+    dialList.erase(std::remove_if(
+        dialList.begin() + long(offsetPair.second), dialList.end(),
+        [&](const DialWrapper& dial_){ return duplicateDict.find(dial_.get()) != duplicateDict.end(); }
+    ), dialList.end());
+    dialList.shrink_to_fit();
+  }
+}
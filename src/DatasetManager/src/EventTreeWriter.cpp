@@ -30,7 +30,8 @@ void EventTreeWriter::writeSamples(TDirectory* saveDir_) const{
 
     for( bool isData : {false, true} ) {
 
-      const auto *evListPtr = (isData ? &sample.getDataContainer().eventList : &sample.getMcContainer().eventList);
+      if( not isData ){ sample.getMcContainer().updateColdEventWeights(); }
+      const auto *evListPtr = (isData ? &sample.getDataContainer().eventList : &sample.getMcContainer().getOriginalEventList());
       if (evListPtr->empty()) continue;
 
       auto* saveDir = GenericToolbox::mkdirTFile(saveDir_, sample.getName());
@@ -70,13 +71,16 @@ void EventTreeWriter::writeEvents(TDirectory *saveDir_, const std::string& treeN
 
   GenericToolbox::RawDataArray loadedLeavesArr;
   auto loadedLeavesDict = eventList_[0].generateLeavesDictionary(true);
-  std::vector<std::string> leafNamesList;
+  std::vector<int> leafIndexList;
+  std::vector<std::vector<GenericToolbox::AnyType>> leafHolderBufferList(loadedLeavesDict.size()); // if held by LeafColumns
   leavesDefStr = "";
   for( auto& leafDef : loadedLeavesDict ){
     if( not leavesDefStr.empty() ) leavesDefStr += ":";
     leavesDefStr += leafDef.first;
-    leafNamesList.emplace_back(leafDef.first.substr(0,leafDef.first.find("[")).substr(0, leafDef.first.find("/")));
-    leafDef.second(loadedLeavesArr, eventList_[0].getLeafHolder(leafNamesList.back())); // resize buffer
+    std::string leafName = leafDef.first.substr(0,leafDef.first.find("[")).substr(0, leafDef.first.find("/"));
+    leafIndexList.emplace_back(eventList_[0].findVarIndex(leafName));
+    auto& leafHolderBuffer = leafHolderBufferList[leafIndexList.size()-1];
+    leafDef.second(loadedLeavesArr, eventList_[0].getLeafHolder(leafIndexList.back(), leafHolderBuffer)); // resize buffer
   }
   loadedLeavesArr.lockArraySize();
   tree->Branch("Leaves", &loadedLeavesArr.getRawDataArray()[0], leavesDefStr.c_str());
@@ -133,7 +137,10 @@ void EventTreeWriter::writeEvents(TDirectory *saveDir_, const std::string& treeN
 
     iLeaf = 0;
     loadedLeavesArr.resetCurrentByteOffset();
-    for( auto& leafDef : loadedLeavesDict ){ leafDef.second(loadedLeavesArr, event.getLeafHolder(leafNamesList[iLeaf++])); }
+    for( auto& leafDef : loadedLeavesDict ){
+      leafDef.second(loadedLeavesArr, event.getLeafHolder(leafIndexList[iLeaf], leafHolderBufferList[iLeaf]));
+      iLeaf++;
+    }
 
 //    if( _writeDials_ ){
 //      for( auto& spline : responseSplineList ){ *spline = flatSplinesList[iPar]; } // by default
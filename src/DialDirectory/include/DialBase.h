@@ -7,35 +7,55 @@
 
 #include "GenericToolbox.h"
 
-#include <vector>
-#include <mutex>
+#include "cstdint"
+#include "cstddef"
+#include "limits"
+#include "cmath"
 
-ENUM_EXPANDER( DialType, -1
+class FitParameterSet;
+
+// Common definitions of the DialDirectory engine. Instead of one virtual Dial object per response, the dials are
+// stored in flat per-type arrays (DialCollection), and everything they need is resolved when the engine is built.
+
+ENUM_EXPANDER( DialCollectionType, -1
                , Unset
                , Norm
-               , Spline
+               , UniformSpline
+               , GeneralSpline
+               , MonotonicSpline
                , Graph
-               , Nested
 )
 
-// DialBase is a virtual class which is in charge of providing the response to be applied on the physics events.
-// DialApplier is supposed to be owned by DialCollection
-
-class DialBase {
-
-protected:
-  // Not supposed to define a bare Dial. Use the downcast instead
-  explicit DialBase(DialType dialType_);
-
-public:
-  virtual ~DialBase();
-
-  double evalResponse();
-
-private:
-  const DialType _dialType_;
-  std::shared_ptr<std::mutex> _evalMutex_{nullptr};
+// Shared by all the dials of a DialSet
+struct DialSetProperties{
+  uint32_t parIndex{0};
+  const FitParameterSet* parSetPtr{nullptr}; // mask state
+  bool useMirror{false};
+  double mirrorLowEdge{0};
+  double mirrorRange{0};
+  double minResponse{-std::numeric_limits<double>::infinity()};
+  double maxResponse{std::numeric_limits<double>::infinity()};
+
+  double getEffectiveDialParameter(double parameterValue_) const{
+    // same as Dial::getEffectiveDialParameter()
+    if( not useMirror ) return parameterValue_;
+    parameterValue_ = std::abs(std::fmod(parameterValue_ - mirrorLowEdge, 2 * mirrorRange));
+    if( parameterValue_ > mirrorRange ){
+      parameterValue_ -= 2 * mirrorRange;
+      parameterValue_ = -parameterValue_;
+    }
+    return parameterValue_ + mirrorLowEdge;
+  }
+};
 
+// Consecutive dials of a DialCollection sharing their DialSet and their data size (and contiguous spline data)
+struct DialRun{
+  uint32_t dialSetIndex{0};
+  uint32_t parIndex{0};
+  size_t beginIndex{0}; // dial indices in the collection
+  size_t endIndex{0};
+  const double* dataPtr{nullptr}; // splines: data of dial i at dataPtr + (i-beginIndex)*dim, in the DialSet arena
+  int dim{0};
 };
 
 
@@ -9,17 +9,49 @@
 
 #include "vector"
 
-// A DialCollection provide at most ONE dial per event.
-// Own by DialDirectory
+// A DialCollection holds all the dials of one type, as flat arrays.
+// The dials are sorted by parameter, DialSet and data size, so they are evaluated run by run in tight loops, without
+// any virtual call nor pointer chain. Splines use the SplineBatch kernels.
+// The data isn't copied: spline runs point in the packed arena of their DialSet, graphs in their GraphDial.
+// Owned by DialDirectory
 
 class DialCollection {
 
 public:
-  DialCollection();
+  explicit DialCollection(DialCollectionType type_ = DialCollectionType::Unset);
   virtual ~DialCollection();
 
+  void clear();
+
+  // Init: the dials must be added sorted by (parIndex, dialSetIndex, dim, data address). data_ must outlive the collection.
+  void addDial(uint32_t parIndex_, uint32_t dialSetIndex_, uint32_t responseIndex_, const double* data_, int dim_);
+  void finalize(size_t nParameters_);
+
+  // Getters
+  DialCollectionType getType() const{ return _type_; }
+  size_t getNbDials() const{ return _responseIndexList_.size(); }
+  size_t getNbRuns() const{ return _runList_.size(); }
+  size_t getParDialBegin(uint32_t parIndex_) const{ return _parDialOffsetList_[parIndex_]; }
+  size_t getParDialEnd(uint32_t parIndex_) const{ return _parDialOffsetList_[parIndex_+1]; }
+  const std::vector<uint32_t>& getResponseIndexList() const{ return _responseIndexList_; }
+
+  // Core
+  // Writes the responses of the dials [beginIndex_, endIndex_) in responseList_. Returns false if one of them is
+  // NaN, or negative while Dial::throwIfResponseIsNegative is set.
+  bool evalRange(size_t beginIndex_, size_t endIndex_, const double* parValueList_,
+                 const std::vector<DialSetProperties>& dialSetList_, double* responseList_);
+
+  // Misc
+  size_t getMemoryUsage() const;
+
 private:
-  std::vector<DialBase> _dialApplierList_{};
+  DialCollectionType _type_{DialCollectionType::Unset};
+
+  std::vector<DialRun> _runList_{};
+  std::vector<uint32_t> _responseIndexList_{}; // output slot of each dial
+  std::vector<const double*> _graphDataPtrList_{}; // graphs only: data of each dial
+  std::vector<double> _valueList_{};          // raw responses, before the caps
+  std::vector<size_t> _parDialOffsetList_{};  // dials of parameter p: [ offset[p], offset[p+1] )
 
 };
 
@@ -6,13 +6,17 @@
 #define GUNDAM_DIALDIRECTORY_H
 
 #include "DialCollection.h"
+#include "Dial.h"
+#include "FitParameter.h"
 
 #include "vector"
 #include "string"
 
-// A DialDirectory contains a list of DialCollection
-// DialDirectory is related to DataSet (different datasets may define their own way of propagating systematics)
-// Owned by Propagator
+// A DialDirectory contains one DialCollection per dial type.
+// It is built from the list of the Dial objects referenced by the events, and evaluates the same responses in flat
+// per-type loops, with the parameter of each dial resolved at build time. Dials it can't handle (ROOT splines, ...)
+// are flagged so the caller keeps evaluating them through the Dial interface.
+// Owned by EventDialCache
 
 class DialDirectory {
 
@@ -20,11 +24,40 @@ public:
   DialDirectory();
   virtual ~DialDirectory();
 
-  void initialize();
+  void clear();
+
+  // Init: the response of dialList_[i] is written in responseList[i]
+  void initialize(const std::vector<Dial*>& dialList_, const std::vector<const FitParameter*>& parameterList_);
+
+  // Getters
+  bool isInitialized() const{ return _isInitialized_; }
+  const std::vector<char>& getIsHandledList() const{ return _isHandledList_; }
+  size_t getNbHandledDials() const;
+  std::string getSummary() const;
+
+  // Core
+  void updateParameterValues(); // single thread, before evalResponses()
+  void evalResponses(double* responseList_, int iThread_, int nThreads_);
+  void evalResponses(double* responseList_, const std::vector<uint32_t>& parIndexList_, int iThread_, int nThreads_);
+
+  // Compares every handled response with the one given by the Dial interface
+  void validate(double maxRelativeDiff_ = 1E-9);
+
+  // Misc
+  size_t getMemoryUsage() const;
+
+protected:
+  void evalRange(DialCollection& collection_, size_t beginIndex_, size_t endIndex_, double* responseList_);
 
 private:
-  std::vector<std::string> _dataSetSelection_{1, ""};
-  std::vector<DialCollection> _dialSetList_{};
+  bool _isInitialized_{false};
+
+  std::vector<Dial*> _dialPtrList_{}; // response index -> original dial (error messages, validation)
+  std::vector<const FitParameter*> _parameterList_{};
+  std::vector<double> _parameterValueList_{};
+  std::vector<DialSetProperties> _dialSetList_{};
+  std::vector<DialCollection> _dialCollectionList_{};
+  std::vector<char> _isHandledList_{};
 
 };
 
@@ -1,19 +0,0 @@
-//
-// Created by Adrien BLANCHET on 13/04/2022.
-//
-
-#ifndef GUNDAM_NORMDIAL_H
-#define GUNDAM_NORMDIAL_H
-
-#include "DialBase.h"
-
-class NormDial : public DialBase {
-
-public:
-  NormDial();
-  ~NormDial() override;
-
-};
-
-
-#endif //GUNDAM_NORMDIAL_H
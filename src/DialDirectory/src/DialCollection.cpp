@@ -3,6 +3,131 @@
 //
 
 #include "DialCollection.h"
+#include "Dial.h"
+#include "FitParameterSet.h"
+#include "SplineBatch.h"
+#include "CalculateGraph.h"
 
-DialCollection::DialCollection() = default;
+#include "Logger.h"
+
+#include <algorithm>
+
+LoggerInit([]{ Logger::setUserHeaderStr("[DialCollection]"); });
+
+
+DialCollection::DialCollection(DialCollectionType type_) : _type_{type_} {}
 DialCollection::~DialCollection() = default;
+
+void DialCollection::clear(){
+  _runList_.clear();
+  _responseIndexList_.clear();
+  _graphDataPtrList_.clear();
+  _valueList_.clear();
+  _parDialOffsetList_.clear();
+}
+
+void DialCollection::addDial(uint32_t parIndex_, uint32_t dialSetIndex_, uint32_t responseIndex_, const double* data_, int dim_){
+  // the spline kernels need the data of a run to be contiguous
+  bool isSpline{_type_ != DialCollectionType::Norm and _type_ != DialCollectionType::Graph};
+  if( _runList_.empty()
+      or _runList_.back().dialSetIndex != dialSetIndex_
+      or _runList_.back().dim != dim_
+      or ( isSpline and data_ != _runList_.back().dataPtr + (_runList_.back().endIndex - _runList_.back().beginIndex)*dim_ ) ){
+    LogThrowIf(not _runList_.empty() and _runList_.back().parIndex > parIndex_, "Dials must be sorted by parameter.");
+    _runList_.emplace_back();
+    _runList_.back().dialSetIndex = dialSetIndex_;
+    _runList_.back().parIndex = parIndex_;
+    _runList_.back().beginIndex = _responseIndexList_.size();
+    _runList_.back().endIndex = _responseIndexList_.size();
+    _runList_.back().dataPtr = isSpline ? data_ : nullptr;
+    _runList_.back().dim = dim_;
+  }
+  _responseIndexList_.emplace_back(responseIndex_);
+  if( _type_ == DialCollectionType::Graph ){ _graphDataPtrList_.emplace_back(data_); }
+  _runList_.back().endIndex++;
+}
+void DialCollection::finalize(size_t nParameters_){
+  _runList_.shrink_to_fit();
+  _responseIndexList_.shrink_to_fit();
+  _graphDataPtrList_.shrink_to_fit();
+  _valueList_.resize(_responseIndexList_.size(), 0);
+
+  _parDialOffsetList_.assign(nParameters_+1, 0);
+  for( auto& run : _runList_ ){ _parDialOffsetList_[run.parIndex+1] += run.endIndex - run.beginIndex; }
+  for( size_t iPar = 0 ; iPar < nParameters_ ; iPar++ ){ _parDialOffsetList_[iPar+1] += _parDialOffsetList_[iPar]; }
+}
+
+bool DialCollection::evalRange(size_t beginIndex_, size_t endIndex_, const double* parValueList_,
+                               const std::vector<DialSetProperties>& dialSetList_, double* responseList_){
+  if( beginIndex_ >= endIndex_ ) return true;
+
+  // first run overlapping the range
+  auto runIt = std::upper_bound(
+      _runList_.begin(), _runList_.end(), beginIndex_,
+      [](size_t index_, const DialRun& run_){ return index_ < run_.beginIndex; }
+  ) - 1;
+
+  bool isValid{true};
+  for( ; runIt != _runList_.end() and runIt->beginIndex < endIndex_ ; ++runIt ){
+    const size_t iBegin{std::max(beginIndex_, runIt->beginIndex)};
+    const size_t iEnd{std::min(endIndex_, runIt->endIndex)};
+    const size_t nDials{iEnd - iBegin};
+    const auto& dialSet = dialSetList_[runIt->dialSetIndex];
+    const uint32_t* responseIndex{&_responseIndexList_[iBegin]};
+
+    if( Dial::enableMaskCheck and dialSet.parSetPtr->isMaskedForPropagation() ){
+      for( size_t iDial = 0 ; iDial < nDials ; iDial++ ){ responseList_[responseIndex[iDial]] = 1; }
+      continue;
+    }
+
+    double* value{&_valueList_[iBegin]};
+    const int dim{runIt->dim};
+    const double* data{runIt->dataPtr == nullptr ? nullptr : runIt->dataPtr + (iBegin - runIt->beginIndex)*dim}; // splines
+    const double parValue{parValueList_[runIt->parIndex]};
+
+    // one switch per run
+    switch( _type_ ){
+      case DialCollectionType::Norm:
+        std::fill(value, value + nDials, dialSet.getEffectiveDialParameter(parValue));
+        break;
+      case DialCollectionType::UniformSpline:
+        SplineBatch::evalUniformSplines(dialSet.getEffectiveDialParameter(parValue), data, dim, nDials, value);
+        break;
+      case DialCollectionType::GeneralSpline:
+        SplineBatch::evalGeneralSplines(dialSet.getEffectiveDialParameter(parValue), data, dim, nDials, value);
+        break;
+      case DialCollectionType::MonotonicSpline:
+        SplineBatch::evalMonotonicSplines(dialSet.getEffectiveDialParameter(parValue), data, dim, nDials, value);
+        break;
+      case DialCollectionType::Graph:{
+        const double x{dialSet.getEffectiveDialParameter(parValue)};
+        const double* const* graphData{&_graphDataPtrList_[iBegin]};
+        for( size_t iDial = 0 ; iDial < nDials ; iDial++ ){ value[iDial] = CalculateGraph(x, -1E20, 1E20, graphData[iDial], dim); }
+        break;
+      }
+      default:
+        LogThrow("Invalid collection type: " << _type_);
+    }
+
+    // caps, same as Dial::capDialResponse()
+    for( size_t iDial = 0 ; iDial < nDials ; iDial++ ){
+      double response{value[iDial]};
+      if     ( response < dialSet.minResponse ){ response = dialSet.minResponse; }
+      else if( response > dialSet.maxResponse ){ response = dialSet.maxResponse; }
+      isValid &= ( response == response ) and ( not Dial::throwIfResponseIsNegative or response >= 0 );
+      responseList_[responseIndex[iDial]] = response;
+    }
+  }
+
+  return isValid;
+}
+
+size_t DialCollection::getMemoryUsage() const{
+  size_t out{0};
+  out += _runList_.capacity() * sizeof(DialRun);
+  out += _responseIndexList_.capacity() * sizeof(uint32_t);
+  out += _graphDataPtrList_.capacity() * sizeof(const double*);
+  out += _valueList_.capacity() * sizeof(double);
+  out += _parDialOffsetList_.capacity() * sizeof(size_t);
+  return out;
+}
@@ -3,12 +3,236 @@
 //
 
 #include "DialDirectory.h"
+#include "DialSet.h"
+#include "NormDial.h"
+#include "SplineDial.h"
+#include "GraphDial.h"
+#include "FitParameterSet.h"
 
-DialDirectory::DialDirectory() {}
-DialDirectory::~DialDirectory() {
+#include "Logger.h"
+#include "GenericToolbox.h"
 
+#include <unordered_map>
+#include <algorithm>
+#include <sstream>
+#include <limits>
+#include <cmath>
+#include <functional>
+
+LoggerInit([]{ Logger::setUserHeaderStr("[DialDirectory]"); });
+
+
+DialDirectory::DialDirectory() = default;
+DialDirectory::~DialDirectory() = default;
+
+void DialDirectory::clear(){
+  _isInitialized_ = false;
+  _dialPtrList_.clear();
+  _parameterList_.clear();
+  _parameterValueList_.clear();
+  _dialSetList_.clear();
+  _dialCollectionList_.clear();
+  _isHandledList_.clear();
+}
+
+void DialDirectory::initialize(const std::vector<Dial*>& dialList_, const std::vector<const FitParameter*>& parameterList_){
+  LogWarning << __METHOD_NAME__ << std::endl;
+  this->clear();
+
+  LogThrowIf(dialList_.size() >= std::numeric_limits<uint32_t>::max(), "Too many dials for 32-bit indices.");
+  _dialPtrList_ = dialList_;
+  _parameterList_ = parameterList_;
+  _parameterValueList_.resize(_parameterList_.size(), 0);
+  _isHandledList_.resize(_dialPtrList_.size(), 0);
+
+  std::unordered_map<const FitParameter*, uint32_t> parIndexDict;
+  for( size_t iPar = 0 ; iPar < _parameterList_.size() ; iPar++ ){ parIndexDict[_parameterList_[iPar]] = uint32_t(iPar); }
+
+  for( int iType = 0 ; iType < DialCollectionType_OVERFLOW ; iType++ ){
+    _dialCollectionList_.emplace_back(DialCollectionType(iType));
+  }
+
+  // Resolve the type, parameter and DialSet of each dial
+  struct DialEntry{ uint32_t parIndex; uint32_t dialSetIndex; uint32_t responseIndex; int dim; const double* data; };
+  std::vector<std::vector<DialEntry>> entryList(_dialCollectionList_.size());
+  std::unordered_map<const DialSet*, uint32_t> dialSetIndexDict;
+  for( size_t iDial = 0 ; iDial < _dialPtrList_.size() ; iDial++ ){
+    Dial* dialPtr = _dialPtrList_[iDial];
+
+    DialCollectionType type{DialCollectionType::Unset};
+    int dim{0};
+    const double* data{nullptr};
+    if( dialPtr->getDialType() == DialType::Norm ){
+      type = DialCollectionType::Norm;
+    }
+#ifndef USE_TSPLINE3_EVAL
+    else if( dialPtr->getDialType() == DialType::Spline ){
+      auto* splineDialPtr = static_cast<SplineDial*>(dialPtr);
+      if     ( splineDialPtr->getSplineType() == SplineDial::Uniform ){ type = DialCollectionType::UniformSpline; }
+      else if( splineDialPtr->getSplineType() == SplineDial::General ){ type = DialCollectionType::GeneralSpline; }
+      else if( splineDialPtr->getSplineType() == SplineDial::Monotonic ){ type = DialCollectionType::MonotonicSpline; }
+      dim = splineDialPtr->getSplineDataSize();
+      data = splineDialPtr->getSplineData();
+    }
+#endif
+    else if( dialPtr->getDialType() == DialType::Graph ){
+      type = DialCollectionType::Graph;
+      dim = int(static_cast<GraphDial*>(dialPtr)->getGraphData().size());
+      data = static_cast<GraphDial*>(dialPtr)->getGraphData().data();
+    }
+    if( type == DialCollectionType::Unset ) continue; // ROOT splines...
+
+    auto parIt = parIndexDict.find(dialPtr->getOwner()->getOwner());
+    LogThrowIf(parIt == parIndexDict.end(), "Parameter of dial not registered: " << dialPtr->getSummary());
+
+    auto setIt = dialSetIndexDict.find(dialPtr->getOwner());
+    if( setIt == dialSetIndexDict.end() ){
+      const DialSet* dialSetPtr = dialPtr->getOwner();
+      setIt = dialSetIndexDict.emplace(dialSetPtr, uint32_t(_dialSetList_.size())).first;
+      _dialSetList_.emplace_back();
+      auto& dialSet = _dialSetList_.back();
+      dialSet.parIndex = parIt->second;
+      dialSet.parSetPtr = dialSetPtr->getOwner()->getOwner();
+      dialSet.useMirror = dialSetPtr->useMirrorDial();
+      dialSet.mirrorLowEdge = dialSetPtr->getMirrorLowEdge();
+      dialSet.mirrorRange = dialSetPtr->getMirrorRange();
+      if( dialSetPtr->getMinDialResponse() == dialSetPtr->getMinDialResponse() ){ dialSet.minResponse = dialSetPtr->getMinDialResponse(); }
+      if( dialSetPtr->getMaxDialResponse() == dialSetPtr->getMaxDialResponse() ){ dialSet.maxResponse = dialSetPtr->getMaxDialResponse(); }
+    }
+
+    entryList[int(type)].push_back({parIt->second, setIt->second, uint32_t(iDial), dim, data});
+    _isHandledList_[iDial] = 1;
+  }
+
+  // Fill the collections, sorted so the dials sharing their input are contiguous.
+  // The data is referenced in place: in the DialSet arena order, consecutive spline dials make a single run.
+  for( size_t iType = 0 ; iType < _dialCollectionList_.size() ; iType++ ){
+    auto& entries = entryList[iType];
+    std::stable_sort(entries.begin(), entries.end(), [](const DialEntry& a_, const DialEntry& b_){
+      if( a_.parIndex != b_.parIndex ) return a_.parIndex < b_.parIndex;
+      if( a_.dialSetIndex != b_.dialSetIndex ) return a_.dialSetIndex < b_.dialSetIndex;
+      if( a_.dim != b_.dim ) return a_.dim < b_.dim;
+      return std::less<const double*>()(a_.data, b_.data);
+    });
+
+    auto& collection = _dialCollectionList_[iType];
+    for( auto& entry : entries ){
+      collection.addDial(entry.parIndex, entry.dialSetIndex, entry.responseIndex, entry.data, entry.dim);
+    }
+    collection.finalize(_parameterList_.size());
+  }
+
+  _isInitialized_ = true;
+  LogInfo << this->getSummary() << std::endl;
+}
+
+size_t DialDirectory::getNbHandledDials() const{
+  size_t out{0};
+  for( auto& collection : _dialCollectionList_ ){ out += collection.getNbDials(); }
+  return out;
+}
+std::string DialDirectory::getSummary() const{
+  std::stringstream ss;
+  ss << "DialDirectory: " << this->getNbHandledDials() << "/" << _dialPtrList_.size() << " dials handled";
+  for( auto& collection : _dialCollectionList_ ){
+    if( collection.getNbDials() == 0 ) continue;
+    ss << std::endl << "  " << DialCollectionTypeEnumNamespace::toString(collection.getType()) << ": "
+    << collection.getNbDials() << " dials in " << collection.getNbRuns() << " runs";
+  }
+  ss << std::endl << "  Memory: " << GenericToolbox::parseSizeUnits(double(this->getMemoryUsage()));
+  return ss.str();
+}
+
+void DialDirectory::updateParameterValues(){
+  for( size_t iPar = 0 ; iPar < _parameterList_.size() ; iPar++ ){
+    _parameterValueList_[iPar] = _parameterList_[iPar]->getParameterValue();
+  }
+}
+void DialDirectory::evalResponses(double* responseList_, int iThread_, int nThreads_){
+  for( auto& collection : _dialCollectionList_ ){
+    size_t nDials{collection.getNbDials()};
+    this->evalRange(collection, nDials*iThread_/nThreads_, nDials*(iThread_+1)/nThreads_, responseList_);
+  }
+}
+void DialDirectory::evalResponses(double* responseList_, const std::vector<uint32_t>& parIndexList_, int iThread_, int nThreads_){
+  for( auto& collection : _dialCollectionList_ ){
+    for( auto& iPar : parIndexList_ ){
+      size_t begin{collection.getParDialBegin(iPar)};
+      size_t nDials{collection.getParDialEnd(iPar) - begin};
+      this->evalRange(collection, begin + nDials*iThread_/nThreads_, begin + nDials*(iThread_+1)/nThreads_, responseList_);
+    }
+  }
+}
+
+void DialDirectory::validate(double maxRelativeDiff_){
+  LogThrowIf(not _isInitialized_, "DialDirectory not initialized.");
+  LogInfo << "Validating the DialDirectory responses against the Dial interface..." << std::endl;
+
+  std::unordered_map<const FitParameter*, size_t> parIndexDict;
+  for( size_t iPar = 0 ; iPar < _parameterList_.size() ; iPar++ ){ parIndexDict[_parameterList_[iPar]] = iPar; }
+
+  // The current values, then shifted values (in units of the prior sigma): mirroring, caps and the
+  // extrapolation outside the knot range are only exercised away from the nominal point
+  std::vector<double> shiftList{-5, -2, -0.5, 0.3, 1, 2.5, 5};
+  bool throwIfResponseIsNegative{Dial::throwIfResponseIsNegative};
+  Dial::throwIfResponseIsNegative = false; // far from the prior, a negative response is legit here
+
+  size_t nBad{0};
+  std::vector<double> responseList(_dialPtrList_.size(), 1);
+  for( size_t iPoint = 0 ; iPoint <= shiftList.size() ; iPoint++ ){
+    this->updateParameterValues();
+    if( iPoint != 0 ){
+      for( size_t iPar = 0 ; iPar < _parameterList_.size() ; iPar++ ){
+        double sigma{_parameterList_[iPar]->getStdDevValue()};
+        if( not ( sigma > 0 ) or std::isinf(sigma) ){ sigma = 1; }
+        double prior{_parameterList_[iPar]->getPriorValue()};
+        if( prior != prior ){ prior = _parameterValueList_[iPar]; }
+        _parameterValueList_[iPar] = prior + shiftList[iPoint-1] * sigma;
+      }
+    }
+    this->evalResponses(responseList.data(), 0, 1);
+
+    for( size_t iDial = 0 ; iDial < _dialPtrList_.size() ; iDial++ ){
+      if( not _isHandledList_[iDial] ) continue;
+      if( Dial::enableMaskCheck and _dialPtrList_[iDial]->isMasked() ) continue;
+      double parValue{_parameterValueList_[parIndexDict.at(_dialPtrList_[iDial]->getOwner()->getOwner())]};
+      double expected{_dialPtrList_[iDial]->evalResponse(parValue)};
+      double diff{std::abs(responseList[iDial] - expected)};
+      if( diff > maxRelativeDiff_ * std::max(1., std::abs(expected)) ){
+        if( nBad++ < 10 ){
+          LogError << "Response mismatch at " << parValue << ": " << responseList[iDial] << " != " << expected << " -> "
+          << _dialPtrList_[iDial]->getSummary() << std::endl;
+        }
+      }
+    }
+  }
+  Dial::throwIfResponseIsNegative = throwIfResponseIsNegative;
+  this->updateParameterValues();
+
+  LogThrowIf(nBad != 0, nBad << " DialDirectory responses don't match the Dial interface.");
+  LogInfo << "DialDirectory responses are valid at " << shiftList.size() + 1 << " parameter points." << std::endl;
+}
+
+size_t DialDirectory::getMemoryUsage() const{
+  size_t out{0};
+  out += _dialPtrList_.capacity() * sizeof(Dial*);
+  out += _parameterList_.capacity() * sizeof(FitParameter*);
+  out += _parameterValueList_.capacity() * sizeof(double);
+  out += _dialSetList_.capacity() * sizeof(DialSetProperties);
+  out += _isHandledList_.capacity() * sizeof(char);
+  for( auto& collection : _dialCollectionList_ ){ out += collection.getMemoryUsage(); }
+  return out;
 }
 
-void DialDirectory::initialize() {
+void DialDirectory::evalRange(DialCollection& collection_, size_t beginIndex_, size_t endIndex_, double* responseList_){
+  if( collection_.evalRange(beginIndex_, endIndex_, _parameterValueList_.data(), _dialSetList_, responseList_) ) return;
 
+  // Invalid response: let the Dial interface report it the usual way
+  for( size_t iDial = beginIndex_ ; iDial < endIndex_ ; iDial++ ){
+    uint32_t iResponse{collection_.getResponseIndexList()[iDial]};
+    double response{responseList_[iResponse]};
+    if( response == response and ( not Dial::throwIfResponseIsNegative or response >= 0 ) ) continue;
+    _dialPtrList_[iResponse]->evalResponse();
+    LogThrow("Invalid response (" << response << "): " << _dialPtrList_[iResponse]->getSummary());
+  }
 }
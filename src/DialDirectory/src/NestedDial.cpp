@@ -1,8 +0,0 @@
-//
-// Created by Adrien BLANCHET on 13/04/2022.
-//
-
-#include "NestedDial.h"
-
-NestedDial::NestedDial() : DialBase(Nested) {}
-NestedDial::~NestedDial() = default;
@@ -1,8 +0,0 @@
-//
-// Created by Adrien BLANCHET on 13/04/2022.
-//
-
-#include "NormDial.h"
-
-NormDial::NormDial() : DialBase(Norm) {};
-NormDial::~NormDial() = default;
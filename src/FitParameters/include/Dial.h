@@ -64,23 +64,36 @@ public:
   DialType::DialType getDialType() const;
   const DataBin* getApplyConditionBinPtr() const;
   const DialSet* getOwner() const;
+  bool isIdentity() const; // the capped response is exactly 1 wherever the dial can be evaluated
 
   // getters
   DataBin* getApplyConditionBinPtr();
 
   // calc
   double getEffectiveDialParameter(double parameterValue_);
+  double getEffectiveDialParameterDerivative(double parameterValue_) const; // +1, or -1 on a mirrored period
   double capDialResponse(double response_);
   double evalResponse();
+  double fillResponseCache();
+  double setResponseCache(double parameterValue_, double calcDialResult_); // result of calcDial() evaluated elsewhere (batch)
 
   // virtual
   virtual double calcDial(double parameterValue_) = 0;
   virtual double evalResponse(double parameterValue_);
+  virtual double fillResponseCache(double parameterValue_); // lock-free: a given dial must only be handled by one thread
+  virtual double evalResponseDerivative(double parameterValue_); // d(response)/d(parameter), 0 where the response is capped
+  virtual double calcDialDerivative(double parameterValue_); // default: central difference of calcDial()
   virtual std::string getSummary();
 
   // debug
   virtual void writeSpline(const std::string &fileName_) const {}
 
+protected:
+  // true if calcDial() returns exactly 1 for any effective dial parameter within [xMin_, xMax_]
+  virtual bool isIdentityWithin(double xMin_, double xMax_) const { return false; }
+
+public:
+
 
 //  void copySplineCache(TSpline3& splineBuffer_);
 //  virtual void buildResponseSplineCache();
@@ -94,7 +107,6 @@ protected:
   DataBin* _applyConditionBin_{nullptr};
 
   // Internals
-  GenericToolbox::NoCopyWrapper<std::mutex> _evalDialLock_;
   bool _isReferenced_{false};
   double _dialResponseCache_{std::nan("unset")};
   double _dialParameterCache_{std::nan("unset")};
@@ -49,6 +49,9 @@ public:
   const std::string &getDialSubType() const;
   DialType::DialType getGlobalDialType() const;
   const FitParameter* getOwner() const { return _owner_; }
+  const std::vector<double>& getSplineDataArena() const { return _splineDataArena_; }
+  bool isDeduplicateDials() const { return _deduplicateDials_; }
+  double getDialDeduplicationTolerance() const { return _dialDeduplicationTolerance_; }
 
   double getMinDialResponse() const;
   double getMaxDialResponse() const;
@@ -62,6 +65,10 @@ public:
   void applyGlobalParameters(Dial* dial_) const;
   void applyGlobalParameters(Dial& dial_) const;
 
+  // Memory: moves the data of the spline dials in one contiguous arena, and optionally drops their TSpline3.
+  // To be called once all the dials are initialized.
+  void packSplineData(bool releaseSplines_);
+
 protected:
   void readGlobals(const nlohmann::json &config_);
   bool initializeNormDialsWithParBinning();
@@ -84,11 +91,14 @@ private:
 
 //  std::vector<DialWrapper<Dial>> _dialList_{};
   std::vector<DialWrapper> _dialList_{};
+  std::vector<double> _splineDataArena_{}; // SplineDial data, see packSplineData()
 
   // globals
   DialType::DialType _globalDialType_{DialType::DialType_OVERFLOW};
   std::string _globalDialSubType_{};
   std::string _globalDialLeafName_{};
+  bool _deduplicateDials_{false}; // event-by-event dials with matching knots share one dial
+  double _dialDeduplicationTolerance_{0};
   double _minDialResponse_{std::nan("unset")};
   double _maxDialResponse_{std::nan("unset")};
   bool _useMirrorDial_{false};
@@ -51,6 +51,7 @@ public:
   void setStepSize(double stepSize);
   void setOwner(const FitParameterSet *owner_);
   void setPriorType(PriorType::PriorType priorType);
+  void setIsDirty(bool isDirty_){ _isDirty_ = isDirty_; }
 
   void setValueAtPrior();
   void setCurrentValueAsPrior();
@@ -62,6 +63,7 @@ public:
   bool isFixed() const;
   bool isEigen() const;
   bool isFree() const;
+  bool isDirty() const{ return _isDirty_; } // value changed since the last propagation
   PriorType::PriorType getPriorType() const;
   int getParameterIndex() const;
   const std::string &getName() const;
@@ -105,6 +107,7 @@ private:
 
   bool _isEigen_{false};
   bool _isFree_{false};
+  bool _isDirty_{true};
 
   // Internals
   std::vector<DialSet> _dialSetList_; // one dial set per detector
@@ -67,6 +67,10 @@ public:
   size_t getNbParameters() const;
   double getPenaltyChi2();
 
+  // Gradients, indexed like getEffectiveParameterList()
+  std::vector<double> getPenaltyChi2Gradient();
+  std::vector<double> toEffectiveGradient(const std::vector<double>& gradient_) const; // from d/d(getParameterList())
+
   // Throw / Shifts
   void moveFitParametersToPrior();
   void throwFitParameters(double gain_ = 1);
@@ -9,6 +9,8 @@
 
 #include "Dial.h"
 
+#include "vector"
+
 class GraphDial : public Dial {
 
 public:
@@ -21,11 +23,23 @@ public:
 
   void initialize() override;
 
+  const TGraph& getGraph() const{ return _graph_; }
+  const std::vector<double>& getGraphData() const{ return _graphData_; } // CalculateGraph layout, filled by initialize()
+
   double calcDial(double parameterValue_) override;
+  double calcDialDerivative(double parameterValue_) override;
   std::string getSummary() override;
 
+protected:
+  bool isIdentityWithin(double xMin_, double xMax_) const override;
+
 private:
   TGraph _graph_;
+
+  // The graph points packed for CalculateGraph, which is shared with the Cache::Manager.
+  std::vector<double> _graphData_;
+
+  void fillGraphData();
 };
 
 
@@ -20,7 +20,10 @@ public:
   void initialize() override;
 
   double evalResponse(double parameterValue_) override;
+  double fillResponseCache(double parameterValue_) override;
   double calcDial(double parameterValue_) override;
+  double evalResponseDerivative(double parameterValue_) override;
+  double calcDialDerivative(double parameterValue_) override{ return 1; }
 
 };
 
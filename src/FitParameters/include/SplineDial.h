@@ -11,6 +11,7 @@
 
 #include "memory"
 #include "string"
+#include "limits"
 
 class SplineDial : public Dial {
 
@@ -25,22 +26,32 @@ public:
 
   void initialize() override;
 
+  // rebuilt from the spline data if the TSpline3 has been released (not thread safe)
   const TSpline3* getSplinePtr() const;
   std::string getSummary() override;
 
   double calcDial(double parameterValue_) override;
+  double calcDialDerivative(double parameterValue_) override;
 
   // Debug
   void writeSpline(const std::string &fileName_) const override;
 
+  // Memory
+  bool isSplineReleased() const{ return _spline_ == nullptr; }
+  void releaseSpline(); // drops the TSpline3 once the spline data is filled (not for ROOTSpline)
+
 #ifdef ENABLE_SPLINE_DIAL_FAST_EVAL
   void fastEval();
 #endif
 
 
 protected:
-  // The representation of the spline read from a root input file.
-  TSpline3 _spline_;
+  bool isIdentityWithin(double xMin_, double xMax_) const override;
+
+  // The representation of the spline read from a root input file. Shared by the clones, never modified in place.
+  mutable std::shared_ptr<TSpline3> _spline_{nullptr};
+  double _xMin_{0};
+  double _xMax_{0};
 
 #ifdef ENABLE_SPLINE_DIAL_FAST_EVAL
   struct FastSpliner{
@@ -62,7 +73,13 @@ public:
   } Subtype;
 
   Subtype getSplineType() const;
-  const std::vector<double>& getSplineData() const;
+  const double* getSplineData() const; // in the DialSet arena once packed
+  int getSplineDataSize() const;
+
+  // Moves the spline data in the arena of the owner DialSet (see DialSet::packSplineData)
+  void setSplineDataArenaOffset(size_t splineDataArenaOffset_);
+  bool isSplineDataPacked() const{ return _splineDataArenaOffset_ != std::numeric_limits<size_t>::max(); }
+  size_t getSplineDataArenaOffset() const{ return _splineDataArenaOffset_; }
 
 protected:
   // The type of spline that should be used for this dial.
@@ -72,6 +89,8 @@ protected:
   // the Cache::Manager to work, and provides the input for spline calculation
   // functions that can be shared between the CPU and the GPU.
   std::vector<double> _splineData_;
+  size_t _splineDataArenaOffset_{std::numeric_limits<size_t>::max()}; // packed if set
+  int _splineDataSize_{0};
 
   // This fills _splineData_ and sets the _splineType_.  It uses the spline
   // knot spacing, and the spline subtype set in the DialSet (which is read
@@ -88,6 +107,10 @@ protected:
   // General if it is false.  The knots are not checked to make sure they are
   // actually uniform.
   bool fillNaturalSpline(bool uniformKnots);
+
+  // TSpline3 with the knots of the spline data. Natural splines get the stored end slopes, so they are rebuilt
+  // exactly. Monotonic splines only keep their knots: the rebuilt TSpline3 is an approximation.
+  std::shared_ptr<TSpline3> buildSplineFromData() const;
 #endif
 
   // DEBUG
@@ -9,11 +9,23 @@
 #include "Logger.h"
 
 #include "sstream"
+#include "array"
+#include "cstdint"
+#include "limits"
+#include "cmath"
+#include "algorithm"
 
 LoggerInit([]{
   Logger::setUserHeaderStr("[Dial]");
 });
 
+namespace {
+  // Shared pool of locks used by evalResponse(). Holding one mutex per dial was making each Dial ~40 bytes larger.
+  std::array<std::mutex, 256> evalDialLockPool;
+  std::mutex& getEvalDialLock(const Dial* dialPtr_){
+    return evalDialLockPool[(reinterpret_cast<std::uintptr_t>(dialPtr_) >> 4) % evalDialLockPool.size()];
+  }
+}
 
 
 bool Dial::enableMaskCheck{false};
@@ -60,6 +72,26 @@ const DialSet* Dial::getOwner() const {
   LogThrowIf(!_owner_, "Invalid owning DialSet")
   return _owner_;
 }
+bool Dial::isIdentity() const {
+  // The caps must leave a response of 1 untouched
+  double minResponse{_owner_->getMinDialResponse()};
+  double maxResponse{_owner_->getMaxDialResponse()};
+  if( minResponse == minResponse and 1 < minResponse ){ return false; }
+  if( maxResponse == maxResponse and 1 > maxResponse ){ return false; }
+
+  // The parameter limits are not enforced everywhere (eigen propagated values, toy throws):
+  // the dial has to be an identity over the full range it can be evaluated on
+  if( _owner_->getOwner()->getOwner()->isUseEigenDecompInFit() ){ return false; }
+  double xMin{-std::numeric_limits<double>::infinity()};
+  double xMax{std::numeric_limits<double>::infinity()};
+  if( _owner_->useMirrorDial() ){
+    // values outside the mirror window are folded back into it
+    xMin = _owner_->getMirrorLowEdge();
+    xMax = _owner_->getMirrorHighEdge();
+  }
+
+  return this->isIdentityWithin(xMin, xMax);
+}
 const DataBin* Dial::getApplyConditionBinPtr() const{ return _applyConditionBin_; }
 
 DataBin* Dial::getApplyConditionBinPtr(){ return _applyConditionBin_; }
@@ -85,6 +117,14 @@ double Dial::getEffectiveDialParameter(double parameterValue_){
   }
   return parameterValue_;
 }
+double Dial::getEffectiveDialParameterDerivative(double parameterValue_) const{
+  if( not _owner_->useMirrorDial() ){ return 1; }
+  // same folding as getEffectiveDialParameter(): std::abs() flips below the low edge, odd periods are mirrored
+  double shiftedValue{parameterValue_ - _owner_->getMirrorLowEdge()};
+  double sign{shiftedValue < 0 ? -1. : 1.};
+  if( std::abs(std::fmod(shiftedValue, 2 * _owner_->getMirrorRange())) > _owner_->getMirrorRange() ){ sign = -sign; }
+  return sign;
+}
 double Dial::capDialResponse(double response_){
   // Cap checks
   if     (_owner_->getMinDialResponse() == _owner_->getMinDialResponse() and response_ < _owner_->getMinDialResponse() ){ response_=_owner_->getMinDialResponse(); }
@@ -102,6 +142,14 @@ double Dial::capDialResponse(double response_){
 double Dial::evalResponse(){
   return this->evalResponse( _owner_->getOwner()->getParameterValue() );
 }
+double Dial::fillResponseCache(){
+  return this->fillResponseCache( _owner_->getOwner()->getParameterValue() );
+}
+double Dial::setResponseCache(double parameterValue_, double calcDialResult_){
+  _dialResponseCache_ = this->capDialResponse(calcDialResult_);
+  _dialParameterCache_ = parameterValue_;
+  return _dialResponseCache_;
+}
 
 // Virtual
 double Dial::evalResponse(double parameterValue_) {
@@ -114,9 +162,9 @@ double Dial::evalResponse(double parameterValue_) {
 
   // If we reach this point, we either need to compute the response or wait for another thread to make the update.
 #if __cplusplus >= 201703L // https://stackoverflow.com/questions/26089319/is-there-a-standard-definition-for-cplusplus-in-c14
-  std::scoped_lock<std::mutex> g(_evalDialLock_); // There can be only one.
+  std::scoped_lock<std::mutex> g(getEvalDialLock(this)); // There can be only one.
 #else
-  std::lock_guard<std::mutex> g(_evalDialLock_); // There can be only one.
+  std::lock_guard<std::mutex> g(getEvalDialLock(this)); // There can be only one.
 #endif
   if( _dialParameterCache_ == parameterValue_ ) return _dialResponseCache_; // stop if already updated by another threads
 
@@ -126,6 +174,24 @@ double Dial::evalResponse(double parameterValue_) {
 
   return _dialResponseCache_;
 }
+double Dial::fillResponseCache(double parameterValue_){
+  if( Dial::disableDialCache or _dialParameterCache_ != parameterValue_ ){
+    _dialResponseCache_ = this->capDialResponse(this->calcDial(this->getEffectiveDialParameter(parameterValue_)));
+    _dialParameterCache_ = parameterValue_;
+  }
+  return _dialResponseCache_;
+}
+double Dial::evalResponseDerivative(double parameterValue_){
+  double dialParameter{this->getEffectiveDialParameter(parameterValue_)};
+  double response{this->calcDial(dialParameter)};
+  if( _owner_->getMinDialResponse() == _owner_->getMinDialResponse() and response < _owner_->getMinDialResponse() ){ return 0; }
+  if( _owner_->getMaxDialResponse() == _owner_->getMaxDialResponse() and response > _owner_->getMaxDialResponse() ){ return 0; }
+  return this->calcDialDerivative(dialParameter) * this->getEffectiveDialParameterDerivative(parameterValue_);
+}
+double Dial::calcDialDerivative(double parameterValue_){
+  double step{1E-6 * std::max(1., std::abs(parameterValue_))};
+  return (this->calcDial(parameterValue_ + step) - this->calcDial(parameterValue_ - step)) / (2 * step);
+}
 std::string Dial::getSummary(){
   std::stringstream ss;
   ss << _owner_->getOwner()->getOwner()->getName(); // parSet name
@@ -17,6 +17,8 @@
 #include "TFile.h"
 #include "TTree.h"
 
+#include "algorithm"
+
 
 bool DialSet::verboseMode{false};
 
@@ -36,6 +38,7 @@ void DialSet::reset() {
   _owner_ = nullptr;
   _dataSetNameList_.clear();
   _dialList_.clear();
+  _splineDataArena_.clear();
   _config_ = nlohmann::json();
   _enableDialsSummary_ = false;
   _isEnabled_ = true;
@@ -132,6 +135,44 @@ std::string DialSet::getSummary() const {
 
   return ss.str();
 }
+void DialSet::packSplineData(bool releaseSplines_){
+#ifndef USE_TSPLINE3_EVAL
+  LogThrowIf(not _splineDataArena_.empty(), "Spline data already packed.");
+
+  size_t arenaSize{0};
+  for( auto& dial : _dialList_ ){
+    if( dial->getDialType() != DialType::Spline ) continue;
+    arenaSize += static_cast<SplineDial*>(dial.get())->getSplineDataSize();
+  }
+  if( arenaSize == 0 ) return;
+
+  // The dials of the same kind and data size are laid out next to each other: the spline groups of the
+  // EventDialCache evaluate them in place
+  std::vector<SplineDial*> splineDialList;
+  for( auto& dial : _dialList_ ){
+    if( dial->getDialType() != DialType::Spline ) continue;
+    auto* splineDialPtr = static_cast<SplineDial*>(dial.get());
+    if( splineDialPtr->getSplineDataSize() == 0 ) continue;
+    splineDialList.emplace_back(splineDialPtr);
+  }
+  std::stable_sort(splineDialList.begin(), splineDialList.end(), [](const SplineDial* a_, const SplineDial* b_){
+    if( a_->getSplineType() != b_->getSplineType() ){ return a_->getSplineType() < b_->getSplineType(); }
+    return a_->getSplineDataSize() < b_->getSplineDataSize();
+  });
+
+  // the dials refer to their data by offset: the arena must not be resized afterwards
+  _splineDataArena_.reserve(arenaSize);
+  for( auto* splineDialPtr : splineDialList ){
+    size_t offset{_splineDataArena_.size()};
+    _splineDataArena_.insert(
+        _splineDataArena_.end(), splineDialPtr->getSplineData(),
+        splineDialPtr->getSplineData() + splineDialPtr->getSplineDataSize()
+    );
+    splineDialPtr->setSplineDataArenaOffset(offset);
+    if( releaseSplines_ ){ splineDialPtr->releaseSpline(); }
+  }
+#endif
+}
 void DialSet::applyGlobalParameters(Dial* dial_) const {
   dial_->setOwner(this);
 }
@@ -335,6 +376,9 @@ bool DialSet::initializeDialsWithDefinition() {
     if     ( JsonUtils::doKeyExist(dialsDefinition, "dialLeafName") ){
       _globalDialLeafName_ = JsonUtils::fetchValue<std::string>(dialsDefinition, "dialLeafName");
       // nothing to do here, the dials list will be filled while reading the datasets
+      _deduplicateDials_ = JsonUtils::fetchValue(dialsDefinition, "deduplicateDials", _deduplicateDials_);
+      _dialDeduplicationTolerance_ = JsonUtils::fetchValue(dialsDefinition, "dialDeduplicationTolerance", _dialDeduplicationTolerance_);
+      LogThrowIf(_dialDeduplicationTolerance_ < 0, "Negative dial deduplication tolerance.");
     }
     else if( JsonUtils::doKeyExist(dialsDefinition, "binningFilePath") ){
 
@@ -32,6 +32,7 @@ void FitParameter::reset() {
   _isEnabled_ = true;
   _isFixed_ = false;
   _owner_ = nullptr;
+  _isDirty_ = true;
   _priorType_ = PriorType::Gaussian;
 }
 
@@ -66,7 +67,10 @@ void FitParameter::setName(const std::string &name) {
   _name_ = name;
 }
 void FitParameter::setParameterValue(double parameterValue) {
-  _parameterValue_ = parameterValue;
+  if( _parameterValue_ != parameterValue ){
+    _parameterValue_ = parameterValue;
+    _isDirty_ = true;
+  }
 }
 void FitParameter::setPriorValue(double priorValue) {
   _priorValue_ = priorValue;
@@ -100,7 +104,7 @@ void FitParameter::setPriorType(PriorType::PriorType priorType) {
 }
 
 void FitParameter::setValueAtPrior(){
-  _parameterValue_ = _priorValue_;
+  this->setParameterValue(_priorValue_);
 }
 void FitParameter::setCurrentValueAsPrior(){
   _priorValue_ = _parameterValue_;
@@ -264,6 +264,51 @@ double FitParameterSet::getPenaltyChi2() {
   return chi2;
 }
 
+std::vector<double> FitParameterSet::getPenaltyChi2Gradient(){
+  std::vector<double> out(this->getEffectiveParameterList().size(), 0);
+  if( not _isEnabled_ or _priorCovarianceMatrix_ == nullptr ){ return out; }
+
+  if( _useEigenDecompInFit_ ){
+    for( size_t iEigen = 0 ; iEigen < _eigenParameterList_.size() ; iEigen++ ){
+      const auto& eigenPar = _eigenParameterList_[iEigen];
+      if( eigenPar.isFixed() ) continue;
+      out[iEigen] = 2 * (eigenPar.getParameterValue() - eigenPar.getPriorValue()) / TMath::Sq(eigenPar.getStdDevValue());
+    }
+    return out;
+  }
+
+  // d(delta^T * C^-1 * delta) = (C^-1 + C^-1^T) * delta, same parameter selection as fillDeltaParameterList()
+  this->fillDeltaParameterList();
+  int nDelta{_deltaParameterList_->GetNrows()};
+  int iFit{0};
+  for( size_t iPar = 0 ; iPar < _parameterList_.size() ; iPar++ ){
+    const auto& par = _parameterList_[iPar];
+    if( not par.isEnabled() or par.isFixed() or par.isFree() ) continue;
+    for( int jFit = 0 ; jFit < nDelta ; jFit++ ){
+      out[iPar] += ( (*_inverseStrippedCovarianceMatrix_)[iFit][jFit] + (*_inverseStrippedCovarianceMatrix_)[jFit][iFit] )
+                   * (*_deltaParameterList_)[jFit];
+    }
+    iFit++;
+  }
+  return out;
+}
+std::vector<double> FitParameterSet::toEffectiveGradient(const std::vector<double>& gradient_) const{
+  if( not _useEigenDecompInFit_ ){ return gradient_; }
+
+  // original = eigenVectors * eigen, over the enabled and non-fixed parameters (see propagateEigenToOriginal())
+  std::vector<double> out(_eigenParameterList_.size(), 0);
+  int iOriginal{0};
+  for( size_t iPar = 0 ; iPar < _parameterList_.size() ; iPar++ ){
+    const auto& par = _parameterList_[iPar];
+    if( par.isFixed() or not par.isEnabled() ) continue;
+    for( size_t iEigen = 0 ; iEigen < out.size() ; iEigen++ ){
+      out[iEigen] += (*_eigenVectors_)[iOriginal][int(iEigen)] * gradient_[iPar];
+    }
+    iOriginal++;
+  }
+  return out;
+}
+
 // Parameter throw
 void FitParameterSet::moveFitParametersToPrior(){
   LogInfo << "Moving back fit parameters to their prior value in set: " << getName() << std::endl;
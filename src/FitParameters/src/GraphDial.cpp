@@ -7,6 +7,9 @@
 
 #include "GraphDial.h"
 #include "GlobalVariables.h"
+#include "CalculateGraph.h"
+
+#include "cmath"
 
 LoggerInit([]{
   Logger::setUserHeaderStr("[GraphDial]");
@@ -19,11 +22,13 @@ GraphDial::GraphDial() : Dial{DialType::Graph} {
 void GraphDial::reset() {
   this->Dial::reset();
   _graph_ = TGraph();
+  _graphData_.clear();
 }
 
 void GraphDial::initialize() {
   this->Dial::initialize();
   LogThrowIf( _graph_.GetN() == 0 )
+  this->fillGraphData();
 }
 
 std::string GraphDial::getSummary() {
@@ -39,9 +44,21 @@ std::string GraphDial::getSummary() {
 //  return _graph_.Eval(parameterValue_);
 //}
 double GraphDial::calcDial(double parameterValue_) {
-  if     (parameterValue_ <= _graph_.GetX()[0])                { return _graph_.GetY()[0]; }
-  else if(parameterValue_ >= _graph_.GetX()[_graph_.GetN()-1]) { return _graph_.GetY()[_graph_.GetN() - 1]; }
-  else{ return _graph_.Eval(parameterValue_); }
+  // Same as TGraph::Eval within the graph, and the end points outside
+  return CalculateGraph(parameterValue_, -1E20, 1E20, _graphData_.data(), int(_graphData_.size()));
+}
+
+double GraphDial::calcDialDerivative(double parameterValue_) {
+  // slope of the segment interpolated by calcDial(), flat outside of the graph
+  int nPoints{int(_graphData_.size()-2)/2};
+  const double* data{_graphData_.data()};
+  if( nPoints < 2 or parameterValue_ <= data[3] or parameterValue_ >= data[2+2*(nPoints-1)+1] ){ return 0; }
+  int iUp{1};
+  while( iUp < nPoints-1 and parameterValue_ >= data[2+2*iUp+1] ){ iUp++; }
+  double xLow{data[2+2*(iUp-1)+1]};
+  double xUp{data[2+2*iUp+1]};
+  if( xLow == xUp ){ return 0; }
+  return (data[2+2*iUp] - data[2+2*(iUp-1)]) / (xUp - xLow);
 }
 
 void GraphDial::setGraph(const TGraph &graph) {
@@ -51,3 +68,38 @@ void GraphDial::setGraph(const TGraph &graph) {
   _graph_.Sort();
 }
 
+
+void GraphDial::fillGraphData(){
+  int nPoints{_graph_.GetN()};
+  _graphData_.clear();
+  _graphData_.reserve(2 + 2*nPoints);
+  _graphData_.emplace_back(_graph_.GetX()[0]);
+
+  // The inverse step is only set if the points are uniformly spaced
+  double step{nPoints > 1 ? (_graph_.GetX()[nPoints-1] - _graph_.GetX()[0])/(nPoints-1.) : 0};
+  bool isUniform{step > 0};
+  for( int iPt = 0 ; iPt < nPoints and isUniform ; iPt++ ){
+    if( std::abs(_graph_.GetX()[iPt] - (_graph_.GetX()[0] + iPt*step)) > 1E-6*step ){ isUniform = false; }
+  }
+  _graphData_.emplace_back(isUniform ? 1./step : 0.);
+
+  for( int iPt = 0 ; iPt < nPoints ; iPt++ ){
+    _graphData_.emplace_back(_graph_.GetY()[iPt]);
+    _graphData_.emplace_back(_graph_.GetX()[iPt]);
+  }
+}
+
+bool GraphDial::isIdentityWithin(double xMin_, double xMax_) const{
+  // calcDial() interpolates between the points bracketing x, or returns an end point outside of the graph range
+  int n{_graph_.GetN()};
+  int iFirst{0};
+  while( iFirst+1 < n and _graph_.GetX()[iFirst+1] <= xMin_ ){ iFirst++; }
+  int iLast{n-1};
+  while( iLast > iFirst and _graph_.GetX()[iLast-1] >= xMax_ ){ iLast--; }
+
+  // a linear interpolation between two points at 1 is exactly 1
+  for( int iPt = iFirst ; iPt <= iLast ; iPt++ ){
+    if( _graph_.GetY()[iPt] != 1 ){ return false; }
+  }
+  return true;
+}
@@ -19,6 +19,16 @@ NormDial::NormDial() : Dial(DialType::Norm) {
 void NormDial::reset() { Dial::reset(); }
 void NormDial::initialize() { Dial::initialize(); }
 
-double NormDial::evalResponse(double parameterValue_){ return this->capDialResponse(this->calcDial(parameterValue_)); } // no cache
+double NormDial::evalResponse(double parameterValue_){ return this->capDialResponse(this->calcDial(this->getEffectiveDialParameter(parameterValue_))); } // no cache
+double NormDial::fillResponseCache(double parameterValue_){
+  _dialResponseCache_ = this->evalResponse(parameterValue_);
+  _dialParameterCache_ = parameterValue_;
+  return _dialResponseCache_;
+}
 double NormDial::calcDial(double parameterValue_){ return parameterValue_; }
-
+double NormDial::evalResponseDerivative(double parameterValue_){
+  double dialParameter{this->getEffectiveDialParameter(parameterValue_)};
+  if( _owner_->getMinDialResponse() == _owner_->getMinDialResponse() and dialParameter < _owner_->getMinDialResponse() ){ return 0; }
+  if( _owner_->getMaxDialResponse() == _owner_->getMaxDialResponse() and dialParameter > _owner_->getMaxDialResponse() ){ return 0; }
+  return this->getEffectiveDialParameterDerivative(parameterValue_);
+}
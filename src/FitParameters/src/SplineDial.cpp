@@ -4,6 +4,7 @@
 
 
 #include "FitParameter.h"
+#include "DialSet.h"
 #include "SplineDial.h"
 #ifndef USE_TSPLINE3_EVAL
 #include "CalculateMonotonicSpline.h"
@@ -15,6 +16,8 @@
 
 #include "TFile.h"
 
+#include "algorithm"
+
 LoggerInit([](){ Logger::setUserHeaderStr("[SplineDial]"); } );
 
 
@@ -24,35 +27,46 @@ SplineDial::SplineDial() : Dial(DialType::Spline) {
 
 void SplineDial::reset() {
   this->Dial::reset();
-  _spline_ = TSpline3();
+  _spline_ = nullptr;
+  _xMin_ = 0;
+  _xMax_ = 0;
+#ifndef USE_TSPLINE3_EVAL
+  _splineData_.clear();
+  _splineDataArenaOffset_ = std::numeric_limits<size_t>::max();
+  _splineDataSize_ = 0;
+#endif
 }
 
 void SplineDial::copySpline(const TSpline3* splinePtr_){
   // Don't check for override: when loading toy + mc data, these placeholders has to be filled up twice
 //  LogThrowIf(_spline_.GetXmin() != _spline_.GetXmax(), "Spline already set")
-  _spline_ = *splinePtr_;
+  _spline_ = std::make_shared<TSpline3>(*splinePtr_);
+  _xMin_ = _spline_->GetXmin();
+  _xMax_ = _spline_->GetXmax();
 }
 void SplineDial::createSpline(TGraph* grPtr_){
 //  LogThrowIf(_spline_.GetXmin() != _spline_.GetXmax(), "Spline already set")
-  _spline_ = TSpline3(grPtr_->GetName(), grPtr_);
+  _spline_ = std::make_shared<TSpline3>(grPtr_->GetName(), grPtr_);
+  _xMin_ = _spline_->GetXmin();
+  _xMax_ = _spline_->GetXmax();
 #ifdef ENABLE_SPLINE_DIAL_FAST_EVAL
-  fs.stepsize = (_spline_.GetXmax() - _spline_.GetXmin())/((double) grPtr_->GetN());
+  fs.stepsize = (_spline_->GetXmax() - _spline_->GetXmin())/((double) grPtr_->GetN());
 #endif
 }
 
 void SplineDial::initialize() {
   this->Dial::initialize();
-  LogThrowIf(_spline_.GetXmin() == _spline_.GetXmax(), "Spline is not valid.");
+  LogThrowIf(_spline_ == nullptr or _xMin_ == _xMax_, "Spline is not valid.");
 
   // check if prior is out of bounds:
   if(
-      this->getEffectiveDialParameter(_owner_->getOwner()->getPriorValue()) < _spline_.GetXmin()
-      or this->getEffectiveDialParameter(_owner_->getOwner()->getPriorValue())  > _spline_.GetXmax()
+      this->getEffectiveDialParameter(_owner_->getOwner()->getPriorValue()) < _xMin_
+      or this->getEffectiveDialParameter(_owner_->getOwner()->getPriorValue())  > _xMax_
   ){
     LogError << "Prior value of parameter \""
              << _owner_->getOwner()->getTitle()
              << "\" = " << this->getEffectiveDialParameter(_owner_->getOwner()->getPriorValue())
-        << " is out of the spline bounds: " <<  _spline_.GetXmin() << " < X < " << _spline_.GetXmax()
+        << " is out of the spline bounds: " <<  _xMin_ << " < X < " << _xMax_
     << std::endl;
     throw std::logic_error("Prior is out of the spline bounds.");
   }
@@ -76,33 +90,43 @@ std::string SplineDial::getSummary() {
   return ss.str();
 }
 const TSpline3* SplineDial::getSplinePtr() const {
-  return &_spline_;
+#ifndef USE_TSPLINE3_EVAL
+  if( _spline_ == nullptr ){ _spline_ = this->buildSplineFromData(); }
+#endif
+  return _spline_.get();
+}
+void SplineDial::releaseSpline(){
+#ifndef USE_TSPLINE3_EVAL
+  if( _splineType_ == SplineDial::ROOTSpline or this->getSplineDataSize() == 0 ) return; // still evaluated with TSpline3
+  _spline_ = nullptr;
+#endif
 }
 
 double SplineDial::calcDial(double parameterValue_) {
-  if     (parameterValue_ <= _spline_.GetXmin()) { parameterValue_ = _spline_.GetXmin(); }
-  else if(parameterValue_ >= _spline_.GetXmax()) { parameterValue_ = _spline_.GetXmax(); }
+  if     (parameterValue_ <= _xMin_) { parameterValue_ = _xMin_; }
+  else if(parameterValue_ >= _xMax_) { parameterValue_ = _xMax_; }
 #ifdef USE_TSPLINE3_EVAL
-  return _spline_.Eval(parameterValue_);
+  return _spline_->Eval(parameterValue_);
 #else
   double dialResponse{};
   if (_splineType_ == SplineDial::Uniform) {
       dialResponse = CalculateUniformSpline(
           parameterValue_, -1E20, 1E20,
-          _splineData_.data(), _splineData_.size());
+          this->getSplineData(), this->getSplineDataSize());
   }
   else if (_splineType_ == SplineDial::General) {
       dialResponse = CalculateGeneralSpline(
           parameterValue_, -1E20, 1E20,
-          _splineData_.data(), _splineData_.size());
+          this->getSplineData(), this->getSplineDataSize());
   }
   else if (_splineType_ == SplineDial::Monotonic) {
+      // the last argument is the number of knots
       dialResponse = CalculateMonotonicSpline(
           parameterValue_, -1E20, 1E20,
-          _splineData_.data(), _splineData_.size());
+          this->getSplineData(), this->getSplineDataSize()-2);
   }
   else if (_splineType_ == SplineDial::ROOTSpline) {
-      dialResponse = _spline_.Eval(parameterValue_);
+      dialResponse = _spline_->Eval(parameterValue_);
   }
   else {
       LogThrow("Must have a spline type defined");
@@ -112,7 +136,7 @@ double SplineDial::calcDial(double parameterValue_) {
   #ifdef SPLINE_DIAL_SLOW_VALIDATION
   #error Remove this to compile with validation.
   do {
-      double testVal = _spline_.Eval(parameterValue_);
+      double testVal = this->getSplinePtr()->Eval(parameterValue_);
       double avg = std::abs(testVal);
       if (avg < 1.0) avg = 1.0;
       double delta = std::abs(testVal-dialResponse)/avg;
@@ -132,28 +156,115 @@ double SplineDial::calcDial(double parameterValue_) {
   return dialResponse;
 #endif
 }
+double SplineDial::calcDialDerivative(double parameterValue_) {
+  // calcDial() is flat outside of the knots
+  if( parameterValue_ <= _xMin_ or parameterValue_ >= _xMax_ ){ return 0; }
+#ifdef USE_TSPLINE3_EVAL
+  return _spline_->Derivative(parameterValue_);
+#else
+  if( _splineType_ == SplineDial::ROOTSpline ){ return _spline_->Derivative(parameterValue_); }
+  if( _splineType_ != SplineDial::Uniform and _splineType_ != SplineDial::General ){
+    // Monotonic: the slopes are limited from the neighbouring knots
+    return this->Dial::calcDialDerivative(parameterValue_);
+  }
+
+  // Derivative of the Hermite segment used by CalculateUniformSpline / CalculateGeneralSpline
+  const double* data{this->getSplineData()};
+  int dim{this->getSplineDataSize()};
+  int stride{_splineType_ == SplineDial::Uniform ? 2 : 3};
+  double step, fx;
+  int ix{0};
+  if( _splineType_ == SplineDial::Uniform ){
+    step = data[1];
+    double xx{(parameterValue_ - data[0]) / step};
+    ix = int(xx);
+    if( ix < 0 ){ ix = 0; }
+    if( 2*ix+7 > dim ){ ix = (dim-2)/2 - 2; }
+    fx = xx - ix;
+  }
+  else{
+    int knotCount{(dim-2)/3};
+    for( int n = knotCount-1 ; n > 1 ; ){
+      int half{n/2};
+      ix = (parameterValue_ > data[2+3*(ix+half)+2]) ? ix+half : ix;
+      n -= half;
+    }
+    step = data[2+3*(ix+1)+2] - data[2+3*ix+2];
+    fx = (parameterValue_ - data[2+3*ix+2]) / step;
+  }
+
+  double p1{data[2+stride*ix]};
+  double m1{data[2+stride*ix+1]*step};
+  double p2{data[2+stride*(ix+1)]};
+  double m2{data[2+stride*(ix+1)+1]*step};
+
+  // d/dfx of p1 + (p2-p1)*(3fx^2-2fx^3) + m1*(fx^3-2fx^2+fx) + m2*(fx^3-fx^2)
+  double derivative{(p2-p1)*(6*fx - 6*fx*fx) + m1*(3*fx*fx - 4*fx + 1) + m2*(3*fx*fx - 2*fx)};
+  return derivative / step;
+#endif
+}
+
+bool SplineDial::isIdentityWithin(double xMin_, double xMax_) const{
+  // calcDial() clamps x within the knot range: only the knots bracketing [xMin_, xMax_] can be reached
+  auto* splinePtr = this->getSplinePtr();
+  int nKnots{splinePtr->GetNp()};
+  double x, y, b, c, d;
+  int iFirst{0};
+  while( iFirst+1 < nKnots ){ splinePtr->GetKnot(iFirst+1, x, y); if( x > xMin_ ){ break; } iFirst++; }
+  int iLast{nKnots-1};
+  while( iLast > iFirst ){ splinePtr->GetKnot(iLast-1, x, y); if( x < xMax_ ){ break; } iLast--; }
+
+  // the monotonic slopes are computed from the neighbouring knots
+  iFirst = std::max(0, iFirst - 2);
+  iLast = std::min(nKnots - 1, iLast + 2);
 
+  // A flat segment at 1 evaluates to exactly 1: y + dx*(b + dx*(c + dx*d)) for TSpline3, and
+  // p1 - p1*t + p2*t with zero slopes for the Calculate*Spline functions
+  for( int iKnot = iFirst ; iKnot <= iLast ; iKnot++ ){
+    splinePtr->GetCoeff(iKnot, x, y, b, c, d);
+    if( y != 1 or b != 0 or c != 0 or d != 0 ){ return false; }
+  }
+
+#ifndef USE_TSPLINE3_EVAL
+  // The evaluated data must agree
+  int stride{0};
+  if     ( _splineType_ == SplineDial::Uniform ){ stride = 2; }   // (y, slope)
+  else if( _splineType_ == SplineDial::General ){ stride = 3; }   // (y, slope, x)
+  else if( _splineType_ == SplineDial::Monotonic ){ stride = 1; } // y
+  if( stride != 0 and this->getSplineDataSize() == 2 + stride*nKnots ){
+    const double* data{this->getSplineData()};
+    for( int iKnot = iFirst ; iKnot <= iLast ; iKnot++ ){
+      if( data[2 + stride*iKnot] != 1 ){ return false; }
+      if( stride > 1 and data[2 + stride*iKnot + 1] != 0 ){ return false; }
+    }
+  }
+  else if( stride != 0 ){ return false; }
+#endif
+
+  return true;
+}
 void SplineDial::writeSpline(const std::string &fileName_) const{
   TFile* f;
   if(fileName_.empty()) f = TFile::Open(Form("badDial_%p.root", this), "RECREATE");
   else                  f = TFile::Open(fileName_.c_str(), "RECREATE");
 
-  f->WriteObject(&_spline_, _spline_.GetName());
+  auto* splinePtr = this->getSplinePtr();
+  f->WriteObject(splinePtr, splinePtr->GetName());
   f->Close();
 }
 #ifdef ENABLE_SPLINE_DIAL_FAST_EVAL
 void SplineDial::fastEval(){
     //Function takes a spline with equidistant knots and the number of steps
     //between knots to evaluate the spline at some position 'pos'.
-    fs.l = int((parameterValue_ - _spline_.GetXmin())
+    fs.l = int((parameterValue_ - _spline_->GetXmin())
                / fs.stepsize) + 1;
 
-    _spline_.GetCoeff(fs.l, fs.x, fs.y, fs.b, fs.c, fs.d);
+    _spline_->GetCoeff(fs.l, fs.x, fs.y, fs.b, fs.c, fs.d);
     fs.num = parameterValue_ - fs.x;
 
     if (fs.num < 0){
         fs.l -= 1;
-        _spline_.GetCoeff(fs.l, fs.x, fs.y, fs.b, fs.c, fs.d);
+        _spline_->GetCoeff(fs.l, fs.x, fs.y, fs.b, fs.c, fs.d);
         fs.num = parameterValue_ - fs.x;
     }
     _dialResponseCache_ = (fs.y + fs.num * fs.b + fs.num * fs.num * fs.c + fs.num * fs.num * fs.num * fs.d);
@@ -161,8 +272,19 @@ void SplineDial::fastEval(){
 #endif
 
 #ifndef USE_TSPLINE3_EVAL
-const std::vector<double>& SplineDial::getSplineData() const {
-  return _splineData_;
+const double* SplineDial::getSplineData() const {
+  if( _splineDataArenaOffset_ != std::numeric_limits<size_t>::max() ){
+    return _owner_->getSplineDataArena().data() + _splineDataArenaOffset_;
+  }
+  return _splineData_.data();
+}
+int SplineDial::getSplineDataSize() const {
+  return _splineDataSize_;
+}
+void SplineDial::setSplineDataArenaOffset(size_t splineDataArenaOffset_){
+  LogThrowIf(_splineDataArenaOffset_ != std::numeric_limits<size_t>::max(), "Spline data already packed.");
+  _splineDataArenaOffset_ = splineDataArenaOffset_;
+  std::vector<double>().swap(_splineData_);
 }
 SplineDial::Subtype SplineDial::getSplineType() const {
   return _splineType_;
@@ -172,15 +294,15 @@ void SplineDial::fillSplineData() {
     // Check if the spline has uniformly spaced knots.  There is a flag for
     // this is TSpline3, but it's not uniformly (or ever) filled correctly.
     bool uniform = true;
-    for (int i = 1; i < _spline_.GetNp()-1; ++i) {
+    for (int i = 1; i < _spline_->GetNp()-1; ++i) {
         double x;
         double y;
-        _spline_.GetKnot(i-1,x,y);
+        _spline_->GetKnot(i-1,x,y);
         double d1 = x;
-        _spline_.GetKnot(i,x,y);
+        _spline_->GetKnot(i,x,y);
         d1 = x - d1;
         double d2 = x;
-        _spline_.GetKnot(i+1,x,y);
+        _spline_->GetKnot(i+1,x,y);
         d2 = x - d2;
         if (std::abs((d1-d2)/(d1+d2)) > 1E-6) {
             uniform = false;
@@ -188,6 +310,10 @@ void SplineDial::fillSplineData() {
         }
     }
 
+    // the placeholders can be filled more than once (toy + mc data)
+    _splineData_.clear();
+    _splineDataArenaOffset_ = std::numeric_limits<size_t>::max();
+
     std::string subType = getOwner()->getDialSubType();
 
     do {
@@ -196,6 +322,8 @@ void SplineDial::fillSplineData() {
         fillNaturalSpline(uniform);
     } while(false);
 
+    _splineDataSize_ = int(_splineData_.size());
+
 }
 
 bool SplineDial::fillMonotonicSpline(bool uniformKnots) {
@@ -209,13 +337,13 @@ bool SplineDial::fillMonotonicSpline(bool uniformKnots) {
     _splineType_ = SplineDial::Monotonic;
 
     // Copy the spline data into local storage.
-    _splineData_.push_back(_spline_.GetXmin());
-    _splineData_.push_back((_spline_.GetXmax()-_spline_.GetXmin())
-                           /(_spline_.GetNp()-1.0));
-    for (int i = 0; i < _spline_.GetNp(); ++i) {
+    _splineData_.push_back(_spline_->GetXmin());
+    _splineData_.push_back((_spline_->GetXmax()-_spline_->GetXmin())
+                           /(_spline_->GetNp()-1.0));
+    for (int i = 0; i < _spline_->GetNp(); ++i) {
         double x;
         double y;
-        _spline_.GetKnot(i,x,y);
+        _spline_->GetKnot(i,x,y);
         _splineData_.push_back(y);
     }
     return true;
@@ -225,18 +353,47 @@ bool SplineDial::fillNaturalSpline(bool uniformKnots) {
     else _splineType_ = SplineDial::General;
 
     // Copy the spline data into local storage.
-    _splineData_.push_back(_spline_.GetXmin());
-    _splineData_.push_back((_spline_.GetXmax()-_spline_.GetXmin())
-                           /(_spline_.GetNp()-1.0));
-    for (int i = 0; i < _spline_.GetNp(); ++i) {
+    _splineData_.push_back(_spline_->GetXmin());
+    _splineData_.push_back((_spline_->GetXmax()-_spline_->GetXmin())
+                           /(_spline_->GetNp()-1.0));
+    for (int i = 0; i < _spline_->GetNp(); ++i) {
         double x;
         double y;
-        _spline_.GetKnot(i,x,y);
+        _spline_->GetKnot(i,x,y);
         _splineData_.push_back(y);
-         _splineData_.push_back(_spline_.Derivative(x));
+         _splineData_.push_back(_spline_->Derivative(x));
          if (_splineType_ == SplineDial::Uniform) continue;
         _splineData_.push_back(x);
     }
     return true;
 }
+std::shared_ptr<TSpline3> SplineDial::buildSplineFromData() const {
+    const double* data = this->getSplineData();
+    int dataSize = this->getSplineDataSize();
+    LogThrowIf(dataSize == 0, "No spline data to rebuild the spline from.");
+
+    int nKnots{0};
+    if      (_splineType_ == SplineDial::Uniform)   nKnots = (dataSize-2)/2;
+    else if (_splineType_ == SplineDial::General)   nKnots = (dataSize-2)/3;
+    else if (_splineType_ == SplineDial::Monotonic) nKnots = dataSize-2;
+    else LogThrow("Can't rebuild a spline of type " << _splineType_);
+
+    std::vector<double> xKnots(nKnots), yKnots(nKnots);
+    for (int i = 0; i < nKnots; ++i) {
+        if      (_splineType_ == SplineDial::Uniform)   { xKnots[i] = data[0] + i*data[1]; yKnots[i] = data[2+2*i]; }
+        else if (_splineType_ == SplineDial::General)   { xKnots[i] = data[2+3*i+2];       yKnots[i] = data[2+3*i]; }
+        else                                            { xKnots[i] = data[0] + i*data[1]; yKnots[i] = data[2+i]; }
+    }
+
+    if (_splineType_ == SplineDial::Monotonic) {
+        return std::make_shared<TSpline3>(Form("spline_%p", (void*) this), &xKnots[0], &yKnots[0], nKnots);
+    }
+
+    // the slopes at the end knots fully define the natural spline
+    int stride = (_splineType_ == SplineDial::Uniform ? 2 : 3);
+    return std::make_shared<TSpline3>(
+        Form("spline_%p", (void*) this), &xKnots[0], &yKnots[0], nKnots, "b1e1",
+        data[2+1], data[2+stride*(nKnots-1)+1]
+    );
+}
 #endif
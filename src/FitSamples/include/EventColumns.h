@@ -0,0 +1,105 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#ifndef GUNDAM_EVENTCOLUMNS_H
+#define GUNDAM_EVENTCOLUMNS_H
+
+#include "PhysicsEvent.h"
+#include "LeafColumns.h"
+#include "Dial.h"
+
+#include "vector"
+#include "string"
+#include "memory"
+
+
+/*
+ * \class EventColumns is a structure-of-arrays mirror of a std::vector<PhysicsEvent>
+ * The propagation hot loops only need a few numbers per event (weights, bin index, dials). Storing them as
+ * contiguous columns avoids walking over the full PhysicsEvent objects on every propagation.
+ * Once built, the PhysicsEvent objects are bound to the event weight column and to the LeafColumns: they release
+ * their own leaf storage, but their getters stay valid so the PlotGenerator, EventTreeWriter, etc. keep working
+ * untouched. A copy of the event list isn't bound to the weight column: call bindEvents() on it.
+ * */
+
+class EventColumns {
+
+public:
+  // Light read-only handle mimicking the PhysicsEvent getters
+  class EventView{
+  public:
+    EventView(const EventColumns* owner_, size_t index_): _owner_(owner_), _index_(index_) {}
+
+    size_t getIndex() const{ return _index_; }
+    double getTreeWeight() const;
+    double getEventWeight() const;
+    int getSampleBinIndex() const;
+    size_t getNbDials() const; // needs the dial ranges
+    Dial* getDial(size_t iDial_) const;
+
+    int findVarIndex(const std::string& leafName_, bool throwIfNotFound_ = true) const;
+    double getVarAsDouble(const std::string& leafName_, size_t arrayIndex_ = 0) const;
+    double getVarAsDouble(int varIndex_, size_t arrayIndex_ = 0) const;
+
+  private:
+    const EventColumns* _owner_;
+    size_t _index_;
+  };
+
+public:
+  EventColumns() = default;
+  virtual ~EventColumns() = default;
+
+  void clear();
+
+  // Init
+  // The dial ranges are only needed by reweight(): skip them when the EventDialCache handles the propagation.
+  void build(std::vector<PhysicsEvent>& eventList_, size_t nBins_, bool buildDialRanges_ = true);
+  void bindEvents(std::vector<PhysicsEvent>& eventList_); // binds the weight slots and the leaves of the events
+
+  // Getters
+  bool isBuilt() const{ return _isBuilt_; }
+  bool hasDialRanges() const{ return not _dialOffsetList_.empty(); }
+  size_t size() const{ return _treeWeightList_.size(); }
+  EventView getEvent(size_t iEvent_) const{ return {this, iEvent_}; }
+  const std::vector<StorageFloat>& getTreeWeightList() const{ return _treeWeightList_; }
+  const std::vector<double>& getEventWeightList() const{ return _eventWeightList_; }
+  const std::vector<int>& getSampleBinIndexList() const{ return _sampleBinIndexList_; }
+  const std::vector<size_t>& getDialOffsetList() const{ return _dialOffsetList_; }
+  const std::vector<Dial*>& getDialPtrList() const{ return _dialPtrList_; }
+  const std::shared_ptr<LeafColumns>& getLeafColumnsPtr() const{ return _leafColumnsPtr_; }
+
+  std::vector<double>& getEventWeightList(){ return _eventWeightList_; }
+
+  // Core
+  void reweight(size_t beginIndex_, size_t endIndex_);
+  double getBinContent(int iBin_) const;
+  size_t getBinNbEvents(int iBin_) const;
+
+  // Misc
+  size_t getMemoryUsage() const;
+
+private:
+  bool _isBuilt_{false};
+
+  // Per event columns (the other event fields are only read outside the propagation: see the PhysicsEvent)
+  std::vector<StorageFloat> _treeWeightList_{}; // float with WITH_FLOAT_STORAGE
+  std::vector<double> _eventWeightList_{};
+  std::vector<int> _sampleBinIndexList_{};
+
+  // Dial ranges: the dials of event i are _dialPtrList_[ _dialOffsetList_[i] : _dialOffsetList_[i+1] ], empty if not built
+  std::vector<size_t> _dialOffsetList_{};
+  std::vector<Dial*> _dialPtrList_{};
+
+  // Stored leaves, shared with the bound events
+  std::shared_ptr<LeafColumns> _leafColumnsPtr_{nullptr};
+
+  // Events of bin b are _binEventIndexList_[ _binOffsetList_[b] : _binOffsetList_[b+1] ]
+  std::vector<size_t> _binOffsetList_{};
+  std::vector<size_t> _binEventIndexList_{};
+
+};
+
+
+#endif //GUNDAM_EVENTCOLUMNS_H
@@ -30,6 +30,7 @@ public:
   void initialize();
 
   // Post init
+  void cacheLikelihoodDataTerms(); // to be called once the data histograms are locked
   void copyMcEventListToDataContainer();
   void clearMcContainers();
 
@@ -43,12 +44,19 @@ public:
   bool empty() const;
   double evalLikelihood() const;
   double evalLikelihood(const FitSample& sample_) const;
+  bool isLikelihoodDataCached() const{ return not _llhDataCacheList_.empty(); }
+  bool canEvalLikelihoodBinDerivatives() const; // every sample is evaluated in batch
+  // d(sample LLH)/d(MC bin content) and d(sample LLH)/d(MC bin sum of w^2) of the histogram bins 1..nBins
+  void evalLikelihoodBinDerivatives(size_t iSample_, double* dLlhdMc_, double* dLlhdMcSumw2_) const;
 
   // Parallel
   void updateSampleEventBinIndexes() const;
   void updateSampleBinEventList() const;
   void updateSampleHistograms() const;
 
+protected:
+  double evalSampleLikelihood(size_t iSample_) const;
+
 private:
   bool _isInitialized_{false};
   bool _showTimeStats_{false};
@@ -58,6 +66,17 @@ private:
   std::shared_ptr<JointProbability::JointProbability> _jointProbabilityPtr_{nullptr};
   std::vector<std::string> _eventByEventDialLeafList_;
 
+  // Batch LLH: flat copies of the locked data histograms with their data-only terms (empty lists: bin by bin eval)
+  struct LlhDataCache{
+    std::vector<double> dataList{};
+    std::vector<double> dataTermList{};
+  };
+  bool _useBatchLlhEval_{true};
+  bool _isParallelLlhEval_{false};
+  size_t _minBinsForParallelLlhEval_{1000};
+  std::vector<LlhDataCache> _llhDataCacheList_{};
+  mutable std::vector<double> _sampleLlhBufferList_{};
+
 };
 
 
@@ -7,16 +7,38 @@
 
 #include "FitSample.h"
 
+#include "cstddef"
 
 
 namespace JointProbability{
 
+  // Flat view of the bins of a sample: bins 1..nBins of the histograms (no under/overflow)
+  struct BinArrays{
+    size_t nBins{0};
+    const double* data{nullptr};     // data bin contents
+    const double* dataTerm{nullptr}; // data-only terms, filled once by fillDataTerms()
+    const double* mc{nullptr};       // MC bin contents
+    const double* mcSumw2{nullptr};  // MC sum of w^2 (GetBinError()^2)
+  };
+
   class JointProbability {
 
   public:
     JointProbability() = default;
     virtual ~JointProbability() = default;
 
+    // Batch interface: used once the data histograms are locked. evalBatch() must be thread safe
+    // and give the same result as the bin by bin eval().
+    virtual bool hasBatchEval() const{ return false; }
+    virtual void fillDataTerms(const double* data_, double* dataTerm_, size_t nBins_) const{
+      for( size_t iBin = 0 ; iBin < nBins_ ; iBin++ ){ dataTerm_[iBin] = 0; }
+    }
+    virtual double evalBatch(const BinArrays& bins_) const{ return 0; }
+
+    // Derivatives of evalBatch() wrt each MC bin content and MC sum of w^2 (analytic gradient of the fit)
+    virtual bool hasBatchDerivatives() const{ return false; }
+    virtual void evalBatchDerivatives(const BinArrays& bins_, double* dLlhdMc_, double* dLlhdMcSumw2_) const{}
+
     // two choices -> either override bin by bin llh or global eval function
     virtual double eval(const FitSample& sample_, int bin_){ return 0; }
     virtual double eval(const FitSample& sample_){
@@ -29,19 +51,36 @@ namespace JointProbability{
 
   class PoissonLLH : public JointProbability{
     double eval(const FitSample& sample_, int bin_) override;
+    bool hasBatchEval() const override{ return true; }
+    void fillDataTerms(const double* data_, double* dataTerm_, size_t nBins_) const override; // LnGamma(data+1)
+    double evalBatch(const BinArrays& bins_) const override;
+    bool hasBatchDerivatives() const override{ return true; }
+    void evalBatchDerivatives(const BinArrays& bins_, double* dLlhdMc_, double* dLlhdMcSumw2_) const override;
   };
 
   class BarlowLLH : public JointProbability{
     double eval(const FitSample& sample_, int bin_) override;
+    bool hasBatchEval() const override{ return true; }
+    double evalBatch(const BinArrays& bins_) const override;
+    bool hasBatchDerivatives() const override{ return true; }
+    void evalBatchDerivatives(const BinArrays& bins_, double* dLlhdMc_, double* dLlhdMcSumw2_) const override;
   private:
     double rel_var, b, c, beta, mc_hat, chi2;
   };
 
   class BarlowLLH_BANFF_OA2020 : public JointProbability{
     double eval(const FitSample& sample_, int bin_) override;
+    bool hasBatchEval() const override{ return true; }
+    double evalBatch(const BinArrays& bins_) const override;
+    bool hasBatchDerivatives() const override{ return true; }
+    void evalBatchDerivatives(const BinArrays& bins_, double* dLlhdMc_, double* dLlhdMcSumw2_) const override;
   };
   class BarlowLLH_BANFF_OA2021 : public JointProbability{
     double eval(const FitSample& sample_, int bin_) override;
+    bool hasBatchEval() const override{ return true; }
+    double evalBatch(const BinArrays& bins_) const override;
+    bool hasBatchDerivatives() const override{ return true; }
+    void evalBatchDerivatives(const BinArrays& bins_, double* dLlhdMc_, double* dLlhdMcSumw2_) const override;
   };
 
 }
@@ -0,0 +1,63 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#ifndef GUNDAM_LEAFCOLUMNS_H
+#define GUNDAM_LEAFCOLUMNS_H
+
+#include "GenericToolbox.AnyType.h"
+
+#include "vector"
+#include "string"
+#include "memory"
+#include "cstdint"
+
+class PhysicsEvent;
+
+
+/*
+ * \class LeafColumns holds the stored leaves of a list of events, one column per leaf, in their original ROOT type.
+ * Built by EventColumns: the PhysicsEvent objects then release their own leaf storage and read their variables from
+ * here. The events share it through a std::shared_ptr, so it stays valid for any copy of them.
+ * */
+
+class LeafColumns {
+
+public:
+  struct Column{
+    char typeTag{0};        // original ROOT leaf type: 'D', 'F', 'I', ...
+    size_t typeSize{0};     // bytes per value
+    size_t arraySize{1};    // max number of slots per event
+    std::vector<GenericToolbox::AnyType> prototype{}; // one value per slot, provides the type to fillLeafHolder()
+    std::vector<unsigned char> rawData{};             // [(iEvent*arraySize + iSlot)*typeSize], zero padded
+    std::vector<uint32_t> sizeList{};                 // number of slots of each event, empty if always arraySize
+  };
+
+public:
+  LeafColumns() = default;
+  virtual ~LeafColumns() = default;
+
+  // Init
+  void build(const std::vector<PhysicsEvent>& eventList_);
+
+  // Getters
+  size_t getNbLeaves() const{ return _columnList_.size(); }
+  const Column& getColumn(int iLeaf_) const{ return _columnList_[iLeaf_]; }
+  const std::shared_ptr<std::vector<std::string>>& getLeafNameListPtr() const{ return _leafNameListPtr_; }
+  size_t getArraySize(size_t iEvent_, int iLeaf_) const;
+
+  // Core
+  double getValueAsDouble(size_t iEvent_, int iLeaf_, size_t iSlot_ = 0) const;
+  void fillLeafHolder(size_t iEvent_, int iLeaf_, std::vector<GenericToolbox::AnyType>& leafHolder_) const;
+
+  // Misc
+  size_t getMemoryUsage() const;
+
+private:
+  std::shared_ptr<std::vector<std::string>> _leafNameListPtr_{nullptr};
+  std::vector<Column> _columnList_{};
+
+};
+
+
+#endif //GUNDAM_LEAFCOLUMNS_H
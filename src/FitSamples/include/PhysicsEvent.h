@@ -20,11 +20,19 @@
 #include "vector"
 #include "string"
 #include "map"
+#include "memory"
+
+class LeafColumns;
 
 class PhysicsEvent {
 
 public:
   PhysicsEvent();
+  // A copy is not bound to the weight column of the original: the owner of the copy has to rebind it
+  PhysicsEvent(const PhysicsEvent& other_);
+  PhysicsEvent(PhysicsEvent&&) = default; // the user-declared destructor would otherwise disable the moves
+  PhysicsEvent& operator=(const PhysicsEvent& other_);
+  PhysicsEvent& operator=(PhysicsEvent&&) = default;
   virtual ~PhysicsEvent();
 
   void reset();
@@ -38,6 +46,9 @@ public:
   void setFakeDataWeight(double fakeDataWeight);
   void setSampleBinIndex(int sampleBinIndex);
   void setCommonLeafNameListPtr(const std::shared_ptr<std::vector<std::string>>& commonLeafNameListPtr_);
+  void bindEventWeight(double* eventWeightSlotPtr_); // the event weight will be read/written at this address
+  // The leaves are read from row iEvent_ of the columns: the leaf storage of the event is released
+  void bindLeafColumns(const std::shared_ptr<const LeafColumns>& leafColumnsPtr_, size_t iEvent_);
 
   // GETTERS
   int getDataSetIndex() const;
@@ -49,8 +60,11 @@ public:
   int getSampleBinIndex() const;
   std::vector<Dial *> &getRawDialPtrList();
   const std::vector<Dial *> &getRawDialPtrList() const;
+  // These throw once the leaves are bound to LeafColumns: use getVarAsDouble() or the buffered getLeafHolder()
   const std::vector<GenericToolbox::AnyType>& getLeafHolder(const std::string &leafName_) const;
   const std::vector<GenericToolbox::AnyType>& getLeafHolder(int index_) const;
+  // Own holder of the leaf, or buffer_ (owned by the caller) filled from the LeafColumns once bound
+  const std::vector<GenericToolbox::AnyType>& getLeafHolder(int index_, std::vector<GenericToolbox::AnyType>& buffer_) const;
   const std::vector<std::vector<GenericToolbox::AnyType>> &getLeafContentList() const;
   const std::shared_ptr<std::vector<std::string>>& getCommonLeafNameListPtr() const;
 
@@ -104,10 +118,13 @@ private:
   double _nominalWeight_{1};
   double _eventWeight_{1};
   int _sampleBinIndex_{-1};
+  double* _eventWeightSlotPtr_{nullptr}; // set when the weight is held by an external column (EventColumns)
 
   // Data storage variables
   std::shared_ptr<std::vector<std::string>> _commonLeafNameListPtr_{nullptr};
   std::vector<std::vector<GenericToolbox::AnyType>> _leafContentList_;
+  std::shared_ptr<const LeafColumns> _leafColumnsPtr_{nullptr}; // set once the leaves are moved to columns
+  size_t _leafColumnsIndex_{0};
 
   // Cache variables
   std::vector<Dial*> _rawDialPtrList_{};
@@ -139,11 +156,12 @@ private:
 // TEMPLATES IMPLEMENTATION
 template<typename T> auto PhysicsEvent::getVarValue(const std::string &leafName_, size_t arrayIndex_) const -> T {
   int index = this->findVarIndex(leafName_, true);
+  if( _leafColumnsPtr_ != nullptr ){ return static_cast<T>(this->getVarAsDouble(index, arrayIndex_)); }
   return _leafContentList_[index][arrayIndex_].template getValue<T>();
 }
 template<typename T> auto PhysicsEvent::getVariable(const std::string& leafName_, size_t arrayIndex_) -> T&{
   int index = this->findVarIndex(leafName_, true);
-  return _leafContentList_[index][arrayIndex_].template getValue<T>();
+  return _leafContentList_.at(index).at(arrayIndex_).template getValue<T>(); // throws once the leaves are released
 }
 
 
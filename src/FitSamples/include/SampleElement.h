@@ -7,6 +7,7 @@
 
 #include "DataBinSet.h"
 #include "PhysicsEvent.h"
+#include "EventColumns.h"
 
 #include "TH1D.h"
 
@@ -26,6 +27,13 @@ public:
 
   // Events
   std::vector<PhysicsEvent> eventList;
+  EventColumns eventColumns; // optional columnar mirror of eventList used by the propagator
+
+  // Merged events: when mergeEquivalentEvents() has been called, eventList holds the merged events used by the
+  // propagation and the original events are kept in the cold store (plots, tree writing)
+  mutable std::vector<PhysicsEvent> coldEventList; // weights are derived from the merged events
+  std::vector<size_t> coldToMergedIndexList;
+  std::vector<double> mergedTreeWeight2List;      // sum of the squared tree weights of each merged event
 
   // Datasets
   std::vector<size_t> dataSetIndexList;
@@ -36,6 +44,10 @@ public:
   DataBinSet binning;
   std::shared_ptr<TH1D> histogram{nullptr};
   std::vector<std::vector<PhysicsEvent*>> perBinEventPtrList;
+  std::vector<size_t> binEventOffsetList; // when sorted by bin: events of bin b are eventList[ binEventOffsetList[b] : binEventOffsetList[b+1] ]
+  std::vector<std::vector<PhysicsEvent*>> perBinDynamicEventPtrList; // when partitioned: the non-static events
+  std::vector<double> staticBinContentList;                       // when partitioned: per-bin sum of the static events
+  std::vector<double> staticBinSumw2List;                         // when partitioned: per-bin sum of the static w^2
   double histScale{1};
   bool isLocked{false};
 
@@ -44,11 +56,24 @@ public:
   void shrinkEventList(size_t newTotalSize_);
   void updateEventBinIndexes(int iThread_ = -1);
   void updateBinEventList(int iThread_ = -1);
+  void sortEventsByBin();
+  void buildEventColumns(bool buildDialRanges_ = true);
+  void mergeEquivalentEvents();
+  void updateColdEventWeights() const;
+  void setEventPartition(const std::vector<char>& isStaticEventList_); // empty -> no partition
   void refillHistogram(int iThread_ = -1);
   void rescaleHistogram();
 
   void throwStatError();
 
+  bool isEventMerged() const{ return not coldEventList.empty(); }
+  bool isSortedByBin() const{ return not binEventOffsetList.empty(); }
+  bool isPartitioned() const{ return not staticBinContentList.empty(); }
+  // w^2 of a merged event is w^2 * sum(w_i^2)/(sum w_i)^2 of its original tree weights
+  double getSumw2Factor(size_t iEvent_, double treeWeight_) const{
+    return mergedTreeWeight2List.empty() ? 1. : mergedTreeWeight2List[iEvent_] / (treeWeight_ * treeWeight_);
+  }
+  const std::vector<PhysicsEvent>& getOriginalEventList() const{ return this->isEventMerged() ? coldEventList : eventList; }
   double getSumWeights() const;
   size_t getNbBinnedEvents() const;
 
@@ -57,6 +82,9 @@ public:
 
   bool debugTrigger{false};
 
+protected:
+  void fillBinEventOffsetList(); // eventList must be sorted by bin
+
 #ifdef GUNDAM_USING_CACHE_MANAGER
 public:
   void setCacheManagerIndex(int i) {_CacheManagerIndex_ = i;}
@@ -0,0 +1,152 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#include "EventColumns.h"
+
+#include "Logger.h"
+#include "GenericToolbox.h"
+#include "GenericToolbox.Root.h"
+
+#include <numeric>
+
+LoggerInit([]{ Logger::setUserHeaderStr("[EventColumns]"); });
+
+
+// EventView
+double EventColumns::EventView::getTreeWeight() const{ return _owner_->_treeWeightList_[_index_]; }
+double EventColumns::EventView::getEventWeight() const{ return _owner_->_eventWeightList_[_index_]; }
+int EventColumns::EventView::getSampleBinIndex() const{ return _owner_->_sampleBinIndexList_[_index_]; }
+size_t EventColumns::EventView::getNbDials() const{
+  LogThrowIf(not _owner_->hasDialRanges(), "The dial ranges haven't been built.");
+  return _owner_->_dialOffsetList_[_index_+1] - _owner_->_dialOffsetList_[_index_];
+}
+Dial* EventColumns::EventView::getDial(size_t iDial_) const{
+  return _owner_->_dialPtrList_[_owner_->_dialOffsetList_[_index_] + iDial_];
+}
+int EventColumns::EventView::findVarIndex(const std::string& leafName_, bool throwIfNotFound_) const{
+  LogThrowIf(_owner_->_leafColumnsPtr_ == nullptr or _owner_->_leafColumnsPtr_->getLeafNameListPtr() == nullptr,
+             "Can't " << __METHOD_NAME__ << " while no leaf is stored.");
+  const auto& leafNameList = *_owner_->_leafColumnsPtr_->getLeafNameListPtr();
+  int index = GenericToolbox::findElementIndex(leafName_, leafNameList);
+  LogThrowIf(index == -1 and throwIfNotFound_, leafName_ << " not found in: " << GenericToolbox::parseVectorAsString(leafNameList));
+  return index;
+}
+double EventColumns::EventView::getVarAsDouble(const std::string& leafName_, size_t arrayIndex_) const{
+  return this->getVarAsDouble(this->findVarIndex(leafName_, true), arrayIndex_);
+}
+double EventColumns::EventView::getVarAsDouble(int varIndex_, size_t arrayIndex_) const{
+  return _owner_->_leafColumnsPtr_->getValueAsDouble(_index_, varIndex_, arrayIndex_);
+}
+
+
+void EventColumns::clear(){
+  _isBuilt_ = false;
+  _treeWeightList_.clear();
+  _eventWeightList_.clear();
+  _sampleBinIndexList_.clear();
+  _dialOffsetList_.clear();
+  _dialPtrList_.clear();
+  _leafColumnsPtr_ = nullptr;
+  _binOffsetList_.clear();
+  _binEventIndexList_.clear();
+}
+
+void EventColumns::build(std::vector<PhysicsEvent>& eventList_, size_t nBins_, bool buildDialRanges_){
+  this->clear();
+
+  size_t nEvents{eventList_.size()};
+  _treeWeightList_.resize(nEvents);
+  _eventWeightList_.resize(nEvents);
+  _sampleBinIndexList_.resize(nEvents);
+  for( size_t iEvent = 0 ; iEvent < nEvents ; iEvent++ ){
+    auto& event = eventList_[iEvent];
+    _treeWeightList_[iEvent] = StorageFloat(event.getTreeWeight());
+    _eventWeightList_[iEvent] = event.getEventWeight();
+    _sampleBinIndexList_[iEvent] = event.getSampleBinIndex();
+  }
+
+  if( buildDialRanges_ ){
+    _dialOffsetList_.resize(nEvents+1, 0);
+    size_t nDials{0};
+    for( auto& event : eventList_ ){ nDials += event.getRawDialPtrList().size(); }
+    _dialPtrList_.reserve(nDials);
+    for( size_t iEvent = 0 ; iEvent < nEvents ; iEvent++ ){
+      for( auto* dialPtr : eventList_[iEvent].getRawDialPtrList() ){
+        if( dialPtr == nullptr ) break; // trimmed list
+        _dialPtrList_.emplace_back(dialPtr);
+      }
+      _dialOffsetList_[iEvent+1] = _dialPtrList_.size();
+    }
+    _dialPtrList_.shrink_to_fit();
+  }
+
+  // Leaves, in their original type
+  if( nEvents != 0 and eventList_[0].getCommonLeafNameListPtr() != nullptr ){
+    _leafColumnsPtr_ = std::make_shared<LeafColumns>();
+    _leafColumnsPtr_->build(eventList_);
+  }
+
+  // Bin -> events lookup (counting sort, O(nEvents))
+  _binOffsetList_.resize(nBins_+1, 0);
+  for( auto& binIndex : _sampleBinIndexList_ ){
+    if( binIndex >= 0 and binIndex < int(nBins_) ){ _binOffsetList_[binIndex+1]++; }
+  }
+  std::partial_sum(_binOffsetList_.begin(), _binOffsetList_.end(), _binOffsetList_.begin());
+  _binEventIndexList_.resize(_binOffsetList_.back());
+  std::vector<size_t> fillCursor(_binOffsetList_.begin(), _binOffsetList_.end()-1);
+  for( size_t iEvent = 0 ; iEvent < nEvents ; iEvent++ ){
+    int binIndex = _sampleBinIndexList_[iEvent];
+    if( binIndex >= 0 and binIndex < int(nBins_) ){ _binEventIndexList_[fillCursor[binIndex]++] = iEvent; }
+  }
+
+  _isBuilt_ = true;
+  this->bindEvents(eventList_);
+}
+void EventColumns::bindEvents(std::vector<PhysicsEvent>& eventList_){
+  LogThrowIf(not _isBuilt_, "Can't " << __METHOD_NAME__ << " before build().");
+  LogThrowIf(eventList_.size() != this->size(), "Event list size mismatch: " << eventList_.size() << " != " << this->size());
+
+  // From now on, the PhysicsEvent objects read their weight and their leaves from the columns
+  for( size_t iEvent = 0 ; iEvent < eventList_.size() ; iEvent++ ){
+    eventList_[iEvent].bindEventWeight(&_eventWeightList_[iEvent]);
+    if( _leafColumnsPtr_ != nullptr ){ eventList_[iEvent].bindLeafColumns(_leafColumnsPtr_, iEvent); }
+  }
+}
+
+void EventColumns::reweight(size_t beginIndex_, size_t endIndex_){
+  //! Warning: this is the hot loop of the propagation
+  LogThrowIf(not this->hasDialRanges(), "Can't " << __METHOD_NAME__ << ": the dial ranges haven't been built.");
+  const size_t* dialOffset = &_dialOffsetList_[beginIndex_];
+  Dial* const* dialPtrList = _dialPtrList_.data();
+  for( size_t iEvent = beginIndex_ ; iEvent < endIndex_ ; iEvent++, dialOffset++ ){
+    double weight = _treeWeightList_[iEvent];
+    for( size_t iDial = dialOffset[0] ; iDial < dialOffset[1] ; iDial++ ){
+      if( Dial::enableMaskCheck and dialPtrList[iDial]->isMasked() ){ continue; }
+      weight *= dialPtrList[iDial]->evalResponse();
+    }
+    _eventWeightList_[iEvent] = weight;
+  }
+}
+double EventColumns::getBinContent(int iBin_) const{
+  double content{0};
+  for( size_t iEntry = _binOffsetList_[iBin_] ; iEntry < _binOffsetList_[iBin_+1] ; iEntry++ ){
+    content += _eventWeightList_[_binEventIndexList_[iEntry]];
+  }
+  return content;
+}
+size_t EventColumns::getBinNbEvents(int iBin_) const{
+  return _binOffsetList_[iBin_+1] - _binOffsetList_[iBin_];
+}
+
+size_t EventColumns::getMemoryUsage() const{
+  size_t out{0};
+  out += _treeWeightList_.capacity() * sizeof(StorageFloat);
+  out += _eventWeightList_.capacity() * sizeof(double);
+  out += _sampleBinIndexList_.capacity() * sizeof(int);
+  out += _dialOffsetList_.capacity() * sizeof(size_t);
+  out += _dialPtrList_.capacity() * sizeof(Dial*);
+  if( _leafColumnsPtr_ != nullptr ){ out += _leafColumnsPtr_->getMemoryUsage(); }
+  out += (_binOffsetList_.capacity() + _binEventIndexList_.capacity()) * sizeof(size_t);
+  return out;
+}
@@ -15,6 +15,8 @@
 #include <TTreeFormulaManager.h>
 
 #include <memory>
+#include "cmath"
+#include "algorithm"
 
 
 LoggerInit([]{ Logger::setUserHeaderStr("[FitSampleSet]"); });
@@ -106,6 +108,17 @@ void FitSampleSet::initialize() {
   else if( llhMethod == "BarlowLLH_BANFF_OA2021" ) {  _jointProbabilityPtr_ = std::make_shared<JointProbability::BarlowLLH_BANFF_OA2021>(); }
   else{ LogThrow("Unknown LLH Method: " << llhMethod); }
 
+  _useBatchLlhEval_ = JsonUtils::fetchValue(_config_, "useBatchLlhEval", _useBatchLlhEval_);
+
+  // LLH of the samples, once the data terms are cached
+  std::function<void(int)> evalLikelihoodFct = [this](int iThread){
+    int nThreads = GlobalVariables::getNbThreads();
+    for( size_t iSample = iThread ; iSample < _fitSampleList_.size() ; iSample += nThreads ){
+      _sampleLlhBufferList_[iSample] = this->evalSampleLikelihood(iSample);
+    }
+  };
+  GlobalVariables::getParallelWorker().addJob("FitSampleSet::evalLikelihood", evalLikelihoodFct);
+
   _isInitialized_ = true;
 }
 
@@ -127,12 +140,108 @@ bool FitSampleSet::empty() const {
 }
 double FitSampleSet::evalLikelihood() const{
   double llh = 0.;
-  for( auto& sample : _fitSampleList_ ){ llh += this->evalLikelihood(sample); }
+  if( _llhDataCacheList_.empty() ){
+    for( auto& sample : _fitSampleList_ ){ llh += this->evalLikelihood(sample); }
+    return llh;
+  }
+
+  if( _isParallelLlhEval_ ){ GlobalVariables::getParallelWorker().runJob("FitSampleSet::evalLikelihood"); }
+  else{
+    for( size_t iSample = 0 ; iSample < _fitSampleList_.size() ; iSample++ ){
+      _sampleLlhBufferList_[iSample] = this->evalSampleLikelihood(iSample);
+    }
+  }
+  // summed in sample order: doesn't depend on the number of threads
+  for( auto& sampleLlh : _sampleLlhBufferList_ ){ llh += sampleLlh; }
   return llh;
 }
 double FitSampleSet::evalLikelihood(const FitSample& sample_) const{
+  if( not _llhDataCacheList_.empty()
+      and &sample_ >= &_fitSampleList_.front() and &sample_ <= &_fitSampleList_.back() ){
+    return this->evalSampleLikelihood(&sample_ - &_fitSampleList_.front());
+  }
   return _jointProbabilityPtr_->eval(sample_);
 }
+double FitSampleSet::evalSampleLikelihood(size_t iSample_) const{
+  auto& sample = _fitSampleList_[iSample_];
+  auto& dataCache = _llhDataCacheList_[iSample_];
+  if( dataCache.dataList.empty() ){ return _jointProbabilityPtr_->eval(sample); }
+
+  const auto* mcHist = sample.getMcContainer().histogram.get();
+  JointProbability::BinArrays bins;
+  bins.nBins = dataCache.dataList.size();
+  bins.data = dataCache.dataList.data();
+  bins.dataTerm = dataCache.dataTermList.data();
+  bins.mc = mcHist->GetArray() + 1;
+  bins.mcSumw2 = mcHist->GetSumw2()->GetArray() + 1;
+  return _jointProbabilityPtr_->evalBatch(bins);
+}
+
+bool FitSampleSet::canEvalLikelihoodBinDerivatives() const{
+  if( _llhDataCacheList_.empty() or not _jointProbabilityPtr_->hasBatchDerivatives() ) return false;
+  for( auto& dataCache : _llhDataCacheList_ ){ if( dataCache.dataList.empty() ) return false; }
+  return true;
+}
+void FitSampleSet::evalLikelihoodBinDerivatives(size_t iSample_, double* dLlhdMc_, double* dLlhdMcSumw2_) const{
+  auto& dataCache = _llhDataCacheList_.at(iSample_);
+  LogThrowIf(dataCache.dataList.empty(), "\"" << _fitSampleList_[iSample_].getName() << "\": data terms not cached.");
+
+  const auto* mcHist = _fitSampleList_[iSample_].getMcContainer().histogram.get();
+  JointProbability::BinArrays bins;
+  bins.nBins = dataCache.dataList.size();
+  bins.data = dataCache.dataList.data();
+  bins.dataTerm = dataCache.dataTermList.data();
+  bins.mc = mcHist->GetArray() + 1;
+  bins.mcSumw2 = mcHist->GetSumw2()->GetArray() + 1;
+  _jointProbabilityPtr_->evalBatchDerivatives(bins, dLlhdMc_, dLlhdMcSumw2_);
+}
+
+void FitSampleSet::cacheLikelihoodDataTerms(){
+  _llhDataCacheList_.clear();
+  _sampleLlhBufferList_.clear();
+  if( not _useBatchLlhEval_ or not _jointProbabilityPtr_->hasBatchEval() ){
+    LogInfo << "Samples LLH evaluated bin by bin." << std::endl;
+    return;
+  }
+
+  LogInfo << "Caching the data terms of the samples LLH..." << std::endl;
+  _llhDataCacheList_.resize(_fitSampleList_.size());
+  _sampleLlhBufferList_.resize(_fitSampleList_.size(), 0);
+  size_t nCachedBins{0};
+  for( size_t iSample = 0 ; iSample < _fitSampleList_.size() ; iSample++ ){
+    auto& sample = _fitSampleList_[iSample];
+    auto& dataCache = _llhDataCacheList_[iSample];
+    auto nBins = sample.getBinning().getBinsList().size();
+    const auto* dataHist = sample.getDataContainer().histogram.get();
+    const auto* mcHist = sample.getMcContainer().histogram.get();
+
+    if( not sample.getDataContainer().isLocked or nBins == 0
+        or dataHist == nullptr or dataHist->GetNbinsX() < int(nBins)
+        or mcHist == nullptr or mcHist->GetNbinsX() < int(nBins) or mcHist->GetSumw2N() == 0 ){
+      LogWarning << "\"" << sample.getName() << "\": LLH will be evaluated bin by bin." << std::endl;
+      continue;
+    }
+
+    dataCache.dataList.resize(nBins);
+    for( size_t iBin = 0 ; iBin < nBins ; iBin++ ){ dataCache.dataList[iBin] = dataHist->GetBinContent(int(iBin)+1); }
+    dataCache.dataTermList.resize(nBins);
+    _jointProbabilityPtr_->fillDataTerms(dataCache.dataList.data(), dataCache.dataTermList.data(), nBins);
+    nCachedBins += nBins;
+
+    // the batch eval has to give back the bin by bin LLH
+    double batchLlh{this->evalSampleLikelihood(iSample)};
+    double binByBinLlh{_jointProbabilityPtr_->eval(sample)};
+    LogThrowIf(
+        std::abs(batchLlh - binByBinLlh) > 1E-9 * std::max(1., std::abs(binByBinLlh)),
+        "\"" << sample.getName() << "\": batch LLH (" << batchLlh << ") doesn't match the bin by bin LLH (" << binByBinLlh << ")"
+    );
+  }
+
+  _isParallelLlhEval_ = GlobalVariables::getNbThreads() > 1 and _fitSampleList_.size() > 1
+      and nCachedBins >= _minBinsForParallelLlhEval_;
+  LogInfo << "Cached the data terms of " << nCachedBins << " bins. Samples LLH evaluated "
+          << (_isParallelLlhEval_ ? "in parallel." : "sequentially.") << std::endl;
+}
 
 void FitSampleSet::copyMcEventListToDataContainer(){
   for( auto& sample : _fitSampleList_ ){
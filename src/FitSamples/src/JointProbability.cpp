@@ -8,13 +8,157 @@
 
 #include "TMath.h"
 
+#include "cmath"
+
 
 LoggerInit([]{
   Logger::setUserHeaderStr("[JointProbability]");
 });
 
+namespace {
+  // Barlow-Beeston bin contribution of the BANFF flavours, same expressions as their bin by bin eval()
+  inline double evalBanffBin(double dataVal, double predVal, double mcuncert){
+    double chisq{0};
+
+    double fractional = sqrt(mcuncert)/predVal;
+    double temp = predVal*fractional*fractional-1;
+    double temp2 = temp*temp + 4*dataVal*fractional*fractional;
+
+    LogThrowIf(temp2 < 0, "Negative square root in Barlow Beeston coefficient calculation!");
+
+    double beta = (-1*temp+sqrt(temp2))/2.;
+    double newmc = predVal*beta;
+    double penalty = (beta-1)*(beta-1)/(2*fractional*fractional);
+    double stat = 0;
+    if (dataVal == 0) stat = newmc;
+    else if (newmc > 0) stat = newmc-dataVal+dataVal*TMath::Log(dataVal/newmc);
+
+    if( predVal > 0.0 ){ chisq += 2.0*(stat+penalty); }
+
+    if(std::isinf(chisq)){
+      LogAlert << "Infinite chi2 " << predVal << " " << dataVal
+               << mcuncert << " "
+               << predVal << std::endl;
+    }
+
+    return chisq;
+  }
+
+  // Derivatives of the Barlow-Beeston chi2: 2*(mc*beta - data + data*log(data/(mc*beta))) + (beta-1)^2/relVar, with
+  // relVar = sqrt(sumw2)/mc^2. beta minimizes the chi2, so its own variation drops out: only the explicit mc and relVar
+  // dependencies remain.
+  inline void evalBarlowBinDerivatives(double data_, double mc_, double sumw2_, bool hasStatTerm_, bool hasDataTerm_,
+                                       double& dMc_, double& dSumw2_){
+    double relVar = std::sqrt(sumw2_) / (mc_ * mc_);
+    double bCoef = mc_ * relVar - 1;
+    double beta = (-bCoef + std::sqrt(bCoef * bCoef + 4 * data_ * relVar)) / 2.;
+
+    dMc_ = 0;
+    if( hasStatTerm_ ){ dMc_ += 2 * beta; }
+    if( hasDataTerm_ ){ dMc_ -= 2 * data_ / mc_; }
+    dSumw2_ = 0;
+    if( relVar > 0 ){
+      // d(relVar)/d(mc) = -2*relVar/mc, d(relVar)/d(sumw2) = relVar/(2*sumw2)
+      dMc_ += 2 * (beta - 1) * (beta - 1) / (relVar * mc_);
+      dSumw2_ = -(beta - 1) * (beta - 1) / (2 * relVar * sumw2_);
+    }
+  }
+
+  // BANFF flavours: same chi2 as BarlowLLH for a positive prediction, 0 otherwise
+  inline void evalBanffBinDerivatives(double dataVal, double predVal, double sumw2, double& dMc, double& dSumw2){
+    if( predVal <= 0.0 ){ dMc = 0; dSumw2 = 0; return; }
+    double relVar = std::sqrt(sumw2) / (predVal * predVal);
+    double temp = predVal * relVar - 1;
+    double beta = (-1 * temp + sqrt(temp * temp + 4 * dataVal * relVar)) / 2.;
+    bool hasStatTerm = (dataVal == 0 or predVal * beta > 0);
+    evalBarlowBinDerivatives(dataVal, predVal, sumw2, hasStatTerm, hasStatTerm and dataVal != 0, dMc, dSumw2);
+  }
+}
+
 namespace JointProbability{
 
+  void PoissonLLH::fillDataTerms(const double* data_, double* dataTerm_, size_t nBins_) const{
+    for( size_t iBin = 0 ; iBin < nBins_ ; iBin++ ){ dataTerm_[iBin] = TMath::LnGamma(data_[iBin]+1.); }
+  }
+  double PoissonLLH::evalBatch(const BinArrays& bins_) const{
+    const double* __restrict__ data = bins_.data;
+    const double* __restrict__ dataTerm = bins_.dataTerm;
+    const double* __restrict__ mc = bins_.mc;
+
+    double out{0};
+    for( size_t iBin = 0 ; iBin < bins_.nBins ; iBin++ ){
+      if( mc[iBin] <= 0 ) continue;
+      out += - ( data[iBin] * TMath::Log(mc[iBin]) - mc[iBin] - dataTerm[iBin] );
+    }
+    return out;
+  }
+
+  void PoissonLLH::evalBatchDerivatives(const BinArrays& bins_, double* dLlhdMc_, double* dLlhdMcSumw2_) const{
+    for( size_t iBin = 0 ; iBin < bins_.nBins ; iBin++ ){
+      dLlhdMc_[iBin] = ( bins_.mc[iBin] <= 0 ) ? 0 : 1. - bins_.data[iBin] / bins_.mc[iBin];
+      dLlhdMcSumw2_[iBin] = 0;
+    }
+  }
+
+  double BarlowLLH::evalBatch(const BinArrays& bins_) const{
+    const double* __restrict__ data = bins_.data;
+    const double* __restrict__ mc = bins_.mc;
+    const double* __restrict__ mcSumw2 = bins_.mcSumw2;
+
+    double out{0};
+    for( size_t iBin = 0 ; iBin < bins_.nBins ; iBin++ ){
+      double relVar = std::sqrt(mcSumw2[iBin]) / TMath::Sq(mc[iBin]);
+      double bCoef  = (mc[iBin] * relVar) - 1;
+      double cCoef  = 4 * data[iBin] * relVar;
+
+      double betaBin  = (-bCoef + std::sqrt(bCoef * bCoef + cCoef)) / 2.0;
+      double mcHatBin = mc[iBin] * betaBin;
+
+      double chi2Bin;
+      if( data[iBin] <= 0.0 ){ chi2Bin = 2 * mcHatBin; }
+      else{
+        chi2Bin = 2 * (mcHatBin - data[iBin]);
+        chi2Bin += 2 * data[iBin] * std::log(data[iBin] / mcHatBin);
+      }
+      chi2Bin += (betaBin - 1) * (betaBin - 1) / relVar;
+      out += chi2Bin;
+    }
+    return out;
+  }
+
+  void BarlowLLH::evalBatchDerivatives(const BinArrays& bins_, double* dLlhdMc_, double* dLlhdMcSumw2_) const{
+    for( size_t iBin = 0 ; iBin < bins_.nBins ; iBin++ ){
+      evalBarlowBinDerivatives(bins_.data[iBin], bins_.mc[iBin], bins_.mcSumw2[iBin], true, bins_.data[iBin] > 0.0,
+                               dLlhdMc_[iBin], dLlhdMcSumw2_[iBin]);
+    }
+  }
+
+  double BarlowLLH_BANFF_OA2020::evalBatch(const BinArrays& bins_) const{
+    double out{0};
+    for( size_t iBin = 0 ; iBin < bins_.nBins ; iBin++ ){
+      out += evalBanffBin(bins_.data[iBin], bins_.mc[iBin], std::sqrt(bins_.mcSumw2[iBin]));
+    }
+    return out;
+  }
+  void BarlowLLH_BANFF_OA2020::evalBatchDerivatives(const BinArrays& bins_, double* dLlhdMc_, double* dLlhdMcSumw2_) const{
+    for( size_t iBin = 0 ; iBin < bins_.nBins ; iBin++ ){
+      evalBanffBinDerivatives(bins_.data[iBin], bins_.mc[iBin], bins_.mcSumw2[iBin], dLlhdMc_[iBin], dLlhdMcSumw2_[iBin]);
+    }
+  }
+  double BarlowLLH_BANFF_OA2021::evalBatch(const BinArrays& bins_) const{
+    // usePoissonLikelihood is off in eval(): same contribution as OA2020
+    double out{0};
+    for( size_t iBin = 0 ; iBin < bins_.nBins ; iBin++ ){
+      out += evalBanffBin(bins_.data[iBin], bins_.mc[iBin], std::sqrt(bins_.mcSumw2[iBin]));
+    }
+    return out;
+  }
+  void BarlowLLH_BANFF_OA2021::evalBatchDerivatives(const BinArrays& bins_, double* dLlhdMc_, double* dLlhdMcSumw2_) const{
+    for( size_t iBin = 0 ; iBin < bins_.nBins ; iBin++ ){
+      evalBanffBinDerivatives(bins_.data[iBin], bins_.mc[iBin], bins_.mcSumw2[iBin], dLlhdMc_[iBin], dLlhdMcSumw2_[iBin]);
+    }
+  }
+
   double PoissonLLH::eval(const FitSample& sample_, int bin_){
     if( sample_.getMcContainer().histogram->GetBinContent(bin_) <= 0 ) return 0;
     return - (
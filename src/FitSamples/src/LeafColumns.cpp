@@ -0,0 +1,124 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#include "LeafColumns.h"
+#include "PhysicsEvent.h"
+
+#include "Logger.h"
+#include "GenericToolbox.h"
+#include "GenericToolbox.Root.h"
+
+#include <cstring>
+#include <algorithm>
+
+LoggerInit([]{ Logger::setUserHeaderStr("[LeafColumns]"); });
+
+
+namespace {
+  // size of the native type of a ROOT leaf type tag, 0 if not supported
+  size_t getTypeSize(char typeTag_){
+    switch( typeTag_ ){
+      case 'D': return sizeof(double);
+      case 'F': return sizeof(float);
+      case 'L': case 'l': return sizeof(int64_t);
+      case 'I': case 'i': return sizeof(int32_t);
+      case 'S': case 's': return sizeof(int16_t);
+      case 'B': case 'b': return sizeof(int8_t);
+      case 'O': return sizeof(bool);
+      default: return 0;
+    }
+  }
+  template<typename T> double readAs(const unsigned char* address_){
+    T value; std::memcpy(&value, address_, sizeof(T)); return double(value);
+  }
+}
+
+
+void LeafColumns::build(const std::vector<PhysicsEvent>& eventList_){
+  _leafNameListPtr_ = nullptr;
+  _columnList_.clear();
+  if( eventList_.empty() or eventList_[0].getCommonLeafNameListPtr() == nullptr ) return;
+
+  size_t nEvents{eventList_.size()};
+  _leafNameListPtr_ = eventList_[0].getCommonLeafNameListPtr();
+  _columnList_.resize(_leafNameListPtr_->size());
+  for( size_t iLeaf = 0 ; iLeaf < _columnList_.size() ; iLeaf++ ){
+    auto& column = _columnList_[iLeaf];
+    const auto& firstLeafHolder = eventList_[0].getLeafHolder(int(iLeaf));
+    LogThrowIf(firstLeafHolder.empty(), (*_leafNameListPtr_)[iLeaf] << ": no value stored.");
+
+    column.typeTag = GenericToolbox::findOriginalVariableType(firstLeafHolder[0]);
+    column.typeSize = getTypeSize(column.typeTag);
+    LogThrowIf(column.typeSize == 0 or column.typeSize != firstLeafHolder[0].getPlaceHolderPtr()->getVariableSize(),
+               (*_leafNameListPtr_)[iLeaf] << ": unsupported leaf type \"" << column.typeTag << "\"");
+
+    bool isFixedSize{true};
+    column.arraySize = 1;
+    for( auto& event : eventList_ ){
+      const auto& leafHolder = event.getLeafHolder(int(iLeaf));
+      isFixedSize &= ( leafHolder.size() == firstLeafHolder.size() );
+      column.arraySize = std::max(column.arraySize, leafHolder.size());
+    }
+
+    column.prototype.assign(column.arraySize, firstLeafHolder[0]);
+    column.rawData.resize(nEvents*column.arraySize*column.typeSize, 0);
+    if( not isFixedSize ){ column.sizeList.resize(nEvents, 0); }
+    for( size_t iEvent = 0 ; iEvent < nEvents ; iEvent++ ){
+      const auto& leafHolder = eventList_[iEvent].getLeafHolder(int(iLeaf));
+      if( not isFixedSize ){ column.sizeList[iEvent] = uint32_t(leafHolder.size()); }
+      for( size_t iSlot = 0 ; iSlot < leafHolder.size() ; iSlot++ ){
+        std::memcpy(
+            &column.rawData[(iEvent*column.arraySize + iSlot)*column.typeSize],
+            leafHolder[iSlot].getPlaceHolderPtr()->getVariableAddress(), column.typeSize
+        );
+      }
+    }
+  }
+}
+
+size_t LeafColumns::getArraySize(size_t iEvent_, int iLeaf_) const{
+  const auto& column = _columnList_[iLeaf_];
+  return column.sizeList.empty() ? column.arraySize : column.sizeList[iEvent_];
+}
+
+double LeafColumns::getValueAsDouble(size_t iEvent_, int iLeaf_, size_t iSlot_) const{
+  const auto& column = _columnList_[iLeaf_];
+  const unsigned char* address{&column.rawData[(iEvent_*column.arraySize + iSlot_)*column.typeSize]};
+  switch( column.typeTag ){
+    case 'D': return readAs<double>(address);
+    case 'F': return readAs<float>(address);
+    case 'L': return readAs<int64_t>(address);
+    case 'l': return readAs<uint64_t>(address);
+    case 'I': return readAs<int32_t>(address);
+    case 'i': return readAs<uint32_t>(address);
+    case 'S': return readAs<int16_t>(address);
+    case 's': return readAs<uint16_t>(address);
+    case 'B': return readAs<int8_t>(address);
+    case 'b': return readAs<uint8_t>(address);
+    case 'O': return readAs<bool>(address);
+    default: break;
+  }
+  LogThrow("Invalid leaf type: " << column.typeTag);
+}
+void LeafColumns::fillLeafHolder(size_t iEvent_, int iLeaf_, std::vector<GenericToolbox::AnyType>& leafHolder_) const{
+  const auto& column = _columnList_[iLeaf_];
+  size_t nSlots{this->getArraySize(iEvent_, iLeaf_)};
+  leafHolder_.assign(column.prototype.begin(), column.prototype.begin() + long(nSlots));
+  for( size_t iSlot = 0 ; iSlot < nSlots ; iSlot++ ){
+    std::memcpy(
+        const_cast<void*>(leafHolder_[iSlot].getPlaceHolderPtr()->getVariableAddress()),
+        &column.rawData[(iEvent_*column.arraySize + iSlot)*column.typeSize], column.typeSize
+    );
+  }
+}
+
+size_t LeafColumns::getMemoryUsage() const{
+  size_t out{0};
+  for( auto& column : _columnList_ ){
+    out += column.rawData.capacity();
+    out += column.sizeList.capacity() * sizeof(uint32_t);
+    out += column.prototype.capacity() * sizeof(GenericToolbox::AnyType);
+  }
+  return out;
+}
@@ -3,6 +3,7 @@
 //
 
 #include "PhysicsEvent.h"
+#include "LeafColumns.h"
 #include "SplineDial.h"
 
 #include "GenericToolbox.Root.h"
@@ -15,11 +16,41 @@ LoggerInit([]{
 });
 
 PhysicsEvent::PhysicsEvent() { this->reset(); }
+PhysicsEvent::PhysicsEvent(const PhysicsEvent& other_) { *this = other_; }
 PhysicsEvent::~PhysicsEvent() { this->reset(); }
+PhysicsEvent& PhysicsEvent::operator=(const PhysicsEvent& other_){
+  if( this == &other_ ) return *this;
+  _dataSetIndex_ = other_._dataSetIndex_;
+  _entryIndex_ = other_._entryIndex_;
+  _treeWeight_ = other_._treeWeight_;
+  _nominalWeight_ = other_._nominalWeight_;
+  _eventWeight_ = other_.getEventWeight(); // might be held by a column
+  _sampleBinIndex_ = other_._sampleBinIndex_;
+  _eventWeightSlotPtr_ = nullptr; // the slot belongs to the original event
+
+  _commonLeafNameListPtr_ = other_._commonLeafNameListPtr_;
+  _leafContentList_ = other_._leafContentList_;
+  _leafColumnsPtr_ = other_._leafColumnsPtr_; // shared and read-only
+  _leafColumnsIndex_ = other_._leafColumnsIndex_;
+
+  _rawDialPtrList_ = other_._rawDialPtrList_;
+  _nestedDialRefList_ = other_._nestedDialRefList_;
+  _varToDoubleCache_ = other_._varToDoubleCache_;
+
+#ifdef GUNDAM_USING_CACHE_MANAGER
+  _CacheManagerIndex_ = other_._CacheManagerIndex_;
+  _CacheManagerValue_ = other_._CacheManagerValue_;
+  _CacheManagerValid_ = other_._CacheManagerValid_;
+  _CacheManagerUpdate_ = other_._CacheManagerUpdate_;
+#endif
+  return *this;
+}
 
 void PhysicsEvent::reset() {
   _commonLeafNameListPtr_ = nullptr;
   _leafContentList_.clear();
+  _leafColumnsPtr_ = nullptr;
+  _leafColumnsIndex_ = 0;
   _rawDialPtrList_.clear();
 
   // Weight carriers
@@ -29,6 +60,7 @@ void PhysicsEvent::reset() {
   _nominalWeight_ = 1;
   _eventWeight_ = 1;
   _sampleBinIndex_ = -1;
+  _eventWeightSlotPtr_ = nullptr;
 }
 
 void PhysicsEvent::setCommonLeafNameListPtr(const std::shared_ptr<std::vector<std::string>>& commonLeafNameListPtr_){
@@ -49,10 +81,23 @@ void PhysicsEvent::setNominalWeight(double nominalWeight) {
 }
 void PhysicsEvent::setEventWeight(double eventWeight) {
   _eventWeight_ = eventWeight;
+  if( _eventWeightSlotPtr_ != nullptr ){ *_eventWeightSlotPtr_ = eventWeight; }
 }
 void PhysicsEvent::setSampleBinIndex(int sampleBinIndex) {
   _sampleBinIndex_ = sampleBinIndex;
 }
+void PhysicsEvent::bindEventWeight(double* eventWeightSlotPtr_){
+  _eventWeightSlotPtr_ = eventWeightSlotPtr_;
+  if( _eventWeightSlotPtr_ != nullptr ){ *_eventWeightSlotPtr_ = _eventWeight_; }
+}
+void PhysicsEvent::bindLeafColumns(const std::shared_ptr<const LeafColumns>& leafColumnsPtr_, size_t iEvent_){
+  LogThrowIf(leafColumnsPtr_ == nullptr or leafColumnsPtr_->getLeafNameListPtr() != _commonLeafNameListPtr_,
+             "Leaf columns don't match the leaves of the event.");
+  _leafColumnsPtr_ = leafColumnsPtr_;
+  _leafColumnsIndex_ = iEvent_;
+  std::vector<std::vector<GenericToolbox::AnyType>>().swap(_leafContentList_);
+  std::vector<std::vector<double>>().swap(_varToDoubleCache_);
+}
 
 int PhysicsEvent::getDataSetIndex() const {
   return _dataSetIndex_;
@@ -123,6 +168,7 @@ double PhysicsEvent::getEventWeight() const {
         return *_CacheManagerValue_;
     }
 #endif
+    if( _eventWeightSlotPtr_ != nullptr ){ return *_eventWeightSlotPtr_; }
     return _eventWeight_;
 }
 int PhysicsEvent::getSampleBinIndex() const {
@@ -133,8 +179,14 @@ const std::vector<GenericToolbox::AnyType>& PhysicsEvent::getLeafHolder(const st
   return this->getLeafHolder(index);
 }
 const std::vector<GenericToolbox::AnyType>& PhysicsEvent::getLeafHolder(int index_) const{
+  LogThrowIf(_leafColumnsPtr_ != nullptr, "Can't " << __METHOD_NAME__ << " once the leaves are held by the event columns.")
   return _leafContentList_[index_];
 }
+const std::vector<GenericToolbox::AnyType>& PhysicsEvent::getLeafHolder(int index_, std::vector<GenericToolbox::AnyType>& buffer_) const{
+  if( _leafColumnsPtr_ == nullptr ){ return _leafContentList_[index_]; }
+  _leafColumnsPtr_->fillLeafHolder(_leafColumnsIndex_, index_, buffer_);
+  return buffer_;
+}
 const std::vector<std::vector<GenericToolbox::AnyType>> &PhysicsEvent::getLeafContentList() const {
   return _leafContentList_;
 }
@@ -150,16 +202,21 @@ const std::vector<Dial *> &PhysicsEvent::getRawDialPtrList() const{
 
 void PhysicsEvent::copyOnlyExistingLeaves(const PhysicsEvent& other_){
   LogThrowIf(_commonLeafNameListPtr_ == nullptr, "_commonLeafNameListPtr_ not set")
+  LogThrowIf(_leafColumnsPtr_ != nullptr, "Can't " << __METHOD_NAME__ << " once the leaves are held by the event columns.")
   for( size_t iLeaf = 0 ; iLeaf < _commonLeafNameListPtr_->size() ; iLeaf++ ){
-    _leafContentList_[iLeaf] = other_.getLeafHolder((*_commonLeafNameListPtr_)[iLeaf]);
+    // the holder of this event is the buffer: no temporary copy
+    int otherIndex = other_.findVarIndex((*_commonLeafNameListPtr_)[iLeaf], true);
+    const auto& otherLeafHolder = other_.getLeafHolder(otherIndex, _leafContentList_[iLeaf]);
+    if( &otherLeafHolder != &_leafContentList_[iLeaf] ){ _leafContentList_[iLeaf] = otherLeafHolder; }
   }
 }
 
 void PhysicsEvent::addEventWeight(double weight_){
-  _eventWeight_ *= weight_;
+  if( _eventWeightSlotPtr_ != nullptr ){ _eventWeight_ = *_eventWeightSlotPtr_; }
+  this->setEventWeight(_eventWeight_ * weight_);
 }
 void PhysicsEvent::resetEventWeight(){
-  _eventWeight_ = _treeWeight_;
+  this->setEventWeight(_treeWeight_);
 }
 void PhysicsEvent::reweightUsingDialCache(){
 
@@ -267,7 +324,7 @@ void PhysicsEvent::reweightUsingDialCache(){
   // bare dials
   _eventWeight_ = _treeWeight_;
   for( auto& dial : _rawDialPtrList_ ){
-    if( dial == nullptr ) return;
+    if( dial == nullptr ) break;
     if( Dial::enableMaskCheck and dial->isMasked() ){ continue; }
     _eventWeight_ *= dial->evalResponse();
 #ifdef CACHE_MANAGER_SLOW_VALIDATION
@@ -362,6 +419,7 @@ void PhysicsEvent::reweightUsingDialCache(){
     }
 #endif
   }
+  if( _eventWeightSlotPtr_ != nullptr ){ *_eventWeightSlotPtr_ = _eventWeight_; }
 
 //  // nested dials
 //  for( auto& nestedDialEntry : _nestedDialRefList_ ){
@@ -373,7 +431,7 @@ void PhysicsEvent::reweightUsingDialCache(){
 
 int PhysicsEvent::findVarIndex(const std::string& leafName_, bool throwIfNotFound_) const{
   LogThrowIf(_commonLeafNameListPtr_ == nullptr, "Can't " << __METHOD_NAME__ << " while _commonLeafNameListPtr_ is empty.");
-  for( size_t iLeaf = 0 ; iLeaf < _leafContentList_.size() ; iLeaf++ ){
+  for( size_t iLeaf = 0 ; iLeaf < _commonLeafNameListPtr_->size() ; iLeaf++ ){
     if( _commonLeafNameListPtr_->at(iLeaf) == leafName_ ){
       return int(iLeaf);
     }
@@ -389,13 +447,14 @@ int PhysicsEvent::findVarIndex(const std::string& leafName_, bool throwIfNotFoun
 }
 void* PhysicsEvent::getVariableAddress(const std::string& leafName_, size_t arrayIndex_){
   int index = this->findVarIndex(leafName_, true);
-  return _leafContentList_[index][arrayIndex_].getPlaceHolderPtr();
+  return _leafContentList_.at(index).at(arrayIndex_).getPlaceHolderPtr(); // throws once the leaves are released
 }
 double PhysicsEvent::getVarAsDouble(const std::string& leafName_, size_t arrayIndex_) const{
   int index = this->findVarIndex(leafName_, true);
   return this->getVarAsDouble(index, arrayIndex_);
 }
 double PhysicsEvent::getVarAsDouble(int varIndex_, size_t arrayIndex_) const{
+  if( _leafColumnsPtr_ != nullptr ) return _leafColumnsPtr_->getValueAsDouble(_leafColumnsIndex_, varIndex_, arrayIndex_);
   if( _varToDoubleCache_.empty() ) return _leafContentList_[varIndex_][arrayIndex_].getValueAsDouble();
   else{
     // if using double cache:
@@ -405,6 +464,7 @@ double PhysicsEvent::getVarAsDouble(int varIndex_, size_t arrayIndex_) const{
   }
 }
 const GenericToolbox::AnyType& PhysicsEvent::getVar(int varIndex_, size_t arrayIndex_) const{
+  LogThrowIf(_leafColumnsPtr_ != nullptr, "Can't " << __METHOD_NAME__ << " once the leaves are held by the event columns: use getVarAsDouble().")
   return _leafContentList_[varIndex_][arrayIndex_];
 }
 void PhysicsEvent::fillBuffer(const std::vector<int>& indexList_, std::vector<double>& buffer_) const{
@@ -436,7 +496,8 @@ std::string PhysicsEvent::getSummary() const {
   ss << std::endl << GET_VAR_NAME_VALUE(_eventWeight_);
   ss << std::endl << GET_VAR_NAME_VALUE(_sampleBinIndex_);
 
-  if( _leafContentList_.empty() ){ ss << std::endl << "LeafContent: { empty }"; }
+  if( _leafColumnsPtr_ != nullptr ){ ss << std::endl << "LeafContent: { held by LeafColumns, row " << _leafColumnsIndex_ << " }"; }
+  else if( _leafContentList_.empty() ){ ss << std::endl << "LeafContent: { empty }"; }
   else{
     ss << std::endl << "_leafContentList_ = { ";
     for( size_t iLeaf = 0 ; iLeaf < _leafContentList_.size() ; iLeaf++ ){
@@ -505,9 +566,10 @@ void PhysicsEvent::addNestedDialRefToCache(NestedDialTest* nestedDialPtr_, const
 std::map<std::string, std::function<void(GenericToolbox::RawDataArray&, const std::vector<GenericToolbox::AnyType>&)>> PhysicsEvent::generateLeavesDictionary(bool disableArrays_) const{
   std::map<std::string, std::function<void(GenericToolbox::RawDataArray&, const std::vector<GenericToolbox::AnyType>&)>> out;
 
+  std::vector<GenericToolbox::AnyType> leafHolderBuffer;
   for( auto& leafName : *_commonLeafNameListPtr_ ){
 
-    const auto& lH = this->getLeafHolder(leafName);
+    const auto& lH = this->getLeafHolder(this->findVarIndex(leafName, true), leafHolderBuffer);
     char typeTag = GenericToolbox::findOriginalVariableType(lH[0]);
     LogThrowIf( typeTag == 0 or typeTag == char(0xFF), leafName << " has an invalid leaf type." )
 
@@ -566,6 +628,11 @@ std::vector<std::pair<const GenericToolbox::LeafHolder*, int>> PhysicsEvent::gen
 }
 void PhysicsEvent::copyLeafContent(const PhysicsEvent& ref_){
   LogThrowIf(ref_.getCommonLeafNameListPtr() != _commonLeafNameListPtr_, "source event don't have the same leaf name list")
+  if( ref_._leafColumnsPtr_ != nullptr ){
+    _leafContentList_.resize(_commonLeafNameListPtr_->size());
+    for( size_t iLeaf = 0 ; iLeaf < _leafContentList_.size() ; iLeaf++ ){ ref_.getLeafHolder(int(iLeaf), _leafContentList_[iLeaf]); }
+    return;
+  }
   _leafContentList_ = ref_.getLeafContentList();
 //  for( size_t iLeaf = 0 ; iLeaf < _commonLeafNameListPtr_->size() ; iLeaf++ ){
 //    _leafContentList_[iLeaf] = ref_.getLeafContentList()[iLeaf];
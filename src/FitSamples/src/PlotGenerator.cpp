@@ -89,7 +89,7 @@ void PlotGenerator::defineHistogramHolders() {
       for( const auto& sample : _fitSampleSetPtr_->getFitSampleList() ){
         iSample++;
         if( iSample % GlobalVariables::getNbThreads() != iThread_ ){ continue; }
-        for( const auto& event : sample.getMcContainer().eventList ){
+        for( const auto& event : sample.getMcContainer().getOriginalEventList() ){
           for( auto& splitVarInstance: splitVarsDictionary ){
             if(splitVarInstance.first.empty()) continue;
             int splitValue = event.getVarValue<int>(splitVarInstance.first);
@@ -378,7 +378,8 @@ void PlotGenerator::generateSampleHistograms(TDirectory *saveDir_, int cacheSlot
           }
         }
         else{
-          eventListPtr = &sample.getMcContainer().eventList;
+          eventListPtr = &sample.getMcContainer().getOriginalEventList();
+          sample.getMcContainer().updateColdEventWeights();
 
           // which hist should be filled?
           for( auto& histDef : _histHolderCacheList_[cacheSlot_] ){
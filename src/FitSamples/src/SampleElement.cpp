@@ -10,6 +10,10 @@
 
 #include "TRandom.h"
 
+#include "map"
+#include "algorithm"
+#include "numeric"
+
 
 LoggerInit([]{ Logger::setUserHeaderStr("[SampleElement]"); });
 
@@ -41,9 +45,28 @@ void SampleElement::updateEventBinIndexes(int iThread_){
   int nBins = int(binning.getBinsList().size());
   if(iThread_ <= 0) LogInfo << "Finding bin indexes for \"" << name << "\"..." << std::endl;
   int toDelete = 0;
+
+  // the event variables of the binning are looked up once per leaf list (i.e. per dataset)
+  const std::vector<std::string>* leafNameListPtr{nullptr};
+  std::vector<int> varIndexList;
+  std::vector<double> valueList(binning.getBinVariables().size(), 0);
+
   for( size_t iEvent = 0 ; iEvent < eventList.size() ; iEvent++ ){
     if( iThread_ != -1 and iEvent % GlobalVariables::getNbThreads() != iThread_ ) continue;
     auto& event = eventList.at(iEvent);
+
+    if( binning.isSearchIndexBuilt() ){
+      if( event.getCommonLeafNameListPtr().get() != leafNameListPtr ){
+        leafNameListPtr = event.getCommonLeafNameListPtr().get();
+        varIndexList.clear();
+        for( auto& varName : binning.getBinVariables() ){ varIndexList.emplace_back(event.findVarIndex(varName)); }
+      }
+      for( size_t iVar = 0 ; iVar < varIndexList.size() ; iVar++ ){ valueList[iVar] = event.getVarAsDouble(varIndexList[iVar]); }
+      event.setSampleBinIndex(binning.findBin(valueList));
+      if( event.getSampleBinIndex() == -1 ){ toDelete++; }
+      continue;
+    }
+
     for( int iBin = 0 ; iBin < nBins ; iBin++ ){
       auto& bin = binning.getBinsList().at(iBin);
       bool isInBin = true;
@@ -79,6 +102,18 @@ void SampleElement::updateBinEventList(int iThread_) {
   }
 
   int iBin = iThread_;
+  if( isSortedByBin() ){
+    // contiguous ranges: O(nEvents)
+    while( iBin < nBins ){
+      perBinEventPtrList[iBin].resize(binEventOffsetList[iBin+1] - binEventOffsetList[iBin], nullptr);
+      for( size_t iEvent = binEventOffsetList[iBin] ; iEvent < binEventOffsetList[iBin+1] ; iEvent++ ){
+        perBinEventPtrList[iBin][iEvent - binEventOffsetList[iBin]] = &eventList[iEvent];
+      }
+      iBin += nbThreads;
+    }
+    return;
+  }
+
   size_t count;
   while( iBin < nBins ){
     count = std::count_if(eventList.begin(), eventList.end(), [&](auto& e) {return e.getSampleBinIndex() == iBin;});
@@ -91,6 +126,155 @@ void SampleElement::updateBinEventList(int iThread_) {
     iBin += nbThreads;
   }
 }
+void SampleElement::sortEventsByBin(){
+  LogThrowIf(isLocked, "Can't " << __METHOD_NAME__ << " while locked");
+  LogThrowIf(eventColumns.isBuilt(), "Can't " << __METHOD_NAME__ << " once the event columns are built.");
+  LogInfo << "Sorting events of \"" << name << "\" by bin..." << std::endl;
+
+  // Counting sort, stable: unbinned events (-1) are moved at the end
+  size_t nBins{binning.getBinsList().size()};
+  auto getSlot = [&](const PhysicsEvent& event_){
+    int iBin = event_.getSampleBinIndex();
+    return ( iBin >= 0 and iBin < int(nBins) ) ? size_t(iBin) : nBins;
+  };
+  std::vector<size_t> slotOffsetList(nBins+2, 0);
+  for( auto& event : eventList ){ slotOffsetList[getSlot(event)+1]++; }
+  std::partial_sum(slotOffsetList.begin(), slotOffsetList.end(), slotOffsetList.begin());
+
+  std::vector<PhysicsEvent> sortedEventList(eventList.size());
+  std::vector<size_t> fillCursor(slotOffsetList.begin(), slotOffsetList.end()-1);
+  for( auto& event : eventList ){ sortedEventList[fillCursor[getSlot(event)]++] = std::move(event); }
+  eventList = std::move(sortedEventList);
+
+  // datasets are now interleaved: their ranges are not valid anymore
+  dataSetIndexList.clear();
+  eventOffSetList.clear();
+  eventNbList.clear();
+
+  this->fillBinEventOffsetList();
+}
+void SampleElement::fillBinEventOffsetList(){
+  size_t nBins{binning.getBinsList().size()};
+  binEventOffsetList.assign(nBins+1, 0);
+  for( auto& event : eventList ){
+    int iBin = event.getSampleBinIndex();
+    if( iBin >= 0 and iBin < int(nBins) ){ binEventOffsetList[iBin+1]++; }
+  }
+  std::partial_sum(binEventOffsetList.begin(), binEventOffsetList.end(), binEventOffsetList.begin());
+
+  for( size_t iBin = 0 ; iBin < nBins ; iBin++ ){
+    for( size_t iEvent = binEventOffsetList[iBin] ; iEvent < binEventOffsetList[iBin+1] ; iEvent++ ){
+      LogThrowIf(eventList[iEvent].getSampleBinIndex() != int(iBin), "Events of \"" << name << "\" are not sorted by bin.");
+    }
+  }
+}
+void SampleElement::buildEventColumns(bool buildDialRanges_){
+  LogThrowIf(isLocked, "Can't " << __METHOD_NAME__ << " while locked");
+  LogInfo << "Building columnar event store for \"" << name << "\"..." << std::endl;
+  eventColumns.build(eventList, binning.getBinsList().size(), buildDialRanges_);
+  LogInfo << "-> " << eventColumns.size() << " events stored in "
+  << GenericToolbox::parseSizeUnits(double(eventColumns.getMemoryUsage())) << std::endl;
+}
+void SampleElement::mergeEquivalentEvents(){
+  LogThrowIf(isLocked, "Can't " << __METHOD_NAME__ << " while locked");
+  LogThrowIf(isEventMerged(), "Events of \"" << name << "\" have already been merged.");
+  LogThrowIf(eventColumns.isBuilt(), "Can't " << __METHOD_NAME__ << " once the event columns are built.");
+
+  // Events sharing the dataset, the bin and the exact same dials are interchangeable for the propagation:
+  // sum_i( w_i * prod(dials) ) = (sum_i w_i) * prod(dials)
+  // event-by-event dials are never shared, so these events are naturally kept apart
+  std::map<std::pair<std::pair<int, int>, std::vector<Dial*>>, size_t> mergedIndexDict;
+  std::vector<PhysicsEvent> mergedEventList;
+  std::vector<double> mergedTreeWeight2;
+  coldToMergedIndexList.resize(eventList.size());
+
+  std::vector<Dial*> dialKey;
+  for( size_t iEvent = 0 ; iEvent < eventList.size() ; iEvent++ ){
+    auto& event = eventList[iEvent];
+
+    // the cold weights are rebuilt with the merged event weight/tree weight ratio: needs a positive tree weight
+    bool isMergeable = event.getTreeWeight() > 0;
+
+    dialKey.clear();
+    for( auto* dialPtr : event.getRawDialPtrList() ){
+      if( dialPtr == nullptr ) break; // trimmed list
+      dialKey.emplace_back(dialPtr);
+    }
+    std::sort(dialKey.begin(), dialKey.end());
+
+    auto key = std::make_pair(std::make_pair(event.getDataSetIndex(), event.getSampleBinIndex()), dialKey);
+    auto it = mergedIndexDict.end();
+    if( isMergeable ){ it = mergedIndexDict.find(key); }
+
+    if( it == mergedIndexDict.end() ){
+      if( isMergeable ){ mergedIndexDict.emplace(key, mergedEventList.size()); }
+      coldToMergedIndexList[iEvent] = mergedEventList.size();
+      mergedEventList.emplace_back(event);
+      mergedTreeWeight2.emplace_back(event.getTreeWeight()*event.getTreeWeight());
+      continue;
+    }
+
+    auto& mergedEvent = mergedEventList[it->second];
+    mergedEvent.setTreeWeight(mergedEvent.getTreeWeight() + event.getTreeWeight());
+    mergedEvent.setNominalWeight(mergedEvent.getNominalWeight() + event.getNominalWeight());
+    mergedEvent.setEventWeight(mergedEvent.getEventWeight() + event.getEventWeight());
+    mergedTreeWeight2[it->second] += event.getTreeWeight()*event.getTreeWeight();
+    coldToMergedIndexList[iEvent] = it->second;
+  }
+
+  LogInfo << "\"" << name << "\": " << eventList.size() << " events merged into " << mergedEventList.size()
+  << " (x" << (mergedEventList.empty() ? 0. : double(eventList.size())/double(mergedEventList.size())) << ")" << std::endl;
+
+  // the original events go to the cold store
+  coldEventList = std::move(eventList);
+  eventList = std::move(mergedEventList);
+  mergedTreeWeight2List = std::move(mergedTreeWeight2);
+
+  // the first occurrence order is preserved: still sorted by bin
+  if( isSortedByBin() ){ this->fillBinEventOffsetList(); }
+
+  // datasets are kept contiguous since the first occurrence order is preserved
+  for( size_t iDataSet = 0 ; iDataSet < dataSetIndexList.size() ; iDataSet++ ){
+    size_t coldBegin{eventOffSetList[iDataSet]};
+    size_t coldEnd{coldBegin + eventNbList[iDataSet]};
+    eventOffSetList[iDataSet] = (iDataSet == 0 ? 0 : eventOffSetList[iDataSet-1] + eventNbList[iDataSet-1]);
+    eventNbList[iDataSet] = 0;
+    for( size_t iCold = coldBegin ; iCold < coldEnd ; iCold++ ){
+      eventNbList[iDataSet] = std::max(eventNbList[iDataSet], coldToMergedIndexList[iCold] + 1 - eventOffSetList[iDataSet]);
+    }
+  }
+}
+void SampleElement::updateColdEventWeights() const{
+  if( not isEventMerged() ) return;
+  for( size_t iCold = 0 ; iCold < coldEventList.size() ; iCold++ ){
+    auto& mergedEvent = eventList[coldToMergedIndexList[iCold]];
+    coldEventList[iCold].setEventWeight(
+        coldEventList[iCold].getTreeWeight() * mergedEvent.getEventWeight() / mergedEvent.getTreeWeight()
+        );
+  }
+}
+void SampleElement::setEventPartition(const std::vector<char>& isStaticEventList_){
+  staticBinContentList.clear();
+  staticBinSumw2List.clear();
+  perBinDynamicEventPtrList.clear();
+  if( isStaticEventList_.empty() ) return;
+  LogThrowIf(isStaticEventList_.size() != eventList.size(), "Partition size mismatch for \"" << name << "\".");
+
+  // the static weights are frozen from now on
+  staticBinContentList.resize(perBinEventPtrList.size(), 0);
+  staticBinSumw2List.resize(perBinEventPtrList.size(), 0);
+  perBinDynamicEventPtrList.resize(perBinEventPtrList.size());
+  for( size_t iEvent = 0 ; iEvent < eventList.size() ; iEvent++ ){
+    int iBin = eventList[iEvent].getSampleBinIndex();
+    if( iBin < 0 or iBin >= int(perBinEventPtrList.size()) ) continue;
+    if( isStaticEventList_[iEvent] ){
+      double weight = eventList[iEvent].getEventWeight();
+      staticBinContentList[iBin] += weight;
+      staticBinSumw2List[iBin] += weight * weight * getSumw2Factor(iEvent, eventList[iEvent].getTreeWeight());
+    }
+    else{ perBinDynamicEventPtrList[iBin].emplace_back(&eventList[iEvent]); }
+  }
+}
 void SampleElement::refillHistogram(int iThread_){
   if( isLocked ) return;
 
@@ -153,6 +337,37 @@ void SampleElement::refillHistogram(int iThread_){
   int nBins = int(perBinEventPtrList.size());
   auto* binContentArray = histogram->GetArray();
   auto* binErrorArray = histogram->GetSumw2()->GetArray();
+  if( isPartitioned() ){
+    while( iBin < nBins ) {
+      binContentArray[iBin + 1] = staticBinContentList[iBin];
+      for (auto *eventPtr: perBinDynamicEventPtrList[iBin]) {
+        binContentArray[iBin + 1] += eventPtr->getEventWeight();
+      }
+      binErrorArray[iBin + 1] = binContentArray[iBin + 1];
+      iBin += nbThreads;
+    }
+    return;
+  }
+  if( isSortedByBin() and not eventColumns.isBuilt() ){
+    // sequential sum over a contiguous range
+    while( iBin < nBins ) {
+      binContentArray[iBin + 1] = 0;
+      for( size_t iEvent = binEventOffsetList[iBin] ; iEvent < binEventOffsetList[iBin+1] ; iEvent++ ){
+        binContentArray[iBin + 1] += eventList[iEvent].getEventWeight();
+      }
+      binErrorArray[iBin + 1] = binContentArray[iBin + 1];
+      iBin += nbThreads;
+    }
+    return;
+  }
+  if( eventColumns.isBuilt() ){
+    while( iBin < nBins ) {
+      binContentArray[iBin + 1] = eventColumns.getBinContent(iBin);
+      binErrorArray[iBin + 1] = binContentArray[iBin + 1];
+      iBin += nbThreads;
+    }
+    return;
+  }
   while( iBin < nBins ) {
     binContentArray[iBin + 1] = 0;
     for (auto *eventPtr: perBinEventPtrList[iBin]) {
@@ -57,8 +57,10 @@ public:
   void scanParameter(int iPar, int nbSteps_ = -1, const std::string& saveDir_ = "");
 
   void fit();
-  void updateChi2Cache();
+  void updateChi2Cache(bool propagateParameters_ = true); // false: the sample histograms are already up-to-date
   double evalFit(const double* parArray_);
+  double evalFitDerivative(const double* parArray_, unsigned int iFitPar_);
+  void evalFitGradient(const double* parArray_); // analytic, or numerical with the shifted points propagated together
 
   void writePostFitData(TDirectory* saveDir_);
 
@@ -67,6 +69,8 @@ protected:
   void initializeMinimizer(bool doReleaseFixed_ = false);
 
   void checkNumericalAccuracy();
+  void checkAnalyticGradient(); // the gradient given to the minimizer vs central differences of evalFit()
+  void addNumericalLlhGradient(const double* parArray_);
 
 
 
@@ -78,6 +82,9 @@ private:
   int _nbScanSteps_{100};
   bool _enablePostFitScan_{false};
   bool _useNormalizedFitSpace_{false};
+  bool _useAnalyticGradient_{false};
+  bool _useParallelNumericalGradient_{false};
+  double _numericalGradientStep_{1E-4}; // relative
 
   // Internals
   bool _fitIsDone_{false};
@@ -98,6 +105,7 @@ private:
   std::string _minimizerAlgo_{};
   std::shared_ptr<ROOT::Math::Minimizer> _minimizer_{nullptr};
   std::shared_ptr<ROOT::Math::Functor> _functor_{nullptr};
+  std::shared_ptr<ROOT::Math::GradFunctor> _gradFunctor_{nullptr};
   TRandom3 _prng_;
 
   ScanConfig _scanConfig_;
@@ -108,6 +116,8 @@ private:
   double _chi2PullsBuffer_{0};
   double _chi2RegBuffer_{0};
   double _parStepGain_{0.1};
+  std::vector<double> _gradientParBuffer_{}; // parameters of the last evalFitGradient() call
+  std::vector<double> _gradientBuffer_{};
 
   TTree* _chi2HistoryTree_{nullptr};
 //  std::map<std::string, std::vector<double>> _chi2History_;
@@ -16,6 +16,7 @@
 #include "TLegend.h"
 
 #include <cmath>
+#include <algorithm>
 #include <memory>
 
 
@@ -46,6 +47,9 @@ void FitterEngine::reset() {
   _propagator_.reset();
   _minimizer_.reset();
   _functor_.reset();
+  _gradFunctor_.reset();
+  _gradientParBuffer_.clear();
+  _gradientBuffer_.clear();
   _nbFitParameters_ = 0;
   _nbParameters_ = 0;
   _nbFitCalls_ = 0;
@@ -171,6 +175,9 @@ void FitterEngine::initialize() {
   } // throwMcBeforeFit
 
   this->initializeMinimizer();
+  if( (_useAnalyticGradient_ or _useParallelNumericalGradient_) and JsonUtils::fetchValue(_minimizerConfig_, "checkAnalyticGradient", false) ){
+    this->checkAnalyticGradient();
+  }
 
   _scanConfig_ = ScanConfig( JsonUtils::fetchValue(_config_, "scanConfig", nlohmann::json()) );
 
@@ -219,13 +226,8 @@ void FitterEngine::generateOneSigmaPlots(const std::string& savePath_){
   auto refHistList = _propagator_.getPlotGenerator().getHistHolderList(); // current buffer
 
 
-  auto makeOneSigmaPlotFct = [&](FitParameter& par_, const std::string& parSavePath_){
-    double currentParValue = par_.getParameterValue();
-    par_.setParameterValue( currentParValue + par_.getStdDevValue() );
-    LogInfo << "Processing " << parSavePath_ << " -> " << par_.getParameterValue() << std::endl;
-
-    _propagator_.propagateParametersOnSamples();
-
+  auto makeOneSigmaPlotFct = [&](const std::string& parSavePath_){
+    // the event weights are set to the +1 sigma point
     auto* saveDir = GenericToolbox::mkdirTFile(_saveDir_, parSavePath_ );
     saveDir->cd();
 
@@ -233,8 +235,6 @@ void FitterEngine::generateOneSigmaPlots(const std::string& savePath_){
 
     auto oneSigmaHistList = _propagator_.getPlotGenerator().getHistHolderList(1);
     _propagator_.getPlotGenerator().generateComparisonPlots( oneSigmaHistList, refHistList, saveDir );
-    par_.setParameterValue( currentParValue );
-    _propagator_.propagateParametersOnSamples();
 
     const auto& compHistList = _propagator_.getPlotGenerator().getComparisonHistHolderList();
 
@@ -245,6 +245,7 @@ void FitterEngine::generateOneSigmaPlots(const std::string& savePath_){
   };
 
   // +1 sigma
+  std::vector<std::pair<FitParameter*, std::string>> oneSigmaParList; // (parameter, save path)
   for( auto& parSet : _propagator_.getParameterSetsList() ){
 
     if( not parSet.isEnabled() ) continue;
@@ -262,7 +263,7 @@ void FitterEngine::generateOneSigmaPlots(const std::string& savePath_){
         std::string savePath = savePath_;
         if( not savePath.empty() ) savePath += "/";
         savePath += "oneSigma/eigen/" + parSet.getName() + "/" + eigenPar.getTitle() + tag;
-        makeOneSigmaPlotFct(eigenPar, savePath);
+        oneSigmaParList.emplace_back(&eigenPar, savePath);
       }
     }
     else{
@@ -273,12 +274,54 @@ void FitterEngine::generateOneSigmaPlots(const std::string& savePath_){
         std::string savePath = savePath_;
         if( not savePath.empty() ) savePath += "/";
         savePath += "oneSigma/original/" + parSet.getName() + "/" + par.getTitle() + tag;
-        makeOneSigmaPlotFct(par, savePath);
+        oneSigmaParList.emplace_back(&par, savePath);
       }
     }
 
   }
 
+  if( _propagator_.canPropagateParameterPoints() ){
+    // the +1 sigma event weights of a chunk of parameters are computed with a single pass over the events
+    size_t nbPointsPerPass{size_t(std::max(1, _propagator_.getNbPointsPerPass()))};
+    for( size_t iFirst = 0 ; iFirst < oneSigmaParList.size() ; iFirst += nbPointsPerPass ){
+      size_t iEnd{std::min(iFirst + nbPointsPerPass, oneSigmaParList.size())};
+
+      auto parState = _propagator_.getParameterState();
+      std::vector<std::vector<std::vector<double>>> pointList;
+      for( size_t iOneSigma = iFirst ; iOneSigma < iEnd ; iOneSigma++ ){
+        auto* par = oneSigmaParList[iOneSigma].first;
+        double currentParValue = par->getParameterValue();
+        par->setParameterValue( currentParValue + par->getStdDevValue() );
+        pointList.emplace_back(_propagator_.getParameterPoint());
+        par->setParameterValue( currentParValue );
+      }
+      _propagator_.restoreParameterState(parState);
+      _propagator_.propagateParameterPoints(pointList, true);
+
+      for( size_t iOneSigma = iFirst ; iOneSigma < iEnd ; iOneSigma++ ){
+        auto* par = oneSigmaParList[iOneSigma].first;
+        LogInfo << "Processing " << oneSigmaParList[iOneSigma].second << " -> " << par->getParameterValue() + par->getStdDevValue() << std::endl;
+        _propagator_.loadPointEventWeights(iOneSigma - iFirst);
+        makeOneSigmaPlotFct(oneSigmaParList[iOneSigma].second);
+      }
+      _propagator_.restoreNominalSamples();
+    }
+  }
+  else{
+    for( auto& oneSigmaPar : oneSigmaParList ){
+      auto* par = oneSigmaPar.first;
+      double currentParValue = par->getParameterValue();
+      par->setParameterValue( currentParValue + par->getStdDevValue() );
+      LogInfo << "Processing " << oneSigmaPar.second << " -> " << par->getParameterValue() << std::endl;
+
+      _propagator_.propagateParametersOnSamples();
+      makeOneSigmaPlotFct(oneSigmaPar.second);
+
+      par->setParameterValue( currentParValue );
+      _propagator_.propagateParametersOnSamples();
+    }
+  }
+
   _saveDir_->cd();
 
   // Since those were not saved, delete manually
@@ -311,6 +354,24 @@ void FitterEngine::fixGhostFitParameters(){
 
     bool fixNextEigenPars{false};
     auto& parList = parSet.getEffectiveParameterList();
+
+    // the +1 sigma histograms of the whole set are filled with a single pass over the events per chunk of points
+    std::map<const FitParameter*, size_t> pointIndexList;
+    if( _propagator_.canPropagateParameterPoints() ){
+      auto parState = _propagator_.getParameterState();
+      std::vector<std::vector<std::vector<double>>> pointList;
+      for( auto& par : parList ){
+        if( not par.isEnabled() or par.isFixed() ) continue;
+        double currentParValue = par.getParameterValue();
+        par.setParameterValue( currentParValue + par.getStdDevValue() );
+        pointIndexList[&par] = pointList.size();
+        pointList.emplace_back(_propagator_.getParameterPoint());
+        par.setParameterValue( currentParValue );
+      }
+      _propagator_.restoreParameterState(parState);
+      _propagator_.propagateParameterPoints(pointList);
+    }
+
     for( auto& par : parList ){
       ssPrint.str("");
 
@@ -337,7 +398,13 @@ void FitterEngine::fixGhostFitParameters(){
         ssPrint << " " << currentParValue << " -> " << par.getParameterValue();
         LogInfo << ssPrint.str() << "..." << std::endl;
 
-        updateChi2Cache();
+        if( pointIndexList.find(&par) != pointIndexList.end() ){
+          _propagator_.loadPointHistograms(pointIndexList[&par]);
+          updateChi2Cache(false);
+        }
+        else{
+          updateChi2Cache();
+        }
         deltaChi2Stat = _chi2StatBuffer_ - baseChi2Stat;
 //        deltaChi2Syst = _chi2PullsBuffer_ - baseChi2Syst;
 //        deltaChi2 = _chi2Buffer_ - baseChi2;
@@ -368,6 +435,7 @@ void FitterEngine::fixGhostFitParameters(){
         par.setParameterValue( currentParValue );
       }
     }
+    if( not pointIndexList.empty() ){ _propagator_.restoreNominalSamples(); }
 
     if( not parSet.isUseEigenDecompInFit() ){
       // Recompute inverse matrix for the fitter
@@ -496,23 +564,56 @@ void FitterEngine::scanParameter(int iPar, int nbSteps_, const std::string &save
 
   int offSet{0};
   for( int iPt = 0 ; iPt < nbSteps_+1 ; iPt++ ){
-    GenericToolbox::displayProgressBar(iPt, nbSteps_, ssPbar.str());
-
     double newVal = lowBound + double(iPt-offSet)/(nbSteps_-1)*( highBound - lowBound );
     if( offSet == 0 and newVal > origVal ){
       newVal = origVal;
       offSet = 1;
     }
+    parPoints[iPt] = newVal;
+  }
 
-    _minimizerFitParameterPtr_[iPar]->setParameterValue(newVal);
-    this->updateChi2Cache();
+  // the MC histograms of all the points are filled with a single pass over the events per chunk of points,
+  // unless the event weights themselves are scanned
+  bool usePointPropagation{
+      _propagator_.canPropagateParameterPoints()
+      and not JsonUtils::fetchValue(_scanConfig_.getVarsConfig(), "weightPerSample", false)
+  };
+  auto parState = _propagator_.getParameterState();
+  if( usePointPropagation ){
+    std::vector<std::vector<std::vector<double>>> pointList;
+    pointList.reserve(parPoints.size());
+    for( auto& parPoint : parPoints ){
+      _minimizerFitParameterPtr_[iPar]->setParameterValue(parPoint);
+      pointList.emplace_back(_propagator_.getParameterPoint());
+    }
+    _propagator_.restoreParameterState(parState);
+    _propagator_.propagateParameterPoints(pointList);
+  }
+
+  for( int iPt = 0 ; iPt < nbSteps_+1 ; iPt++ ){
+    GenericToolbox::displayProgressBar(iPt, nbSteps_, ssPbar.str());
+
+    _minimizerFitParameterPtr_[iPar]->setParameterValue(parPoints[iPt]);
+    if( usePointPropagation ){
+      _propagator_.loadPointHistograms(iPt);
+      this->updateChi2Cache(false);
+    }
+    else{
+      this->updateChi2Cache();
+    }
     parPoints[iPt] = _minimizerFitParameterPtr_[iPar]->getParameterValue();
 
     for( auto& scanEntry : scanDataDict ){ scanEntry.yPoints[iPt] = scanEntry.evalY(); }
   }
 
-
-  _minimizerFitParameterPtr_[iPar]->setParameterValue(origVal);
+  if( usePointPropagation ){
+    // nothing has been propagated: back to the histograms and the parameters as they were before the scan
+    _propagator_.restoreNominalSamples();
+    _propagator_.restoreParameterState(parState);
+  }
+  else{
+    _minimizerFitParameterPtr_[iPar]->setParameterValue(origVal);
+  }
 
   std::stringstream ss;
   ss << GenericToolbox::replaceSubstringInString(_minimizer_->VariableName(iPar), "/", "_");
@@ -730,12 +831,12 @@ void FitterEngine::fit(){
 
   _fitIsDone_ = true;
 }
-void FitterEngine::updateChi2Cache(){
+void FitterEngine::updateChi2Cache(bool propagateParameters_){
 
   double buffer;
 
   // Propagate on histograms
-  _propagator_.propagateParametersOnSamples();
+  if( propagateParameters_ ){ _propagator_.propagateParametersOnSamples(); }
 
   ////////////////////////////////
   // Compute chi2 stat
@@ -816,6 +917,11 @@ double FitterEngine::evalFit(const double* parArray_){
       ss << std::endl;
 #ifndef GUNDAM_BATCH
       ss << "├─";
+#endif
+      ss << " Avg time to update dials:      " << _propagator_.dialUpdate;
+      ss << std::endl;
+#ifndef GUNDAM_BATCH
+      ss << "├─";
 #endif
       ss << " Avg time to propagate weights: " << _propagator_.weightProp;
       ss << std::endl;
@@ -823,6 +929,27 @@ double FitterEngine::evalFit(const double* parArray_){
       ss << "├─";
 #endif
       ss << " Avg time to fill histograms:   " << _propagator_.fillProp;
+      if( _propagator_.getEventDialCache().isEnabled() ){
+        ss << std::endl;
+#ifndef GUNDAM_BATCH
+        ss << "├─";
+#endif
+        ss << " Incremental propagation:       " << _propagator_.getEventDialCache().getUpdateSummary();
+      }
+      if( _useAnalyticGradient_ ){
+        ss << std::endl;
+#ifndef GUNDAM_BATCH
+        ss << "├─";
+#endif
+        ss << " Avg time to eval gradient:     " << _propagator_.gradientProp;
+      }
+      if( _useParallelNumericalGradient_ ){
+        ss << std::endl;
+#ifndef GUNDAM_BATCH
+        ss << "├─";
+#endif
+        ss << " Avg time to propagate gradient points: " << _propagator_.pointProp;
+      }
     }
     else{
       ss << GET_VAR_NAME_VALUE(_propagator_.applyRf);
@@ -852,6 +979,83 @@ double FitterEngine::evalFit(const double* parArray_){
   GenericToolbox::getElapsedTimeSinceLastCallInMicroSeconds("out_evalFit");
   return _chi2Buffer_;
 }
+double FitterEngine::evalFitDerivative(const double* parArray_, unsigned int iFitPar_){
+  // the minimizer asks for the gradient one coordinate at a time
+  if( _gradientParBuffer_.size() != size_t(_nbFitParameters_)
+      or not std::equal(_gradientParBuffer_.begin(), _gradientParBuffer_.end(), parArray_) ){
+    this->evalFitGradient(parArray_);
+  }
+  return _gradientBuffer_[iFitPar_];
+}
+void FitterEngine::evalFitGradient(const double* parArray_){
+  _gradientParBuffer_.assign(parArray_, parArray_ + _nbFitParameters_);
+
+  int iFitPar{0};
+  for( auto* par : _minimizerFitParameterPtr_ ){
+    if( _useNormalizedFitSpace_ ) par->setParameterValue(FitParameterSet::toRealParValue(parArray_[iFitPar++], *par));
+    else par->setParameterValue(parArray_[iFitPar++]);
+  }
+
+  // d(chi2)/d(effective parameters) of each set: the penalty terms are always analytic
+  std::map<const FitParameterSet*, std::vector<double>> parSetGradientList;
+  auto& parSetList = _propagator_.getParameterSetsList();
+  for( auto& parSet : parSetList ){ parSetGradientList[&parSet] = parSet.getPenaltyChi2Gradient(); }
+
+  if( _useAnalyticGradient_ ){
+    // stat part through the eigen decomposition
+    _propagator_.propagateParametersOnSamples();
+    _propagator_.evalLikelihoodGradient();
+    for( size_t iParSet = 0 ; iParSet < parSetList.size() ; iParSet++ ){
+      auto& gradient = parSetGradientList[&parSetList[iParSet]];
+      auto llhGradient = parSetList[iParSet].toEffectiveGradient(_propagator_.getLikelihoodGradient()[iParSet]);
+      for( size_t iPar = 0 ; iPar < gradient.size() ; iPar++ ){ gradient[iPar] += llhGradient[iPar]; }
+    }
+  }
+
+  _gradientBuffer_.resize(_nbFitParameters_);
+  for( iFitPar = 0 ; iFitPar < _nbFitParameters_ ; iFitPar++ ){
+    auto* par = _minimizerFitParameterPtr_[iFitPar];
+    _gradientBuffer_[iFitPar] = parSetGradientList[_minimizerFitParameterSetPtr_[iFitPar]][par->getParameterIndex()];
+    if( _useNormalizedFitSpace_ ) _gradientBuffer_[iFitPar] *= par->getStdDevValue();
+  }
+
+  if( not _useAnalyticGradient_ ){ this->addNumericalLlhGradient(parArray_); }
+}
+void FitterEngine::addNumericalLlhGradient(const double* parArray_){
+  // central differences of the stat LLH: the 2N shifted points are propagated together, each of them with its own
+  // dial responses and bin accumulators, on top of the shared events
+  auto setFitParameter = [&](int iFitPar_, double value_){
+    auto* par = _minimizerFitParameterPtr_[iFitPar_];
+    if( _useNormalizedFitSpace_ ) par->setParameterValue(FitParameterSet::toRealParValue(value_, *par));
+    else par->setParameterValue(value_);
+  };
+
+  auto parState = _propagator_.getParameterState();
+  std::vector<double> stepList(_nbFitParameters_, 0);
+  std::vector<std::vector<std::vector<double>>> pointList;
+  pointList.reserve(2*_nbFitParameters_);
+  for( int iFitPar = 0 ; iFitPar < _nbFitParameters_ ; iFitPar++ ){
+    double scale{_useNormalizedFitSpace_ ? 1. : _minimizerFitParameterPtr_[iFitPar]->getStdDevValue()};
+    stepList[iFitPar] = _numericalGradientStep_ * std::max(scale, std::abs(parArray_[iFitPar]));
+    setFitParameter(iFitPar, parArray_[iFitPar] + stepList[iFitPar]);
+    pointList.emplace_back(_propagator_.getParameterPoint());
+    setFitParameter(iFitPar, parArray_[iFitPar] - stepList[iFitPar]);
+    pointList.emplace_back(_propagator_.getParameterPoint());
+    setFitParameter(iFitPar, parArray_[iFitPar]);
+  }
+  _propagator_.restoreParameterState(parState);
+  _propagator_.propagateParameterPoints(pointList);
+
+  double llhUp, llhDown;
+  for( int iFitPar = 0 ; iFitPar < _nbFitParameters_ ; iFitPar++ ){
+    _propagator_.loadPointHistograms(2*iFitPar);
+    llhUp = _propagator_.getFitSampleSet().evalLikelihood();
+    _propagator_.loadPointHistograms(2*iFitPar+1);
+    llhDown = _propagator_.getFitSampleSet().evalLikelihood();
+    _gradientBuffer_[iFitPar] += (llhUp - llhDown) / (2*stepList[iFitPar]);
+  }
+  _propagator_.restoreNominalSamples();
+}
 
 void FitterEngine::writePostFitData(TDirectory* saveDir_) {
   LogInfo << __METHOD_NAME__ << std::endl;
@@ -1433,12 +1637,39 @@ void FitterEngine::initializeMinimizer(bool doReleaseFixed_){
   }
   _nbFitParameters_ = int(_minimizerFitParameterPtr_.size());
 
+  _useAnalyticGradient_ = JsonUtils::fetchValue(_minimizerConfig_, "useAnalyticGradient", false);
+  if( _useAnalyticGradient_ and not _propagator_.canEvalLikelihoodGradient() ){
+    LogWarning << "The analytic gradient needs the event dial cache, the batch likelihood evaluation and "
+               << "no response function nor GPU cache: the minimizer will use numerical derivatives." << std::endl;
+    _useAnalyticGradient_ = false;
+  }
+  _useParallelNumericalGradient_ = not _useAnalyticGradient_ and JsonUtils::fetchValue(_minimizerConfig_, "useParallelNumericalGradient", false);
+  if( _useParallelNumericalGradient_ and not _propagator_.canPropagateParameterPoints() ){
+    LogWarning << "The parallel numerical gradient needs the event dial cache and no response function nor GPU cache: "
+               << "the minimizer will compute its own numerical derivatives." << std::endl;
+    _useParallelNumericalGradient_ = false;
+  }
+  _numericalGradientStep_ = JsonUtils::fetchValue(_minimizerConfig_, "numericalGradientStep", _numericalGradientStep_);
+
   LogInfo << "Building functor..." << std::endl;
   _functor_ = std::make_shared<ROOT::Math::Functor>(
     this, &FitterEngine::evalFit, _nbFitParameters_
   );
-
-  _minimizer_->SetFunction(*_functor_);
+  _gradientParBuffer_.clear();
+  _gradientBuffer_.clear();
+
+  if( _useAnalyticGradient_ or _useParallelNumericalGradient_ ){
+    if( _useAnalyticGradient_ ) LogInfo << "Using the analytic gradient of the " << GUNDAM_CHI2 << "." << std::endl;
+    else LogInfo << "Using the numerical gradient of the " << GUNDAM_CHI2 << " with the shifted points propagated together." << std::endl;
+    _gradFunctor_ = std::make_shared<ROOT::Math::GradFunctor>(
+        this, &FitterEngine::evalFit, &FitterEngine::evalFitDerivative, _nbFitParameters_
+    );
+    _minimizer_->SetFunction(*_gradFunctor_);
+  }
+  else{
+    _gradFunctor_.reset();
+    _minimizer_->SetFunction(*_functor_);
+  }
   _minimizer_->SetStrategy(JsonUtils::fetchValue(_minimizerConfig_, "strategy", 1));
   _minimizer_->SetPrintLevel(JsonUtils::fetchValue(_minimizerConfig_, "print_level", 2));
   _minimizer_->SetTolerance(JsonUtils::fetchValue(_minimizerConfig_, "tolerance", 1E-4));
@@ -1472,6 +1703,79 @@ void FitterEngine::initializeMinimizer(bool doReleaseFixed_){
 }
 
 
+void FitterEngine::checkAnalyticGradient(){
+  // checks the gradient given to the minimizer (analytic, or the parallel numerical one) against the central
+  // differences of evalFit(), as Minuit would compute them
+  LogWarning << __METHOD_NAME__ << std::endl;
+  double step = JsonUtils::fetchValue(_minimizerConfig_, "checkAnalyticGradientStep", 1E-4);
+  double tolerance = JsonUtils::fetchValue(_minimizerConfig_, "checkAnalyticGradientTolerance", 1E-3);
+  std::string gradientName{_useAnalyticGradient_ ? "analytic" : "parallel numerical"};
+
+  // current point, in the minimizer space
+  std::vector<double> fitParList(_nbFitParameters_, 0);
+  int nEigenFitPar{0};
+  for( int iFitPar = 0 ; iFitPar < _nbFitParameters_ ; iFitPar++ ){
+    auto* par = _minimizerFitParameterPtr_[iFitPar];
+    fitParList[iFitPar] = par->getParameterValue();
+    if( _useNormalizedFitSpace_ ) fitParList[iFitPar] = FitParameterSet::toNormalizedParValue(fitParList[iFitPar], *par);
+    if( _minimizerFitParameterSetPtr_[iFitPar]->isUseEigenDecompInFit() ) nEigenFitPar++;
+  }
+  auto evalChi2 = [&](const std::vector<double>& parList_){
+    for( int iFitPar = 0 ; iFitPar < _nbFitParameters_ ; iFitPar++ ){
+      auto* par = _minimizerFitParameterPtr_[iFitPar];
+      if( _useNormalizedFitSpace_ ) par->setParameterValue(FitParameterSet::toRealParValue(parList_[iFitPar], *par));
+      else par->setParameterValue(parList_[iFitPar]);
+    }
+    this->updateChi2Cache();
+    return _chi2Buffer_;
+  };
+
+  // the gradient must leave the parameters (originals of the eigen-decomposed sets included) and the histograms as
+  // they were
+  double chi2 = evalChi2(fitParList);
+  auto parState = _propagator_.getParameterState();
+  this->evalFitGradient(fitParList.data());
+  auto gradient = _gradientBuffer_;
+  auto parStateAfter = _propagator_.getParameterState();
+  int nMoved{0};
+  for( size_t iParSet = 0 ; iParSet < parState.valueList.size() ; iParSet++ ){
+    for( size_t iPar = 0 ; iPar < parState.valueList[iParSet].size() ; iPar++ ){
+      if( parState.valueList[iParSet][iPar] != parStateAfter.valueList[iParSet][iPar] ){
+        LogError << _propagator_.getParameterSetsList()[iParSet].getParameterList()[iPar].getFullTitle() << " moved from "
+                 << parState.valueList[iParSet][iPar] << " to " << parStateAfter.valueList[iParSet][iPar]
+                 << " while evaluating the gradient." << std::endl;
+        nMoved++;
+      }
+    }
+  }
+  LogThrowIf(nMoved != 0, nMoved << " parameters have been moved by the " << gradientName << " gradient.");
+  this->updateChi2Cache(false);
+  LogThrowIf(std::abs(_chi2Buffer_ - chi2) > 1E-9 * std::max(1., std::abs(chi2)),
+             "The histograms have been left at another point by the " << gradientName << " gradient: " << _chi2Buffer_ << " != " << chi2);
+
+  int nBad{0};
+  auto shiftedParList = fitParList;
+  for( int iFitPar = 0 ; iFitPar < _nbFitParameters_ ; iFitPar++ ){
+    double parStep = step * std::max(1., std::abs(fitParList[iFitPar]));
+    shiftedParList[iFitPar] = fitParList[iFitPar] + parStep;
+    double chi2Up = evalChi2(shiftedParList);
+    shiftedParList[iFitPar] = fitParList[iFitPar] - parStep;
+    double chi2Down = evalChi2(shiftedParList);
+    shiftedParList[iFitPar] = fitParList[iFitPar];
+
+    double numericalDerivative = (chi2Up - chi2Down) / (2 * parStep);
+    if( std::abs(gradient[iFitPar] - numericalDerivative) > tolerance * std::max(1., std::abs(numericalDerivative)) ){
+      LogError << _minimizerFitParameterPtr_[iFitPar]->getFullTitle() << ": " << gradientName << " derivative "
+               << gradient[iFitPar] << " != numerical " << numericalDerivative << std::endl;
+      nBad++;
+    }
+  }
+  evalChi2(fitParList);
+
+  LogThrowIf(nBad != 0, nBad << " / " << _nbFitParameters_ << " " << gradientName << " derivatives don't match the numerical ones.")
+  LogInfo << "The " << gradientName << " gradient matches the numerical derivatives for the " << _nbFitParameters_
+          << " fit parameters (" << nEigenFitPar << " of eigen-decomposed sets)." << std::endl;
+}
 void FitterEngine::checkNumericalAccuracy(){
   LogWarning << __METHOD_NAME__ << std::endl;
   int nTest{100}; int nThrows{10}; double gain{20};
@@ -0,0 +1,238 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#ifndef GUNDAM_EVENTDIALCACHE_H
+#define GUNDAM_EVENTDIALCACHE_H
+
+#include "FitSampleSet.h"
+#include "SampleElement.h"
+#include "FitParameter.h"
+#include "Dial.h"
+#include "DialDirectory.h"
+
+#include "vector"
+#include "map"
+#include "cstdint"
+#include "cmath"
+
+
+/*
+ * \class EventDialCache is a flat (compressed sparse row) index of the dials referenced by each MC event
+ * - All the dials referenced by the events are registered once in _dialList_, and their responses are
+ *   written in the contiguous _responseList_ buffer.
+ * - For each sample, the dials of event i are the ids dialIndexList[ offsetList[i] : offsetList[i+1] ].
+ * The event reweight then becomes a streaming gather-multiply over the response buffer.
+ * Propagation is done in two phases: each dial is evaluated exactly once (updateResponses), then the events multiply
+ * the pre-computed responses (reweight) without any lock nor per-dial cache check.
+ * With dirty-parameter tracking, prepareUpdate() only selects the dials of the parameters that changed since the last
+ * propagation, together with the events referencing them (parameter -> dials -> events inverted indices).
+ * The weight changes of these events are accumulated per bin, so the sample histograms can be updated with deltas
+ * instead of a full refill. A full refill is done whenever the whole set of events has been reweighted or the
+ * estimated floating-point drift of the accumulated sums becomes too large.
+ * Optionally, the product of the dial responses of each parameter set is cached per event, so an event touched by a
+ * single set only re-multiplies the dials of that set.
+ * Events whose dials only belong to fixed or disabled parameters can be tagged as static: their weights can't change,
+ * so the samples keep their per-bin sums and only the dynamic events are reweighted.
+ * In fused mode, the events are reweighted and accumulated (w, w^2) in per-thread bin arrays in the same pass, then
+ * reduced into the histograms: no walk over perBinEventPtrList, and the bin errors hold the true sum of w^2.
+ * The spline dials of a given parameter share their input: they are grouped by kind and size, and evaluated with the
+ * SplineBatch kernels instead of one virtual calcDial() call per dial. The kernels read the spline data directly from the
+ * packed arena of the DialSet (no copy), where the dials of the same kind and size are contiguous.
+ * Alternatively, the DialDirectory engine evaluates every dial it handles (norm, splines, graphs) from flat per-type
+ * arrays, without going through the Dial objects at all.
+ * The likelihood gradient (LikelihoodGradient) and the multi-point propagation (ParameterPointEngine) read this index
+ * and the responses. For the latter, the responses of the last propagation are saved and put back around the
+ * evaluations at the other points, so the next propagation can still be a partial one.
+ * */
+
+class EventDialCache {
+
+public:
+  struct SampleDialIndex{
+    SampleElement* samplePtr{nullptr};
+    std::vector<uint32_t> offsetList{};    // nEvents+1
+    std::vector<uint32_t> dialIndexList{}; // ids in _dialList_ / _responseList_
+    uint32_t globalEventOffset{0};         // index of the first event in the global event numbering
+    size_t globalBinOffset{0};             // index of the first bin in _binContentList_
+
+    // Optional per parameter set partial products: [iEvent*nSets + iSet]
+    std::vector<uint16_t> setDialCountList{}; // nb of dials of each set (the event dials are grouped by set)
+    std::vector<double> partialWeightList{};
+
+    // Static/dynamic partition: only the dynamic events are reweighted
+    bool isPartitioned{false};
+    std::vector<uint32_t> dynamicEventIndexList{};
+
+    size_t getNbEventsToReweight() const{ return isPartitioned ? dynamicEventIndexList.size() : offsetList.size() - 1; }
+  };
+
+  // Spline dials of one parameter (and one DialSet) with the same kind and data size
+  struct SplineDialGroup{
+    const FitParameter* parPtr{nullptr};
+    Dial* leadDialPtr{nullptr}; // provides the effective dial parameter (mirroring) of the DialSet
+    int splineType{0};          // SplineDial::Subtype
+    int dim{0};                 // data size of each spline
+    const double* dataPtr{nullptr}; // in the spline data arena of the DialSet
+    size_t nSplines{0};         // contiguous splines evaluated from dataPtr, including unreferenced ones in between
+    size_t responseOffset{0};   // in _splineGroupResponseList_ (nSplines entries)
+    size_t dialOffset{0};       // in _splineGroupDialList_ / _splineGroupSlotList_
+    size_t nDials{0};
+    double lastParameterValue{std::nan("unset")};
+  };
+
+public:
+  EventDialCache() = default;
+  virtual ~EventDialCache() = default;
+
+  void clear();
+
+  // Setters
+  void setIsEnabled(bool isEnabled_);
+  void setUseDirtyParameterTracking(bool useDirtyParameterTracking_){ _useDirtyParameterTracking_ = useDirtyParameterTracking_; }
+  void setUsePerSetPartialWeights(bool usePerSetPartialWeights_){ _usePerSetPartialWeights_ = usePerSetPartialWeights_; }
+  void setUseFusedFill(bool useFusedFill_){ _useFusedFill_ = useFusedFill_; }
+  void setUseIncrementalHistogramUpdate(bool useIncrementalHistogramUpdate_){ _useIncrementalHistogramUpdate_ = useIncrementalHistogramUpdate_; }
+  void setMaxHistogramDrift(double maxHistogramDrift_){ _maxHistogramDrift_ = maxHistogramDrift_; }
+  void setUseSplineBatchEval(bool useSplineBatchEval_){ _useSplineBatchEval_ = useSplineBatchEval_; }
+  void setUseDialDirectory(bool useDialDirectory_){ _useDialDirectory_ = useDialDirectory_; }
+  void invalidate(){ _forceFullUpdate_ = true; _needFullRefill_ = true; _hasPendingFullFill_ = false; } // next update will re-evaluate every dial and event
+
+  // Init
+  void build(FitSampleSet& sampleSet_);
+  void releaseEventDialPtrLists(); // the per-event std::vector<Dial*> are not needed anymore
+
+  // Getters
+  bool isBuilt() const{ return _isBuilt_; }
+  bool isEnabled() const{ return _isBuilt_ and _isEnabled_; }
+  bool isEventDialPtrListsReleased() const{ return _isEventDialPtrListsReleased_; }
+  bool isPartialUpdate() const{ return _isPartialUpdate_; }
+  bool canUpdateHistogramsIncrementally() const;
+  bool isPartitioned() const{ return _isPartitioned_; }
+  bool isUseFusedFill() const{ return _useFusedFill_; }
+  bool hasPendingFullFill() const{ return _hasPendingFullFill_; }
+  bool isPartitionStale() const; // the fixed/enabled state of a parameter changed, or a static parameter moved
+  const std::vector<Dial*>& getDialList() const{ return _dialList_; }
+  const std::vector<double>& getResponseList() const{ return _responseList_; }
+  const std::vector<SampleDialIndex>& getSampleDialIndexList() const{ return _sampleDialIndexList_; }
+  const std::vector<const FitParameter*>& getParameterList() const{ return _parameterList_; }
+  const std::vector<uint32_t>& getParDialOffsetList() const{ return _parDialOffsetList_; }
+  const std::vector<uint32_t>& getParDialIndexList() const{ return _parDialIndexList_; }
+  size_t getNbEvents() const{ return _eventTouchStampList_.size(); } // global numbering
+  size_t getNbBins() const{ return _binContentList_.size(); } // global numbering
+  const DialDirectory& getDialDirectory() const{ return _dialDirectory_; }
+  DialDirectory& getDialDirectory(){ return _dialDirectory_; }
+  std::vector<SampleDialIndex>& getSampleDialIndexList(){ return _sampleDialIndexList_; }
+
+  // Core
+  bool prepareUpdate(); // single thread, returns true if only a subset of the dials/events needs an update
+  void updateResponses(int iThread_, int nThreads_);
+  void reweight(SampleDialIndex& sampleIndex_, size_t beginIndex_, size_t endIndex_);
+  void reweightTouchedEvents(int iThread_, int nThreads_);
+  void reweightAndFill(int iThread_, int nThreads_);   // fused mode: full reweight + per-thread bin accumulation
+  void reduceBinContents(int iThread_, int nThreads_); // fused mode: per-thread bins -> histograms, before the rescale
+  void updateHistogramsIncrementally(); // single thread, applies the pending bin deltas
+  void clearPartition();
+  void buildPartition(); // event weights must be up-to-date
+  void syncBinContents(int iThread_, int nThreads_); // to be called after a full refill, before the rescale
+
+  // Evaluation at other parameter values (ParameterPointEngine)
+  void prepareFullUpdate(); // single thread, the next updateResponses() evaluates every dial, dirty flags untouched
+  void saveResponses(); // single thread
+  void restoreResponses(); // single thread, puts back the responses saved by saveResponses()
+
+  // Monitor
+  std::string getUpdateSummary() const;
+
+  // Misc
+  size_t getMemoryUsage() const;
+
+protected:
+  void buildPerSetPartialWeights();
+  void buildSplineDialGroups();
+  void evalSplineDialGroup(SplineDialGroup& group_);
+  inline double computeWeight(SampleDialIndex& sampleIndex_, size_t iEvent_, double treeWeight_);
+
+private:
+  bool _isBuilt_{false};
+  bool _isEnabled_{true};
+  bool _isEventDialPtrListsReleased_{false};
+  bool _useDirtyParameterTracking_{true};
+  bool _useIncrementalHistogramUpdate_{false};
+  bool _usePerSetPartialWeights_{false};
+  bool _useFusedFill_{false};
+  bool _useSplineBatchEval_{true};
+  bool _useDialDirectory_{false};
+  double _maxHistogramDrift_{1E-10}; // relative
+  double _maxPartialUpdateFraction_{0.5}; // fraction of the dial references above which a full update is cheaper
+
+  std::vector<Dial*> _dialList_{};
+  std::vector<double> _responseList_{};
+  std::vector<SampleDialIndex> _sampleDialIndexList_{};
+
+  // Parameter -> dials: the dials of parameter p are _parDialIndexList_[ _parDialOffsetList_[p] : _parDialOffsetList_[p+1] ]
+  std::vector<const FitParameter*> _parameterList_{};
+  std::vector<uint32_t> _parDialOffsetList_{};
+  std::vector<uint32_t> _parDialIndexList_{};
+
+  // Parameter sets: id of the set of each dial / parameter, and which partials need an update
+  size_t _nbSets_{0};
+  std::vector<uint16_t> _dialSetIndexList_{};
+  std::vector<uint16_t> _parSetIndexList_{};
+  std::vector<char> _updateSetList_{};
+
+  // Batched spline dials: the groups of parameter p are _splineGroupList_[ _parSplineGroupOffsetList_[p] : [p+1] ]
+  static constexpr size_t maxSplineGroupGap{8}; // unreferenced splines evaluated along before a group is split
+  std::vector<SplineDialGroup> _splineGroupList_{};
+  std::vector<uint32_t> _parSplineGroupOffsetList_{};
+  std::vector<uint32_t> _splineGroupDialList_{};
+  std::vector<uint32_t> _splineGroupSlotList_{}; // position of each grouped dial among the nSplines of its group
+  std::vector<double> _splineGroupResponseList_{};
+  std::vector<char> _isGroupedDialList_{}; // evaluated outside of the Dial interface (spline groups or DialDirectory)
+
+  // Devirtualized engine
+  DialDirectory _dialDirectory_{};
+
+  // Static partition
+  bool _isPartitioned_{false};
+  std::vector<char> _isStaticParameterList_{}; // snapshot taken when the partition was built
+
+  // Dial -> events (global numbering): _dialEventIndexList_[ _dialEventOffsetList_[d] : _dialEventOffsetList_[d+1] ]
+  std::vector<uint32_t> _dialEventOffsetList_{};
+  std::vector<uint32_t> _dialEventIndexList_{};
+
+  // Update state
+  bool _forceFullUpdate_{true};
+  bool _isPartialUpdate_{false};
+  uint32_t _touchStamp_{0};
+  std::vector<uint32_t> _eventTouchStampList_{};
+  std::vector<uint32_t> _dirtyDialList_{};
+  std::vector<uint32_t> _dirtySplineGroupList_{};
+  std::vector<uint32_t> _dirtyParameterIndexList_{};
+  std::vector<uint32_t> _touchedEventList_{}; // sorted global event indices
+
+  // Incremental histograms: raw (unscaled) bin contents + per-thread pending deltas
+  bool _needFullRefill_{true};
+  double _accumulatedAbsDelta_{0};
+  // in fused mode, the per-thread arrays are also the full fill accumulators
+  bool _hasPendingFullFill_{false};
+  std::vector<double> _binContentList_{};
+  std::vector<double> _binSumw2List_{};
+  std::vector<std::vector<double>> _threadBinDeltaList_{};
+  std::vector<std::vector<double>> _threadBinSumw2DeltaList_{};
+  std::vector<double> _threadAbsDeltaList_{};
+
+  // Responses of the last propagation, while evaluating other parameter values
+  std::vector<double> _savedResponseList_{};
+
+  // Monitor
+  size_t _nbUpdates_{0};
+  size_t _nbPartialUpdates_{0};
+  size_t _nbReweightedEvents_{0};
+  size_t _nbIncrementalRefills_{0};
+  size_t _nbFullRefills_{0};
+
+};
+
+
+#endif //GUNDAM_EVENTDIALCACHE_H
@@ -0,0 +1,52 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#ifndef GUNDAM_LIKELIHOODGRADIENT_H
+#define GUNDAM_LIKELIHOODGRADIENT_H
+
+#include "EventDialCache.h"
+
+#include "vector"
+#include "cstdint"
+
+
+/*
+ * \class LikelihoodGradient computes the gradient of the likelihood wrt every parameter of an EventDialCache in a
+ * single pass over its dynamic events. Given the derivatives of the LLH wrt the bin contents and sums of w^2, each
+ * event adds dLLH/dw * dw/dp, where dw/dp goes through the product of the dial responses (chain rule with the dial
+ * response derivatives). The responses and the event weights of the cache have to be up-to-date.
+ * */
+
+class LikelihoodGradient {
+
+public:
+  explicit LikelihoodGradient(const EventDialCache& eventDialCache_): _eventDialCache_(eventDialCache_) {}
+  virtual ~LikelihoodGradient() = default;
+
+  void clear(); // to be called whenever the cache is rebuilt
+
+  // The dLLH/d(bin) lists are indexed by global bin, and wrt the unscaled bin contents and sums of w^2
+  void prepare(); // single thread, before filling the dLLH/d(bin) lists
+  std::vector<double>& getBinContentDerivativeList(){ return _binContentDerivativeList_; }
+  std::vector<double>& getBinSumw2DerivativeList(){ return _binSumw2DerivativeList_; }
+
+  // Core
+  void evalResponseDerivatives(int iThread_, int nThreads_); // d(response)/d(parameter) of each dial
+  void accumulate(int iThread_, int nThreads_);
+  const std::vector<double>& reduce(); // single thread, dLLH/d(parameter) indexed like the cache getParameterList()
+
+private:
+  const EventDialCache& _eventDialCache_;
+
+  std::vector<uint32_t> _dialParIndexList_{}; // dial -> index in the parameter list of the cache
+  std::vector<double> _responseDerivativeList_{};
+  std::vector<double> _binContentDerivativeList_{};
+  std::vector<double> _binSumw2DerivativeList_{};
+  std::vector<std::vector<double>> _threadGradientList_{};
+  std::vector<double> _gradientList_{};
+
+};
+
+
+#endif //GUNDAM_LIKELIHOODGRADIENT_H
@@ -0,0 +1,61 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#ifndef GUNDAM_PARAMETERPOINTENGINE_H
+#define GUNDAM_PARAMETERPOINTENGINE_H
+
+#include "EventDialCache.h"
+
+#include "vector"
+
+
+/*
+ * \class ParameterPointEngine propagates several parameter points in one pass over the events of an EventDialCache.
+ * The dial responses of a chunk of K points are interleaved per dial, so a single pass over the events accumulates
+ * K sets of bin contents (and optionally the K event weights). Neither the event weights nor the histograms are
+ * touched: the responses of each point are evaluated by the cache (EventDialCache::prepareFullUpdate() then
+ * updateResponses()), and the owner restores the responses of the last propagation with
+ * EventDialCache::restoreResponses() once all the points are stored.
+ * */
+
+class ParameterPointEngine {
+
+public:
+  explicit ParameterPointEngine(const EventDialCache& eventDialCache_): _eventDialCache_(eventDialCache_) {}
+  virtual ~ParameterPointEngine() = default;
+
+  void clear();
+
+  // The bin content lists are [iPoint][iGlobalBin], unscaled, with the sums of w^2 as in the histograms
+  void clearPoints(size_t nPoints_, bool storeEventWeights_ = false); // single thread
+  void beginChunk(size_t firstPoint_, size_t nChunkPoints_); // single thread
+  void storeResponses(size_t iChunkPoint_); // single thread, the cache responses have been evaluated at the point
+
+  // Core
+  void fill(int iThread_, int nThreads_);
+  void reduce(int iThread_, int nThreads_);
+
+  // Getters
+  const std::vector<std::vector<double>>& getPointBinContentList() const{ return _pointBinContentList_; }
+  const std::vector<std::vector<double>>& getPointBinSumw2List() const{ return _pointBinSumw2List_; }
+  const std::vector<std::vector<double>>& getPointEventWeightList() const{ return _pointEventWeightList_; } // [iPoint][iGlobalEvent]
+
+private:
+  const EventDialCache& _eventDialCache_;
+
+  size_t _firstChunkPoint_{0};
+  size_t _nbChunkPoints_{0};
+  bool _isChunkStatic_{true}; // false if a point moves a static parameter: every event is reweighted
+  bool _storeEventWeights_{false};
+  std::vector<double> _pointResponseList_{}; // [iDial*_nbChunkPoints_ + iChunkPoint]
+  std::vector<std::vector<double>> _threadPointBinList_{}; // [iGlobalBin*_nbChunkPoints_ + iChunkPoint]
+  std::vector<std::vector<double>> _threadPointBinSumw2List_{};
+  std::vector<std::vector<double>> _pointBinContentList_{};
+  std::vector<std::vector<double>> _pointBinSumw2List_{};
+  std::vector<std::vector<double>> _pointEventWeightList_{};
+
+};
+
+
+#endif //GUNDAM_PARAMETERPOINTENGINE_H
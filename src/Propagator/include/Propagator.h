@@ -11,6 +11,9 @@
 #include "EventTreeWriter.h"
 #include "FitSampleSet.h"
 #include "FitParameterSet.h"
+#include "EventDialCache.h"
+#include "LikelihoodGradient.h"
+#include "ParameterPointEngine.h"
 
 #include "GenericToolbox.CycleTimer.h"
 
@@ -22,6 +25,15 @@
 
 class Propagator {
 
+public:
+  // Values and dirty flags of the original and eigen parameters of each set: [iParSet][iPar]
+  struct ParameterState{
+    std::vector<std::vector<double>> valueList{};
+    std::vector<std::vector<char>> dirtyList{};
+    std::vector<std::vector<double>> eigenValueList{};
+    std::vector<std::vector<char>> eigenDirtyList{};
+  };
+
 public:
   Propagator();
   virtual ~Propagator();
@@ -44,6 +56,7 @@ public:
   bool isUseResponseFunctions() const;
   bool isThrowAsimovToyParameters() const;
   FitSampleSet &getFitSampleSet();
+  const EventDialCache &getEventDialCache() const{ return _eventDialCache_; }
   std::vector<FitParameterSet> &getParameterSetsList();
   const std::vector<FitParameterSet> &getParameterSetsList() const;
   PlotGenerator &getPlotGenerator();
@@ -57,14 +70,34 @@ public:
   void refillSampleHistograms();
   void applyResponseFunctions();
 
+  // Gradient of FitSampleSet::evalLikelihood() at the propagated point, wrt the (original) parameter values
+  bool canEvalLikelihoodGradient() const;
+  void evalLikelihoodGradient();
+  const std::vector<std::vector<double>>& getLikelihoodGradient() const{ return _llhGradientList_; } // [iParSet][iPar]
+
+  // Multi-point propagation: the MC bin contents of several parameter points, with a single pass over the events for
+  // each chunk of points. A point holds the values of getParameterList() of each set: [iParSet][iPar]
+  // The parameters and the dial responses are left as they were. Building a point list moves the fit parameters:
+  // wrap it with getParameterState() / restoreParameterState().
+  bool canPropagateParameterPoints() const;
+  int getNbPointsPerPass() const{ return _nbPointsPerPass_; }
+  ParameterState getParameterState();
+  void restoreParameterState(const ParameterState& state_);
+  std::vector<std::vector<double>> getParameterPoint(); // current values, eigen parameters propagated (state untouched)
+  void propagateParameterPoints(const std::vector<std::vector<std::vector<double>>>& pointList_, bool storeEventWeights_ = false);
+  void loadPointHistograms(size_t iPoint_); // the event weights are not updated
+  void loadPointEventWeights(size_t iPoint_); // needs storeEventWeights_, the histograms are not updated
+  void restoreNominalSamples(); // puts back the histograms and event weights overwritten by the loadPoint*() calls
+
   // Switches
   void preventRfPropagation();
   void allowRfPropagation();
+  void setEnableEventDialCache(bool enable_); // false -> legacy per-event dial evaluation (validation)
+  void updateEventPartition(); // (re)split the MC events into static and dynamic events
 
   // Monitor
-
-  // Dev
-  void fillDialsStack();
+  void validateEventDialCache();
+  void validateFloatStorage(); // propagated bin contents and LLH vs a double precision reference
 
 protected:
   void initializeThreads();
@@ -100,13 +133,39 @@ private:
   // Monitoring
   bool _showEventBreakdown_{true};
 
+  // Event storage
+  bool _useColumnarEventStore_{false};
+  bool _mergeEquivalentEvents_{false};
+  bool _sortEventsByBin_{false};
+  bool _useEventDialCache_{true};
+  bool _validateEventDialCache_{false};
+  bool _useDirtyParameterTracking_{true};
+  bool _useIncrementalHistogramUpdate_{false};
+  bool _usePerSetPartialWeights_{false};
+  bool _useStaticEventPartition_{false};
+  bool _useFusedReweightAndFill_{false};
+  bool _useSplineBatchEval_{true};
+  bool _useDialDirectory_{false};
+  double _maxIncrementalHistogramDrift_{1E-10};
+  int _nbPointsPerPass_{16};
+  bool _releaseEventDialPtrLists_{true};
+  bool _slimSplineDials_{false};
+#ifdef GUNDAM_FLOAT_STORAGE
+  bool _validateFloatStorage_{true};
+#else
+  bool _validateFloatStorage_{false};
+#endif
+  EventDialCache _eventDialCache_;
+  LikelihoodGradient _likelihoodGradient_{_eventDialCache_};
+  ParameterPointEngine _parameterPointEngine_{_eventDialCache_};
+  std::vector<std::vector<double>> _nominalHistogramList_{}; // [iSample] bin contents then sums of w^2, empty if not saved
+  std::vector<std::vector<double>> _nominalEventWeightList_{}; // [iSample], empty if not saved
+  std::vector<std::vector<double>> _llhGradientList_;
+
   // Response functions (WIP)
   std::map<FitSample*, std::shared_ptr<TH1D>> _nominalSamplesMcHistogram_;
   std::map<FitSample*, std::vector<std::shared_ptr<TH1D>>> _responseFunctionsSamplesMcHistogram_;
 
-  // DEV
-  std::vector<Dial*> _dialsStack_;
-
 #ifdef GUNDAM_USING_CACHE_MANAGER
   // Build the precalculated caches.  This is only relevant when using a GPU
   // and must be done after the datasets are loaded.  This returns true if
@@ -128,6 +187,8 @@ public:
   GenericToolbox::CycleTimer weightProp;
   GenericToolbox::CycleTimer fillProp;
   GenericToolbox::CycleTimer applyRf;
+  GenericToolbox::CycleTimer gradientProp;
+  GenericToolbox::CycleTimer pointProp;
 
   long long nbWeightProp = 0;
   long long cumulatedWeightPropTime = 0;
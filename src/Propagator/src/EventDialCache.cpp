@@ -0,0 +1,798 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#include "EventDialCache.h"
+#include "FitParameterSet.h"
+#include "SplineDial.h"
+#include "SplineBatch.h"
+
+#include "Logger.h"
+#include "GenericToolbox.h"
+
+#include <unordered_map>
+#include <map>
+#include <tuple>
+#include <limits>
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <cmath>
+
+LoggerInit([]{ Logger::setUserHeaderStr("[EventDialCache]"); });
+
+
+void EventDialCache::clear(){
+  _isBuilt_ = false;
+  _isEventDialPtrListsReleased_ = false;
+  _dialList_.clear();
+  _responseList_.clear();
+  _sampleDialIndexList_.clear();
+  _parameterList_.clear();
+  _parDialOffsetList_.clear();
+  _parDialIndexList_.clear();
+  _nbSets_ = 0;
+  _dialSetIndexList_.clear();
+  _parSetIndexList_.clear();
+  _updateSetList_.clear();
+  _splineGroupList_.clear();
+  _parSplineGroupOffsetList_.clear();
+  _splineGroupDialList_.clear();
+  _splineGroupSlotList_.clear();
+  _splineGroupResponseList_.clear();
+  _isGroupedDialList_.clear();
+  _dialDirectory_.clear();
+  _isPartitioned_ = false;
+  _isStaticParameterList_.clear();
+  _dialEventOffsetList_.clear();
+  _dialEventIndexList_.clear();
+  _forceFullUpdate_ = true;
+  _isPartialUpdate_ = false;
+  _touchStamp_ = 0;
+  _eventTouchStampList_.clear();
+  _dirtyDialList_.clear();
+  _dirtySplineGroupList_.clear();
+  _dirtyParameterIndexList_.clear();
+  _touchedEventList_.clear();
+  _needFullRefill_ = true;
+  _accumulatedAbsDelta_ = 0;
+  _binContentList_.clear();
+  _binSumw2List_.clear();
+  _hasPendingFullFill_ = false;
+  _threadBinDeltaList_.clear();
+  _threadBinSumw2DeltaList_.clear();
+  _threadAbsDeltaList_.clear();
+  _savedResponseList_.clear();
+  _nbUpdates_ = 0;
+  _nbPartialUpdates_ = 0;
+  _nbReweightedEvents_ = 0;
+  _nbIncrementalRefills_ = 0;
+  _nbFullRefills_ = 0;
+}
+
+void EventDialCache::setIsEnabled(bool isEnabled_){
+  // the responses/weights have not been maintained while disabled
+  if( isEnabled_ and not _isEnabled_ ){ this->invalidate(); }
+  _isEnabled_ = isEnabled_;
+}
+
+void EventDialCache::build(FitSampleSet& sampleSet_){
+  LogWarning << __METHOD_NAME__ << std::endl;
+  this->clear();
+
+  std::unordered_map<Dial*, uint32_t> dialIndexDict;
+  size_t nGlobalEvents{0};
+  size_t nGlobalBins{0};
+  _sampleDialIndexList_.reserve(sampleSet_.getFitSampleList().size());
+  for( auto& sample : sampleSet_.getFitSampleList() ){
+    _sampleDialIndexList_.emplace_back();
+    auto& sampleIndex = _sampleDialIndexList_.back();
+    sampleIndex.samplePtr = &sample.getMcContainer();
+    sampleIndex.globalEventOffset = uint32_t(nGlobalEvents);
+    sampleIndex.globalBinOffset = nGlobalBins;
+    nGlobalEvents += sample.getMcContainer().eventList.size();
+    nGlobalBins += sample.getMcContainer().perBinEventPtrList.size();
+    LogThrowIf(nGlobalEvents >= std::numeric_limits<uint32_t>::max(), "Too many MC events for 32-bit indices.");
+
+    auto& eventList = sample.getMcContainer().eventList;
+    size_t nRefs{0};
+    for( auto& event : eventList ){ nRefs += event.getRawDialPtrList().size(); }
+    LogThrowIf(nRefs >= std::numeric_limits<uint32_t>::max(), "Too many dial references in \"" << sample.getName() << "\" for 32-bit offsets.");
+
+    sampleIndex.offsetList.resize(eventList.size()+1, 0);
+    sampleIndex.dialIndexList.reserve(nRefs);
+    for( size_t iEvent = 0 ; iEvent < eventList.size() ; iEvent++ ){
+      for( auto* dialPtr : eventList[iEvent].getRawDialPtrList() ){
+        if( dialPtr == nullptr ) break; // trimmed list
+        auto it = dialIndexDict.find(dialPtr);
+        if( it == dialIndexDict.end() ){
+          it = dialIndexDict.emplace(dialPtr, uint32_t(_dialList_.size())).first;
+          _dialList_.emplace_back(dialPtr);
+        }
+        sampleIndex.dialIndexList.emplace_back(it->second);
+      }
+      sampleIndex.offsetList[iEvent+1] = uint32_t(sampleIndex.dialIndexList.size());
+    }
+    sampleIndex.dialIndexList.shrink_to_fit();
+  }
+
+  _responseList_.resize(_dialList_.size(), 1);
+
+  // Parameter -> dials
+  std::unordered_map<const FitParameter*, uint32_t> parIndexDict;
+  std::vector<uint32_t> dialParIndexList(_dialList_.size());
+  for( size_t iDial = 0 ; iDial < _dialList_.size() ; iDial++ ){
+    const FitParameter* parPtr = _dialList_[iDial]->getOwner()->getOwner();
+    auto it = parIndexDict.find(parPtr);
+    if( it == parIndexDict.end() ){
+      it = parIndexDict.emplace(parPtr, uint32_t(_parameterList_.size())).first;
+      _parameterList_.emplace_back(parPtr);
+    }
+    dialParIndexList[iDial] = it->second;
+  }
+  _parDialOffsetList_.resize(_parameterList_.size()+1, 0);
+  for( auto& iPar : dialParIndexList ){ _parDialOffsetList_[iPar+1]++; }
+  std::partial_sum(_parDialOffsetList_.begin(), _parDialOffsetList_.end(), _parDialOffsetList_.begin());
+  _parDialIndexList_.resize(_dialList_.size());
+  std::vector<uint32_t> fillCursor(_parDialOffsetList_.begin(), _parDialOffsetList_.end()-1);
+  for( size_t iDial = 0 ; iDial < _dialList_.size() ; iDial++ ){
+    _parDialIndexList_[fillCursor[dialParIndexList[iDial]]++] = uint32_t(iDial);
+  }
+  if( _useDialDirectory_ ){
+    _dialDirectory_.initialize(_dialList_, _parameterList_);
+    _isGroupedDialList_ = _dialDirectory_.getIsHandledList();
+    _parSplineGroupOffsetList_.resize(_parameterList_.size()+1, 0);
+  }
+  else{
+    this->buildSplineDialGroups();
+  }
+
+  // Parameter -> set
+  std::unordered_map<const FitParameterSet*, uint16_t> setIndexDict;
+  _parSetIndexList_.resize(_parameterList_.size());
+  for( size_t iPar = 0 ; iPar < _parameterList_.size() ; iPar++ ){
+    auto it = setIndexDict.find(_parameterList_[iPar]->getOwner());
+    if( it == setIndexDict.end() ){
+      LogThrowIf(setIndexDict.size() >= std::numeric_limits<uint16_t>::max(), "Too many parameter sets.");
+      it = setIndexDict.emplace(_parameterList_[iPar]->getOwner(), uint16_t(setIndexDict.size())).first;
+    }
+    _parSetIndexList_[iPar] = it->second;
+  }
+  _nbSets_ = setIndexDict.size();
+  _dialSetIndexList_.resize(_dialList_.size());
+  for( size_t iDial = 0 ; iDial < _dialList_.size() ; iDial++ ){
+    _dialSetIndexList_[iDial] = _parSetIndexList_[dialParIndexList[iDial]];
+  }
+  _updateSetList_.resize(_nbSets_, 1);
+  if( _usePerSetPartialWeights_ ){ this->buildPerSetPartialWeights(); }
+
+  // Dial -> events (transpose of the event -> dials index)
+  size_t nTotalRefs{0};
+  for( auto& sampleIndex : _sampleDialIndexList_ ){ nTotalRefs += sampleIndex.dialIndexList.size(); }
+  LogThrowIf(nTotalRefs >= std::numeric_limits<uint32_t>::max(), "Too many dial references for 32-bit offsets.");
+  _dialEventOffsetList_.resize(_dialList_.size()+1, 0);
+  for( auto& sampleIndex : _sampleDialIndexList_ ){
+    for( auto& iDial : sampleIndex.dialIndexList ){ _dialEventOffsetList_[iDial+1]++; }
+  }
+  std::partial_sum(_dialEventOffsetList_.begin(), _dialEventOffsetList_.end(), _dialEventOffsetList_.begin());
+  _dialEventIndexList_.resize(_dialEventOffsetList_.back());
+  fillCursor.assign(_dialEventOffsetList_.begin(), _dialEventOffsetList_.end()-1);
+  for( auto& sampleIndex : _sampleDialIndexList_ ){
+    for( size_t iEvent = 0 ; iEvent+1 < sampleIndex.offsetList.size() ; iEvent++ ){
+      for( uint32_t iRef = sampleIndex.offsetList[iEvent] ; iRef < sampleIndex.offsetList[iEvent+1] ; iRef++ ){
+        _dialEventIndexList_[fillCursor[sampleIndex.dialIndexList[iRef]]++] = sampleIndex.globalEventOffset + uint32_t(iEvent);
+      }
+    }
+  }
+  _eventTouchStampList_.resize(nGlobalEvents, 0);
+
+  _binContentList_.resize(nGlobalBins, 0);
+  _binSumw2List_.resize(nGlobalBins, 0);
+  _threadBinDeltaList_.resize(GlobalVariables::getNbThreads(), std::vector<double>(nGlobalBins, 0));
+  _threadBinSumw2DeltaList_.resize(GlobalVariables::getNbThreads(), std::vector<double>(nGlobalBins, 0));
+  _threadAbsDeltaList_.resize(GlobalVariables::getNbThreads(), 0);
+
+  _isBuilt_ = true;
+
+  LogInfo << _dialList_.size() << " dials referenced by the MC events, index takes "
+  << GenericToolbox::parseSizeUnits(double(this->getMemoryUsage())) << std::endl;
+}
+void EventDialCache::buildPerSetPartialWeights(){
+  LogInfo << "Caching per event partial weights of " << _nbSets_ << " parameter sets..." << std::endl;
+  for( auto& sampleIndex : _sampleDialIndexList_ ){
+    size_t nEvents{sampleIndex.offsetList.size() - 1};
+    sampleIndex.setDialCountList.resize(nEvents*_nbSets_, 0);
+    sampleIndex.partialWeightList.resize(nEvents*_nbSets_, 1);
+    for( size_t iEvent = 0 ; iEvent < nEvents ; iEvent++ ){
+      auto refBegin = sampleIndex.dialIndexList.begin() + sampleIndex.offsetList[iEvent];
+      auto refEnd = sampleIndex.dialIndexList.begin() + sampleIndex.offsetList[iEvent+1];
+
+      // DataDispenser already fills the dials set by set: this is a no-op in practice
+      std::stable_sort(refBegin, refEnd, [&](uint32_t a_, uint32_t b_){ return _dialSetIndexList_[a_] < _dialSetIndexList_[b_]; });
+
+      for( auto it = refBegin ; it != refEnd ; ++it ){
+        auto& count = sampleIndex.setDialCountList[iEvent*_nbSets_ + _dialSetIndexList_[*it]];
+        LogThrowIf(count == std::numeric_limits<uint16_t>::max(), "Too many dials of the same set for one event.");
+        count++;
+      }
+    }
+  }
+}
+void EventDialCache::buildSplineDialGroups(){
+  _isGroupedDialList_.resize(_dialList_.size(), 0);
+  _parSplineGroupOffsetList_.resize(_parameterList_.size()+1, 0);
+#ifndef USE_TSPLINE3_EVAL
+  if( not _useSplineBatchEval_ ) return;
+
+  for( size_t iPar = 0 ; iPar < _parameterList_.size() ; iPar++ ){
+    _parSplineGroupOffsetList_[iPar] = uint32_t(_splineGroupList_.size());
+
+    // group the dials of this parameter: (DialSet, spline type, data size) -> dials
+    std::map<std::tuple<const DialSet*, int, int>, std::vector<uint32_t>> groupDict;
+    for( uint32_t iEntry = _parDialOffsetList_[iPar] ; iEntry < _parDialOffsetList_[iPar+1] ; iEntry++ ){
+      uint32_t iDial = _parDialIndexList_[iEntry];
+      if( _dialList_[iDial]->getDialType() != DialType::Spline ) continue;
+      auto* splineDialPtr = static_cast<SplineDial*>(_dialList_[iDial]);
+      auto splineType = splineDialPtr->getSplineType();
+      if( splineType != SplineDial::Uniform and splineType != SplineDial::General and splineType != SplineDial::Monotonic ) continue;
+      groupDict[{splineDialPtr->getOwner(), int(splineType), splineDialPtr->getSplineDataSize()}].emplace_back(iDial);
+    }
+
+    for( auto& group : groupDict ){
+      // the data is read in place from the DialSet arena, where the dials of the same kind and size are contiguous
+      auto* dialSetPtr = std::get<0>(group.first);
+      int dim{std::get<2>(group.first)};
+      const double* arenaPtr{dialSetPtr->getSplineDataArena().data()};
+      std::vector<std::pair<size_t, uint32_t>> offsetDialList; // (offset in the arena, iDial)
+      for( auto& iDial : group.second ){
+        auto* splineDialPtr = static_cast<SplineDial*>(_dialList_[iDial]);
+        if( not splineDialPtr->isSplineDataPacked() ) continue; // left to calcDial()
+        offsetDialList.emplace_back(splineDialPtr->getSplineDataArenaOffset(), iDial);
+      }
+      std::sort(offsetDialList.begin(), offsetDialList.end());
+
+      // One batch per run of contiguous splines. Small gaps (unreferenced dials) are evaluated along and ignored.
+      size_t iFirst{0};
+      while( iFirst < offsetDialList.size() ){
+        size_t iLast{iFirst};
+        while( iLast+1 < offsetDialList.size()
+               and offsetDialList[iLast+1].first - offsetDialList[iLast].first <= size_t(dim)*(maxSplineGroupGap+1) ){
+          iLast++;
+        }
+
+        _splineGroupList_.emplace_back();
+        auto& splineGroup = _splineGroupList_.back();
+        splineGroup.parPtr = _parameterList_[iPar];
+        splineGroup.leadDialPtr = _dialList_[offsetDialList[iFirst].second];
+        splineGroup.splineType = std::get<1>(group.first);
+        splineGroup.dim = dim;
+        splineGroup.dataPtr = arenaPtr + offsetDialList[iFirst].first;
+        splineGroup.nSplines = (offsetDialList[iLast].first - offsetDialList[iFirst].first) / dim + 1;
+        splineGroup.responseOffset = _splineGroupResponseList_.size();
+        splineGroup.dialOffset = _splineGroupDialList_.size();
+        splineGroup.nDials = iLast - iFirst + 1;
+        _splineGroupResponseList_.resize(_splineGroupResponseList_.size() + splineGroup.nSplines, 0);
+        for( size_t iEntry = iFirst ; iEntry <= iLast ; iEntry++ ){
+          _splineGroupDialList_.emplace_back(offsetDialList[iEntry].second);
+          _splineGroupSlotList_.emplace_back(uint32_t((offsetDialList[iEntry].first - offsetDialList[iFirst].first) / dim));
+          _isGroupedDialList_[offsetDialList[iEntry].second] = 1;
+        }
+        iFirst = iLast + 1;
+      }
+    }
+  }
+  _parSplineGroupOffsetList_.back() = uint32_t(_splineGroupList_.size());
+
+  if( not _splineGroupList_.empty() ){
+    LogInfo << _splineGroupDialList_.size() << " spline dials evaluated in " << _splineGroupList_.size()
+    << " batches (" << SplineBatch::toString(SplineBatch::getSimdLevel()) << ")" << std::endl;
+  }
+#endif
+}
+void EventDialCache::evalSplineDialGroup(SplineDialGroup& group_){
+  double parameterValue{group_.parPtr->getParameterValue()};
+  const uint32_t* dialIndex = &_splineGroupDialList_[group_.dialOffset];
+
+  if( parameterValue == group_.lastParameterValue and not Dial::disableDialCache ){
+    // nothing moved: the dials will return their cache (unless they have been evaluated elsewhere in the meantime)
+    for( size_t iDial = 0 ; iDial < group_.nDials ; iDial++ ){
+      if( Dial::enableMaskCheck and _dialList_[dialIndex[iDial]]->isMasked() ){ _responseList_[dialIndex[iDial]] = 1; continue; }
+      _responseList_[dialIndex[iDial]] = _dialList_[dialIndex[iDial]]->fillResponseCache();
+    }
+    return;
+  }
+
+#ifndef USE_TSPLINE3_EVAL
+  double x{group_.leadDialPtr->getEffectiveDialParameter(parameterValue)};
+  const uint32_t* slot = &_splineGroupSlotList_[group_.dialOffset];
+  double* out{&_splineGroupResponseList_[group_.responseOffset]};
+  if     ( group_.splineType == SplineDial::Uniform ){ SplineBatch::evalUniformSplines(x, group_.dataPtr, group_.dim, group_.nSplines, out); }
+  else if( group_.splineType == SplineDial::General ){ SplineBatch::evalGeneralSplines(x, group_.dataPtr, group_.dim, group_.nSplines, out); }
+  else                                              { SplineBatch::evalMonotonicSplines(x, group_.dataPtr, group_.dim, group_.nSplines, out); }
+
+  for( size_t iDial = 0 ; iDial < group_.nDials ; iDial++ ){
+    if( Dial::enableMaskCheck and _dialList_[dialIndex[iDial]]->isMasked() ){ _responseList_[dialIndex[iDial]] = 1; continue; }
+    _responseList_[dialIndex[iDial]] = _dialList_[dialIndex[iDial]]->setResponseCache(parameterValue, out[slot[iDial]]);
+  }
+  group_.lastParameterValue = parameterValue;
+#endif
+}
+void EventDialCache::releaseEventDialPtrLists(){
+  LogThrowIf(not _isBuilt_, "Can't " << __METHOD_NAME__ << " before the cache is built.");
+  LogInfo << "Releasing per-event dial lists..." << std::endl;
+  for( auto& sampleIndex : _sampleDialIndexList_ ){
+    for( auto& event : sampleIndex.samplePtr->eventList ){
+      std::vector<Dial*>().swap(event.getRawDialPtrList());
+    }
+  }
+  _isEventDialPtrListsReleased_ = true;
+}
+
+bool EventDialCache::prepareUpdate(){
+  _isPartialUpdate_ = false;
+  _dirtyDialList_.clear();
+  _dirtySplineGroupList_.clear();
+  _dirtyParameterIndexList_.clear();
+  _touchedEventList_.clear();
+  _nbUpdates_++;
+  if( _dialDirectory_.isInitialized() ){ _dialDirectory_.updateParameterValues(); }
+
+  LogThrowIf(_isPartitioned_ and Dial::enableMaskCheck, "Dial masks can't be used while the events are partitioned.");
+
+  // the mask state is not tracked by the parameters
+  std::fill(_updateSetList_.begin(), _updateSetList_.end(), 1);
+  if( not _useDirtyParameterTracking_ or _forceFullUpdate_ or Dial::enableMaskCheck ){
+    _forceFullUpdate_ = false;
+    _needFullRefill_ = true;
+    return false;
+  }
+
+  size_t nRefs{0};
+  std::fill(_updateSetList_.begin(), _updateSetList_.end(), 0);
+  for( size_t iPar = 0 ; iPar < _parameterList_.size() ; iPar++ ){
+    if( not _parameterList_[iPar]->isDirty() ) continue;
+    _updateSetList_[_parSetIndexList_[iPar]] = 1;
+    _dirtyParameterIndexList_.emplace_back(uint32_t(iPar));
+    for( uint32_t iEntry = _parDialOffsetList_[iPar] ; iEntry < _parDialOffsetList_[iPar+1] ; iEntry++ ){
+      uint32_t iDial = _parDialIndexList_[iEntry];
+      _dirtyDialList_.emplace_back(iDial);
+      nRefs += _dialEventOffsetList_[iDial+1] - _dialEventOffsetList_[iDial];
+    }
+    for( uint32_t iGroup = _parSplineGroupOffsetList_[iPar] ; iGroup < _parSplineGroupOffsetList_[iPar+1] ; iGroup++ ){
+      _dirtySplineGroupList_.emplace_back(iGroup);
+    }
+  }
+  if( double(nRefs) > _maxPartialUpdateFraction_ * double(_dialEventIndexList_.size()) ){
+    _dirtyDialList_.clear();
+    _dirtySplineGroupList_.clear();
+    _dirtyParameterIndexList_.clear();
+    std::fill(_updateSetList_.begin(), _updateSetList_.end(), 1);
+    _needFullRefill_ = true;
+    return false;
+  }
+
+  if( ++_touchStamp_ == 0 ){
+    // wrapped around: reset the stamps
+    std::fill(_eventTouchStampList_.begin(), _eventTouchStampList_.end(), 0);
+    _touchStamp_ = 1;
+  }
+  for( auto& iDial : _dirtyDialList_ ){
+    for( uint32_t iEntry = _dialEventOffsetList_[iDial] ; iEntry < _dialEventOffsetList_[iDial+1] ; iEntry++ ){
+      uint32_t iEvent = _dialEventIndexList_[iEntry];
+      if( _eventTouchStampList_[iEvent] == _touchStamp_ ) continue;
+      _eventTouchStampList_[iEvent] = _touchStamp_;
+      _touchedEventList_.emplace_back(iEvent);
+    }
+  }
+  std::sort(_touchedEventList_.begin(), _touchedEventList_.end()); // sample-contiguous and memory friendly
+
+  _nbPartialUpdates_++;
+  _nbReweightedEvents_ += _touchedEventList_.size();
+  _isPartialUpdate_ = true;
+  return true;
+}
+void EventDialCache::updateResponses(int iThread_, int nThreads_){
+  // each dial is handled by a single thread: no lock needed
+  if( _isPartialUpdate_ ){
+    size_t nDials{_dirtyDialList_.size()};
+    for( size_t iEntry = iThread_ ; iEntry < nDials ; iEntry += nThreads_ ){
+      if( _isGroupedDialList_[_dirtyDialList_[iEntry]] ) continue;
+      _responseList_[_dirtyDialList_[iEntry]] = _dialList_[_dirtyDialList_[iEntry]]->fillResponseCache();
+    }
+    size_t nGroups{_dirtySplineGroupList_.size()};
+    for( size_t iEntry = iThread_ ; iEntry < nGroups ; iEntry += nThreads_ ){
+      this->evalSplineDialGroup(_splineGroupList_[_dirtySplineGroupList_[iEntry]]);
+    }
+    if( _dialDirectory_.isInitialized() ){
+      _dialDirectory_.evalResponses(_responseList_.data(), _dirtyParameterIndexList_, iThread_, nThreads_);
+    }
+    return;
+  }
+
+  size_t nDials{_dialList_.size()};
+  for( size_t iDial = iThread_ ; iDial < nDials ; iDial += nThreads_ ){
+    if( _isGroupedDialList_[iDial] ) continue;
+    if( Dial::enableMaskCheck and _dialList_[iDial]->isMasked() ){ _responseList_[iDial] = 1; continue; }
+    _responseList_[iDial] = _dialList_[iDial]->fillResponseCache();
+  }
+  size_t nGroups{_splineGroupList_.size()};
+  for( size_t iGroup = iThread_ ; iGroup < nGroups ; iGroup += nThreads_ ){
+    this->evalSplineDialGroup(_splineGroupList_[iGroup]);
+  }
+  if( _dialDirectory_.isInitialized() ){ _dialDirectory_.evalResponses(_responseList_.data(), iThread_, nThreads_); }
+}
+double EventDialCache::computeWeight(SampleDialIndex& sampleIndex_, size_t iEvent_, double treeWeight_){
+  const uint32_t* dialIndex = sampleIndex_.dialIndexList.data();
+  uint32_t iRef = sampleIndex_.offsetList[iEvent_];
+
+  if( not _usePerSetPartialWeights_ ){
+    for( ; iRef < sampleIndex_.offsetList[iEvent_+1] ; iRef++ ){ treeWeight_ *= _responseList_[dialIndex[iRef]]; }
+    return treeWeight_;
+  }
+
+  const uint16_t* setDialCount = &sampleIndex_.setDialCountList[iEvent_*_nbSets_];
+  double* partialWeight = &sampleIndex_.partialWeightList[iEvent_*_nbSets_];
+  for( size_t iSet = 0 ; iSet < _nbSets_ ; iSet++ ){
+    uint32_t refEnd = iRef + setDialCount[iSet];
+    if( _updateSetList_[iSet] ){
+      double partial{1};
+      for( ; iRef < refEnd ; iRef++ ){ partial *= _responseList_[dialIndex[iRef]]; }
+      partialWeight[iSet] = partial;
+    }
+    iRef = refEnd;
+    treeWeight_ *= partialWeight[iSet];
+  }
+  return treeWeight_;
+}
+void EventDialCache::reweightTouchedEvents(int iThread_, int nThreads_){
+  size_t nTouched{_touchedEventList_.size()};
+  size_t nToProcess{nTouched/nThreads_};
+  size_t begin{iThread_*nToProcess};
+  size_t end{begin + nToProcess};
+  if( iThread_+1 == nThreads_ ) end = nTouched;
+  if( begin >= end ) return;
+
+  // first sample of this chunk
+  auto sampleIt = std::upper_bound(
+      _sampleDialIndexList_.begin(), _sampleDialIndexList_.end(), _touchedEventList_[begin],
+      [](uint32_t iEvent_, const SampleDialIndex& s_){ return iEvent_ < s_.globalEventOffset; }
+      ) - 1;
+
+  // bin deltas are only accumulated by this thread: no lock needed
+  double* binDelta = _threadBinDeltaList_[iThread_].data();
+  double* binSumw2Delta = _useFusedFill_ ? _threadBinSumw2DeltaList_[iThread_].data() : nullptr;
+  double absDelta{0};
+  double treeWeight, oldWeight, newWeight;
+  int iBin;
+  for( size_t iEntry = begin ; iEntry < end ; iEntry++ ){
+    uint32_t iGlobal = _touchedEventList_[iEntry];
+    while( sampleIt+1 != _sampleDialIndexList_.end() and iGlobal >= (sampleIt+1)->globalEventOffset ){ ++sampleIt; }
+    size_t iEvent = iGlobal - sampleIt->globalEventOffset;
+
+    auto& columns = sampleIt->samplePtr->eventColumns;
+    if( columns.isBuilt() ){
+      double& weight = columns.getEventWeightList()[iEvent];
+      treeWeight = columns.getTreeWeightList()[iEvent];
+      oldWeight = weight;
+      newWeight = this->computeWeight(*sampleIt, iEvent, treeWeight);
+      iBin = columns.getSampleBinIndexList()[iEvent];
+      weight = newWeight;
+    }
+    else{
+      auto& event = sampleIt->samplePtr->eventList[iEvent];
+      treeWeight = event.getTreeWeight();
+      oldWeight = event.getEventWeight();
+      newWeight = this->computeWeight(*sampleIt, iEvent, treeWeight);
+      iBin = event.getSampleBinIndex();
+      event.setEventWeight(newWeight);
+    }
+    if( iBin < 0 ) continue;
+
+    binDelta[sampleIt->globalBinOffset + iBin] += newWeight - oldWeight;
+    absDelta += std::abs(newWeight - oldWeight);
+    if( binSumw2Delta != nullptr ){
+      binSumw2Delta[sampleIt->globalBinOffset + iBin] +=
+          (newWeight*newWeight - oldWeight*oldWeight) * sampleIt->samplePtr->getSumw2Factor(iEvent, treeWeight);
+    }
+  }
+  _threadAbsDeltaList_[iThread_] += absDelta;
+}
+void EventDialCache::reweightAndFill(int iThread_, int nThreads_){
+  //! Warning: this is the hot loop of the propagation (fused mode)
+  // the accumulators of this thread are rebuilt from scratch: pending deltas are superseded
+  double* binContent = _threadBinDeltaList_[iThread_].data();
+  double* binSumw2 = _threadBinSumw2DeltaList_[iThread_].data();
+  std::fill(_threadBinDeltaList_[iThread_].begin(), _threadBinDeltaList_[iThread_].end(), 0);
+  std::fill(_threadBinSumw2DeltaList_[iThread_].begin(), _threadBinSumw2DeltaList_[iThread_].end(), 0);
+  _threadAbsDeltaList_[iThread_] = 0;
+
+  double weight;
+  int iBin;
+  for( auto& sampleIndex : _sampleDialIndexList_ ){
+    size_t nEvents{sampleIndex.getNbEventsToReweight()};
+    size_t nToProcess{nEvents/nThreads_};
+    size_t begin{iThread_*nToProcess};
+    size_t end{begin + nToProcess};
+    if( iThread_+1 == nThreads_ ) end = nEvents;
+
+    auto* sample = sampleIndex.samplePtr;
+    auto& columns = sample->eventColumns;
+    double* binContentOffset = binContent + sampleIndex.globalBinOffset;
+    double* binSumw2Offset = binSumw2 + sampleIndex.globalBinOffset;
+    for( size_t iEntry = begin ; iEntry < end ; iEntry++ ){
+      size_t iEvent = sampleIndex.isPartitioned ? sampleIndex.dynamicEventIndexList[iEntry] : iEntry;
+      if( columns.isBuilt() ){
+        weight = this->computeWeight(sampleIndex, iEvent, columns.getTreeWeightList()[iEvent]);
+        columns.getEventWeightList()[iEvent] = weight;
+        iBin = columns.getSampleBinIndexList()[iEvent];
+        if( iBin < 0 ) continue;
+        binContentOffset[iBin] += weight;
+        binSumw2Offset[iBin] += weight * weight * sample->getSumw2Factor(iEvent, columns.getTreeWeightList()[iEvent]);
+      }
+      else{
+        auto& event = sample->eventList[iEvent];
+        weight = this->computeWeight(sampleIndex, iEvent, event.getTreeWeight());
+        event.setEventWeight(weight);
+        iBin = event.getSampleBinIndex();
+        if( iBin < 0 ) continue;
+        binContentOffset[iBin] += weight;
+        binSumw2Offset[iBin] += weight * weight * sample->getSumw2Factor(iEvent, event.getTreeWeight());
+      }
+    }
+  }
+
+  if( iThread_ == 0 ){ _hasPendingFullFill_ = true; }
+}
+void EventDialCache::reduceBinContents(int iThread_, int nThreads_){
+  // bins are strided over the threads: each thread sums the accumulators of all threads for its own bins
+  for( auto& sampleIndex : _sampleDialIndexList_ ){
+    auto* sample = sampleIndex.samplePtr;
+    if( sample->isLocked ) continue;
+    auto* binContentArray = sample->histogram->GetArray();
+    auto* binErrorArray = sample->histogram->GetSumw2()->GetArray();
+    size_t nBins{sample->perBinEventPtrList.size()};
+    for( size_t iBin = iThread_ ; iBin < nBins ; iBin += nThreads_ ){
+      size_t iGlobalBin{sampleIndex.globalBinOffset + iBin};
+      double content{0}, sumw2{0};
+      if( sample->isPartitioned() ){
+        content = sample->staticBinContentList[iBin];
+        sumw2 = sample->staticBinSumw2List[iBin];
+      }
+      for( size_t iThread = 0 ; iThread < _threadBinDeltaList_.size() ; iThread++ ){
+        content += _threadBinDeltaList_[iThread][iGlobalBin]; _threadBinDeltaList_[iThread][iGlobalBin] = 0;
+        sumw2 += _threadBinSumw2DeltaList_[iThread][iGlobalBin]; _threadBinSumw2DeltaList_[iThread][iGlobalBin] = 0;
+      }
+      _binContentList_[iGlobalBin] = content;
+      _binSumw2List_[iGlobalBin] = sumw2;
+      binContentArray[iBin + 1] = content; // the rescale is applied afterwards
+      binErrorArray[iBin + 1] = sumw2;
+    }
+  }
+  if( iThread_ == 0 ){
+    for( auto& threadAbsDelta : _threadAbsDeltaList_ ){ threadAbsDelta = 0; }
+    _accumulatedAbsDelta_ = 0;
+    _hasPendingFullFill_ = false;
+    _needFullRefill_ = false;
+    _nbFullRefills_++;
+  }
+}
+
+bool EventDialCache::canUpdateHistogramsIncrementally() const{
+  if( not _useIncrementalHistogramUpdate_ or _needFullRefill_ or not this->isEnabled() ) return false;
+
+  // each accumulation adds at most ~epsilon*|delta| of rounding error
+  double absContent{0};
+  for( auto& content : _binContentList_ ){ absContent += std::abs(content); }
+  double absDelta{_accumulatedAbsDelta_};
+  for( auto& threadAbsDelta : _threadAbsDeltaList_ ){ absDelta += threadAbsDelta; }
+  return std::numeric_limits<double>::epsilon() * absDelta <= _maxHistogramDrift_ * absContent;
+}
+void EventDialCache::updateHistogramsIncrementally(){
+  for( auto& sampleIndex : _sampleDialIndexList_ ){
+    auto* sample = sampleIndex.samplePtr;
+    if( sample->isLocked ) continue;
+    auto* binContentArray = sample->histogram->GetArray();
+    auto* binErrorArray = sample->histogram->GetSumw2()->GetArray();
+    size_t nBins{sample->perBinEventPtrList.size()};
+    for( size_t iBin = 0 ; iBin < nBins ; iBin++ ){
+      double& content = _binContentList_[sampleIndex.globalBinOffset + iBin];
+      for( auto& threadBinDelta : _threadBinDeltaList_ ){
+        content += threadBinDelta[sampleIndex.globalBinOffset + iBin];
+        threadBinDelta[sampleIndex.globalBinOffset + iBin] = 0;
+      }
+      double sumw2{content};
+      if( _useFusedFill_ ){
+        double& sumw2Ref = _binSumw2List_[sampleIndex.globalBinOffset + iBin];
+        for( auto& threadBinSumw2Delta : _threadBinSumw2DeltaList_ ){
+          sumw2Ref += threadBinSumw2Delta[sampleIndex.globalBinOffset + iBin];
+          threadBinSumw2Delta[sampleIndex.globalBinOffset + iBin] = 0;
+        }
+        sumw2 = sumw2Ref;
+      }
+      // same as refillHistogram() + rescaleHistogram()
+      binContentArray[iBin + 1] = content * sample->histScale;
+      binErrorArray[iBin + 1] = sumw2 * sample->histScale * sample->histScale;
+    }
+  }
+  for( auto& threadAbsDelta : _threadAbsDeltaList_ ){ _accumulatedAbsDelta_ += threadAbsDelta; threadAbsDelta = 0; }
+  _nbIncrementalRefills_++;
+}
+void EventDialCache::syncBinContents(int iThread_, int nThreads_){
+  // same bin striding as SampleElement::refillHistogram(): these bins have just been filled by this thread
+  for( auto& sampleIndex : _sampleDialIndexList_ ){
+    auto* binContentArray = sampleIndex.samplePtr->histogram->GetArray();
+    size_t nBins{sampleIndex.samplePtr->perBinEventPtrList.size()};
+    for( size_t iBin = iThread_ ; iBin < nBins ; iBin += nThreads_ ){
+      _binContentList_[sampleIndex.globalBinOffset + iBin] = binContentArray[iBin + 1];
+      for( auto& threadBinDelta : _threadBinDeltaList_ ){ threadBinDelta[sampleIndex.globalBinOffset + iBin] = 0; }
+    }
+  }
+  if( iThread_ == 0 ){
+    for( auto& threadAbsDelta : _threadAbsDeltaList_ ){ threadAbsDelta = 0; }
+    _accumulatedAbsDelta_ = 0;
+    _needFullRefill_ = false;
+    _nbFullRefills_++;
+  }
+}
+
+void EventDialCache::prepareFullUpdate(){
+  // every dial is evaluated at the current parameter values, without consuming their dirty flags: the parameters are
+  // only flagged clean by a regular propagation, and the dials cache their response per parameter value
+  _isPartialUpdate_ = false;
+  _dirtyDialList_.clear();
+  _dirtySplineGroupList_.clear();
+  _dirtyParameterIndexList_.clear();
+  _touchedEventList_.clear();
+  std::fill(_updateSetList_.begin(), _updateSetList_.end(), 1);
+  if( _dialDirectory_.isInitialized() ){ _dialDirectory_.updateParameterValues(); }
+}
+void EventDialCache::saveResponses(){
+  LogThrowIf(not this->isEnabled(), "Can't " << __METHOD_NAME__ << " while the cache is not enabled.");
+  _savedResponseList_ = _responseList_;
+}
+void EventDialCache::restoreResponses(){
+  LogThrowIf(_savedResponseList_.size() != _responseList_.size(), "No saved responses: " << __METHOD_NAME__ << " without saveResponses().");
+  _responseList_.swap(_savedResponseList_);
+  _savedResponseList_.clear();
+}
+
+bool EventDialCache::isPartitionStale() const{
+  if( not _isPartitioned_ ) return false;
+  for( size_t iPar = 0 ; iPar < _parameterList_.size() ; iPar++ ){
+    auto* par = _parameterList_[iPar];
+    bool isStatic = (par->isFixed() or not par->isEnabled()) and not par->getOwner()->isUseEigenDecompInFit();
+    if( isStatic != bool(_isStaticParameterList_[iPar]) ) return true;
+    if( isStatic and par->isDirty() ) return true;
+  }
+  return false;
+}
+void EventDialCache::clearPartition(){
+  for( auto& sampleIndex : _sampleDialIndexList_ ){
+    sampleIndex.isPartitioned = false;
+    std::vector<uint32_t>().swap(sampleIndex.dynamicEventIndexList);
+    sampleIndex.samplePtr->setEventPartition({});
+  }
+  _isStaticParameterList_.clear();
+  _isPartitioned_ = false;
+  this->invalidate();
+}
+void EventDialCache::buildPartition(){
+  LogThrowIf(not _isBuilt_, "Can't " << __METHOD_NAME__ << " before the cache is built.");
+  this->clearPartition();
+
+  // parameters of eigen decomposed sets are moved through the eigen parameters
+  _isStaticParameterList_.resize(_parameterList_.size(), false);
+  std::vector<char> isStaticDialList(_dialList_.size(), false);
+  for( size_t iPar = 0 ; iPar < _parameterList_.size() ; iPar++ ){
+    auto* par = _parameterList_[iPar];
+    _isStaticParameterList_[iPar] = (par->isFixed() or not par->isEnabled()) and not par->getOwner()->isUseEigenDecompInFit();
+    if( not _isStaticParameterList_[iPar] ) continue;
+    for( uint32_t iEntry = _parDialOffsetList_[iPar] ; iEntry < _parDialOffsetList_[iPar+1] ; iEntry++ ){
+      isStaticDialList[_parDialIndexList_[iEntry]] = true;
+    }
+  }
+
+  size_t nStatic{0}; size_t nTotal{0};
+  std::vector<char> isStaticEventList;
+  for( auto& sampleIndex : _sampleDialIndexList_ ){
+    size_t nEvents{sampleIndex.offsetList.size() - 1};
+    isStaticEventList.assign(nEvents, true);
+    for( size_t iEvent = 0 ; iEvent < nEvents ; iEvent++ ){
+      for( uint32_t iRef = sampleIndex.offsetList[iEvent] ; iRef < sampleIndex.offsetList[iEvent+1] ; iRef++ ){
+        if( not isStaticDialList[sampleIndex.dialIndexList[iRef]] ){ isStaticEventList[iEvent] = false; break; }
+      }
+      if( not isStaticEventList[iEvent] ){ sampleIndex.dynamicEventIndexList.emplace_back(uint32_t(iEvent)); }
+    }
+    sampleIndex.dynamicEventIndexList.shrink_to_fit();
+    sampleIndex.isPartitioned = true;
+    sampleIndex.samplePtr->setEventPartition(isStaticEventList);
+    nStatic += nEvents - sampleIndex.dynamicEventIndexList.size();
+    nTotal += nEvents;
+  }
+  _isPartitioned_ = true;
+
+  LogInfo << nStatic << "/" << nTotal << " MC events are static (only depend on fixed or disabled parameters)." << std::endl;
+}
+
+std::string EventDialCache::getUpdateSummary() const{
+  std::stringstream ss;
+  ss << _nbPartialUpdates_ << "/" << _nbUpdates_ << " partial propagations";
+  if( _nbUpdates_ != 0 and not _eventTouchStampList_.empty() ){
+    double nFullEvents = double(_nbUpdates_) * double(_eventTouchStampList_.size());
+    double nDoneEvents = double(_nbUpdates_ - _nbPartialUpdates_) * double(_eventTouchStampList_.size()) + double(_nbReweightedEvents_);
+    ss << ", " << int(100*(1 - nDoneEvents/nFullEvents)) << "% event reweights skipped";
+  }
+  ss << ", " << _nbIncrementalRefills_ << "/" << (_nbIncrementalRefills_ + _nbFullRefills_) << " incremental histogram fills";
+  return ss.str();
+}
+void EventDialCache::reweight(SampleDialIndex& sampleIndex_, size_t beginIndex_, size_t endIndex_){
+  //! Warning: this is the hot loop of the propagation
+  if( sampleIndex_.isPartitioned ){
+    // begin/end are indices in the dynamic event list
+    auto& columns = sampleIndex_.samplePtr->eventColumns;
+    for( size_t iEntry = beginIndex_ ; iEntry < endIndex_ ; iEntry++ ){
+      size_t iEvent = sampleIndex_.dynamicEventIndexList[iEntry];
+      if( columns.isBuilt() ){ columns.getEventWeightList()[iEvent] = this->computeWeight(sampleIndex_, iEvent, columns.getTreeWeightList()[iEvent]); }
+      else{
+        auto& event = sampleIndex_.samplePtr->eventList[iEvent];
+        event.setEventWeight(this->computeWeight(sampleIndex_, iEvent, event.getTreeWeight()));
+      }
+    }
+    return;
+  }
+
+  const uint32_t* offset = &sampleIndex_.offsetList[beginIndex_];
+  const uint32_t* dialIndex = sampleIndex_.dialIndexList.data();
+  const double* response = _responseList_.data();
+
+  if( _usePerSetPartialWeights_ ){
+    auto& columns = sampleIndex_.samplePtr->eventColumns;
+    for( size_t iEvent = beginIndex_ ; iEvent < endIndex_ ; iEvent++ ){
+      if( columns.isBuilt() ){ columns.getEventWeightList()[iEvent] = this->computeWeight(sampleIndex_, iEvent, columns.getTreeWeightList()[iEvent]); }
+      else{
+        auto& event = sampleIndex_.samplePtr->eventList[iEvent];
+        event.setEventWeight(this->computeWeight(sampleIndex_, iEvent, event.getTreeWeight()));
+      }
+    }
+  }
+  else if( sampleIndex_.samplePtr->eventColumns.isBuilt() ){
+    const StorageFloat* treeWeight = sampleIndex_.samplePtr->eventColumns.getTreeWeightList().data();
+    double* eventWeight = sampleIndex_.samplePtr->eventColumns.getEventWeightList().data();
+    for( size_t iEvent = beginIndex_ ; iEvent < endIndex_ ; iEvent++, offset++ ){
+      double weight = treeWeight[iEvent];
+      for( uint32_t iRef = offset[0] ; iRef < offset[1] ; iRef++ ){ weight *= response[dialIndex[iRef]]; }
+      eventWeight[iEvent] = weight;
+    }
+  }
+  else{
+    auto* event = &sampleIndex_.samplePtr->eventList[beginIndex_];
+    for( size_t iEvent = beginIndex_ ; iEvent < endIndex_ ; iEvent++, offset++, event++ ){
+      double weight = event->getTreeWeight();
+      for( uint32_t iRef = offset[0] ; iRef < offset[1] ; iRef++ ){ weight *= response[dialIndex[iRef]]; }
+      event->setEventWeight(weight);
+    }
+  }
+}
+
+size_t EventDialCache::getMemoryUsage() const{
+  size_t out{0};
+  out += _dialList_.capacity() * sizeof(Dial*);
+  out += _responseList_.capacity() * sizeof(double);
+  for( auto& sampleIndex : _sampleDialIndexList_ ){
+    out += (sampleIndex.offsetList.capacity() + sampleIndex.dialIndexList.capacity()) * sizeof(uint32_t);
+    out += sampleIndex.setDialCountList.capacity() * sizeof(uint16_t);
+    out += sampleIndex.partialWeightList.capacity() * sizeof(double);
+  }
+  out += (_dialSetIndexList_.capacity() + _parSetIndexList_.capacity()) * sizeof(uint16_t);
+  out += _parameterList_.capacity() * sizeof(FitParameter*);
+  out += (_parDialOffsetList_.capacity() + _parDialIndexList_.capacity()) * sizeof(uint32_t);
+  out += (_dialEventOffsetList_.capacity() + _dialEventIndexList_.capacity()) * sizeof(uint32_t);
+  out += _eventTouchStampList_.capacity() * sizeof(uint32_t);
+  out += _splineGroupList_.capacity() * sizeof(SplineDialGroup);
+  out += (_parSplineGroupOffsetList_.capacity() + _splineGroupDialList_.capacity() + _splineGroupSlotList_.capacity()) * sizeof(uint32_t);
+  out += _splineGroupResponseList_.capacity() * sizeof(double);
+  out += _isGroupedDialList_.capacity() * sizeof(char);
+  out += _dirtyParameterIndexList_.capacity() * sizeof(uint32_t);
+  out += _dialDirectory_.getMemoryUsage();
+  return out;
+}
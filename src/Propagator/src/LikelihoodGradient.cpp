@@ -0,0 +1,130 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#include "LikelihoodGradient.h"
+#include "GlobalVariables.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+
+LoggerInit([]{ Logger::setUserHeaderStr("[LikelihoodGradient]"); });
+
+
+void LikelihoodGradient::clear(){
+  _dialParIndexList_.clear();
+  _responseDerivativeList_.clear();
+  _binContentDerivativeList_.clear();
+  _binSumw2DerivativeList_.clear();
+  _threadGradientList_.clear();
+  _gradientList_.clear();
+}
+
+void LikelihoodGradient::prepare(){
+  LogThrowIf(not _eventDialCache_.isEnabled(), "Can't " << __METHOD_NAME__ << " while the event dial cache is not enabled.");
+  const auto& parameterList = _eventDialCache_.getParameterList();
+  if( _dialParIndexList_.empty() ){
+    const auto& parDialOffsetList = _eventDialCache_.getParDialOffsetList();
+    const auto& parDialIndexList = _eventDialCache_.getParDialIndexList();
+    _dialParIndexList_.resize(_eventDialCache_.getDialList().size(), 0);
+    for( size_t iPar = 0 ; iPar < parameterList.size() ; iPar++ ){
+      for( uint32_t iEntry = parDialOffsetList[iPar] ; iEntry < parDialOffsetList[iPar+1] ; iEntry++ ){
+        _dialParIndexList_[parDialIndexList[iEntry]] = uint32_t(iPar);
+      }
+    }
+    _responseDerivativeList_.resize(_eventDialCache_.getDialList().size(), 0);
+    _binContentDerivativeList_.resize(_eventDialCache_.getNbBins(), 0);
+    _binSumw2DerivativeList_.resize(_eventDialCache_.getNbBins(), 0);
+    _threadGradientList_.resize(GlobalVariables::getNbThreads());
+  }
+  for( auto& threadGradient : _threadGradientList_ ){ threadGradient.assign(parameterList.size(), 0); }
+  std::fill(_binContentDerivativeList_.begin(), _binContentDerivativeList_.end(), 0);
+  std::fill(_binSumw2DerivativeList_.begin(), _binSumw2DerivativeList_.end(), 0);
+}
+
+void LikelihoodGradient::evalResponseDerivatives(int iThread_, int nThreads_){
+  // same dial striding as EventDialCache::updateResponses(): each dial is handled by a single thread
+  const auto& dialList = _eventDialCache_.getDialList();
+  const auto& parameterList = _eventDialCache_.getParameterList();
+  size_t nDials{dialList.size()};
+  for( size_t iDial = iThread_ ; iDial < nDials ; iDial += nThreads_ ){
+    auto* par = parameterList[_dialParIndexList_[iDial]];
+    if( par->isFixed() or not par->isEnabled()
+        or ( Dial::enableMaskCheck and dialList[iDial]->isMasked() ) ){
+      _responseDerivativeList_[iDial] = 0;
+      continue;
+    }
+    _responseDerivativeList_[iDial] = dialList[iDial]->evalResponseDerivative(par->getParameterValue());
+  }
+}
+void LikelihoodGradient::accumulate(int iThread_, int nThreads_){
+  // the static events only depend on fixed parameters: they don't contribute
+  const double* response = _eventDialCache_.getResponseList().data();
+  const bool isFusedFill{_eventDialCache_.isUseFusedFill()};
+  double* gradient = _threadGradientList_[iThread_].data();
+  std::vector<double> suffixProductList;
+  double treeWeight, weight, llhDerivative, prefixProduct;
+  int iBin;
+  for( const auto& sampleIndex : _eventDialCache_.getSampleDialIndexList() ){
+    const auto* sample = sampleIndex.samplePtr;
+    if( sample->isLocked ) continue;
+    size_t nEvents{sampleIndex.getNbEventsToReweight()};
+    size_t nToProcess{nEvents/nThreads_};
+    size_t begin{iThread_*nToProcess};
+    size_t end{begin + nToProcess};
+    if( iThread_+1 == nThreads_ ) end = nEvents;
+
+    const auto& columns = sample->eventColumns;
+    const uint32_t* dialIndex = sampleIndex.dialIndexList.data();
+    const double* binContentDerivative = &_binContentDerivativeList_[sampleIndex.globalBinOffset];
+    const double* binSumw2Derivative = &_binSumw2DerivativeList_[sampleIndex.globalBinOffset];
+    for( size_t iEntry = begin ; iEntry < end ; iEntry++ ){
+      size_t iEvent = sampleIndex.isPartitioned ? sampleIndex.dynamicEventIndexList[iEntry] : iEntry;
+      if( columns.isBuilt() ){
+        treeWeight = columns.getTreeWeightList()[iEvent];
+        weight = columns.getEventWeightList()[iEvent];
+        iBin = columns.getSampleBinIndexList()[iEvent];
+      }
+      else{
+        const auto& event = sample->eventList[iEvent];
+        treeWeight = event.getTreeWeight();
+        weight = event.getEventWeight();
+        iBin = event.getSampleBinIndex();
+      }
+      if( iBin < 0 ) continue;
+
+      // the bin errors hold the sum of w (or of w^2 in fused mode), see refillHistogram() and reduceBinContents()
+      llhDerivative = binContentDerivative[iBin] + binSumw2Derivative[iBin] * (
+          isFusedFill ? 2 * weight * sample->getSumw2Factor(iEvent, treeWeight) : 1.
+      );
+      if( llhDerivative == 0 ) continue;
+
+      // dw/dp = treeWeight * sum over the dials d of p of: r'_d * (product of the other responses)
+      uint32_t refBegin{sampleIndex.offsetList[iEvent]};
+      size_t nRefs{sampleIndex.offsetList[iEvent+1] - refBegin};
+      suffixProductList.resize(nRefs+1);
+      suffixProductList[nRefs] = 1;
+      for( size_t iRef = nRefs ; iRef > 0 ; iRef-- ){
+        suffixProductList[iRef-1] = suffixProductList[iRef] * response[dialIndex[refBegin+iRef-1]];
+      }
+      prefixProduct = llhDerivative * treeWeight;
+      for( size_t iRef = 0 ; iRef < nRefs ; iRef++ ){
+        uint32_t iDial{dialIndex[refBegin+iRef]};
+        if( _responseDerivativeList_[iDial] != 0 ){
+          gradient[_dialParIndexList_[iDial]] += prefixProduct * _responseDerivativeList_[iDial] * suffixProductList[iRef+1];
+        }
+        prefixProduct *= response[iDial];
+      }
+    }
+  }
+}
+const std::vector<double>& LikelihoodGradient::reduce(){
+  // summed in thread order
+  size_t nPars{_eventDialCache_.getParameterList().size()};
+  _gradientList_.assign(nPars, 0);
+  for( auto& threadGradient : _threadGradientList_ ){
+    for( size_t iPar = 0 ; iPar < nPars ; iPar++ ){ _gradientList_[iPar] += threadGradient[iPar]; }
+  }
+  return _gradientList_;
+}
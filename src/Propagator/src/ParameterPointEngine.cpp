@@ -0,0 +1,151 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#include "ParameterPointEngine.h"
+#include "GlobalVariables.h"
+
+#include "Logger.h"
+
+LoggerInit([]{ Logger::setUserHeaderStr("[ParameterPointEngine]"); });
+
+
+void ParameterPointEngine::clear(){
+  _firstChunkPoint_ = 0;
+  _nbChunkPoints_ = 0;
+  _isChunkStatic_ = true;
+  _storeEventWeights_ = false;
+  _pointResponseList_.clear();
+  _threadPointBinList_.clear();
+  _threadPointBinSumw2List_.clear();
+  _pointBinContentList_.clear();
+  _pointBinSumw2List_.clear();
+  _pointEventWeightList_.clear();
+}
+
+void ParameterPointEngine::clearPoints(size_t nPoints_, bool storeEventWeights_){
+  LogThrowIf(not _eventDialCache_.isEnabled(), "Can't " << __METHOD_NAME__ << " while the event dial cache is not enabled.");
+  size_t nBins{_eventDialCache_.getNbBins()};
+  _storeEventWeights_ = storeEventWeights_;
+  _pointBinContentList_.resize(nPoints_);
+  _pointBinSumw2List_.resize(nPoints_);
+  for( size_t iPoint = 0 ; iPoint < nPoints_ ; iPoint++ ){
+    _pointBinContentList_[iPoint].assign(nBins, 0);
+    _pointBinSumw2List_[iPoint].assign(nBins, 0);
+  }
+  if( _storeEventWeights_ ){
+    _pointEventWeightList_.resize(nPoints_);
+    for( auto& pointEventWeight : _pointEventWeightList_ ){ pointEventWeight.assign(_eventDialCache_.getNbEvents(), 0); }
+  }
+  else{ _pointEventWeightList_.clear(); }
+}
+void ParameterPointEngine::beginChunk(size_t firstPoint_, size_t nChunkPoints_){
+  LogThrowIf(firstPoint_ + nChunkPoints_ > _pointBinContentList_.size(), "Point chunk out of range.");
+  size_t nBins{_eventDialCache_.getNbBins()};
+  _firstChunkPoint_ = firstPoint_;
+  _nbChunkPoints_ = nChunkPoints_;
+  _isChunkStatic_ = not _storeEventWeights_; // the weights of the static events are needed too
+  _pointResponseList_.assign(_eventDialCache_.getDialList().size() * _nbChunkPoints_, 1);
+  _threadPointBinList_.resize(GlobalVariables::getNbThreads());
+  _threadPointBinSumw2List_.resize(GlobalVariables::getNbThreads());
+  for( auto& threadPointBin : _threadPointBinList_ ){ threadPointBin.assign(nBins * _nbChunkPoints_, 0); }
+  for( auto& threadPointBinSumw2 : _threadPointBinSumw2List_ ){ threadPointBinSumw2.assign(nBins * _nbChunkPoints_, 0); }
+}
+void ParameterPointEngine::storeResponses(size_t iChunkPoint_){
+  // the parameters are only flagged clean by a regular propagation
+  if( _eventDialCache_.isPartitionStale() ){ _isChunkStatic_ = false; }
+
+  const auto& responseList = _eventDialCache_.getResponseList();
+  size_t nDials{responseList.size()};
+  for( size_t iDial = 0 ; iDial < nDials ; iDial++ ){
+    _pointResponseList_[iDial*_nbChunkPoints_ + iChunkPoint_] = responseList[iDial];
+  }
+}
+
+void ParameterPointEngine::fill(int iThread_, int nThreads_){
+  //! Warning: hot loop, each event and each of its dial ids is read once for all the points of the chunk
+  const size_t nPoints{_nbChunkPoints_};
+  const bool isFusedFill{_eventDialCache_.isUseFusedFill()};
+  const double* pointResponse = _pointResponseList_.data();
+  double* binContent = _threadPointBinList_[iThread_].data();
+  double* binSumw2 = _threadPointBinSumw2List_[iThread_].data();
+  double* const* pointEventWeight{nullptr};
+  std::vector<double*> pointEventWeightPtrList;
+  if( _storeEventWeights_ ){
+    for( size_t iPoint = 0 ; iPoint < nPoints ; iPoint++ ){
+      pointEventWeightPtrList.emplace_back(_pointEventWeightList_[_firstChunkPoint_ + iPoint].data());
+    }
+    pointEventWeight = pointEventWeightPtrList.data();
+  }
+  std::vector<double> weightList(nPoints);
+  double* weight = weightList.data();
+
+  double treeWeight, sumw2Factor;
+  int iBin;
+  for( const auto& sampleIndex : _eventDialCache_.getSampleDialIndexList() ){
+    const auto* sample = sampleIndex.samplePtr;
+    if( sample->isLocked ) continue;
+    bool useDynamicEvents{sampleIndex.isPartitioned and _isChunkStatic_};
+    size_t nEvents{useDynamicEvents ? sampleIndex.dynamicEventIndexList.size() : sampleIndex.offsetList.size() - 1};
+    size_t nToProcess{nEvents/nThreads_};
+    size_t begin{iThread_*nToProcess};
+    size_t end{begin + nToProcess};
+    if( iThread_+1 == nThreads_ ) end = nEvents;
+
+    const auto& columns = sample->eventColumns;
+    const uint32_t* dialIndex = sampleIndex.dialIndexList.data();
+    for( size_t iEntry = begin ; iEntry < end ; iEntry++ ){
+      size_t iEvent = useDynamicEvents ? sampleIndex.dynamicEventIndexList[iEntry] : iEntry;
+      if( columns.isBuilt() ){
+        treeWeight = columns.getTreeWeightList()[iEvent];
+        iBin = columns.getSampleBinIndexList()[iEvent];
+      }
+      else{
+        treeWeight = sample->eventList[iEvent].getTreeWeight();
+        iBin = sample->eventList[iEvent].getSampleBinIndex();
+      }
+      if( iBin < 0 and pointEventWeight == nullptr ) continue;
+
+      for( size_t iPoint = 0 ; iPoint < nPoints ; iPoint++ ){ weight[iPoint] = treeWeight; }
+      for( uint32_t iRef = sampleIndex.offsetList[iEvent] ; iRef < sampleIndex.offsetList[iEvent+1] ; iRef++ ){
+        const double* response = &pointResponse[dialIndex[iRef]*nPoints];
+        for( size_t iPoint = 0 ; iPoint < nPoints ; iPoint++ ){ weight[iPoint] *= response[iPoint]; }
+      }
+      if( pointEventWeight != nullptr ){
+        for( size_t iPoint = 0 ; iPoint < nPoints ; iPoint++ ){ pointEventWeight[iPoint][sampleIndex.globalEventOffset + iEvent] = weight[iPoint]; }
+        if( iBin < 0 ) continue;
+      }
+
+      double* content = &binContent[(sampleIndex.globalBinOffset + iBin)*nPoints];
+      for( size_t iPoint = 0 ; iPoint < nPoints ; iPoint++ ){ content[iPoint] += weight[iPoint]; }
+      if( isFusedFill ){
+        sumw2Factor = sample->getSumw2Factor(iEvent, treeWeight);
+        double* sumw2 = &binSumw2[(sampleIndex.globalBinOffset + iBin)*nPoints];
+        for( size_t iPoint = 0 ; iPoint < nPoints ; iPoint++ ){ sumw2[iPoint] += weight[iPoint] * weight[iPoint] * sumw2Factor; }
+      }
+    }
+  }
+}
+void ParameterPointEngine::reduce(int iThread_, int nThreads_){
+  // same bin striding as EventDialCache::reduceBinContents(), the sums of w^2 are the ones the histograms would hold
+  const bool isFusedFill{_eventDialCache_.isUseFusedFill()};
+  for( const auto& sampleIndex : _eventDialCache_.getSampleDialIndexList() ){
+    const auto* sample = sampleIndex.samplePtr;
+    if( sample->isLocked ) continue;
+    bool addStatic{sample->isPartitioned() and _isChunkStatic_};
+    size_t nBins{sample->perBinEventPtrList.size()};
+    for( size_t iBin = iThread_ ; iBin < nBins ; iBin += nThreads_ ){
+      size_t iGlobalBin{sampleIndex.globalBinOffset + iBin};
+      for( size_t iPoint = 0 ; iPoint < _nbChunkPoints_ ; iPoint++ ){
+        double content{addStatic ? sample->staticBinContentList[iBin] : 0};
+        double sumw2{addStatic ? sample->staticBinSumw2List[iBin] : 0};
+        for( size_t iThread = 0 ; iThread < _threadPointBinList_.size() ; iThread++ ){
+          content += _threadPointBinList_[iThread][iGlobalBin*_nbChunkPoints_ + iPoint];
+          sumw2 += _threadPointBinSumw2List_[iThread][iGlobalBin*_nbChunkPoints_ + iPoint];
+        }
+        _pointBinContentList_[_firstChunkPoint_ + iPoint][iGlobalBin] = content;
+        _pointBinSumw2List_[_firstChunkPoint_ + iPoint][iGlobalBin] = isFusedFill ? sumw2 : content;
+      }
+    }
+  }
+}
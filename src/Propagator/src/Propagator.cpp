@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <vector>
+#include <algorithm>
 
 LoggerInit([]{
   Logger::setUserHeaderStr("[Propagator]");
@@ -38,6 +39,8 @@ void Propagator::reset() {
        or jobName == "Propagator::reweightMcEvents"
        or jobName == "Propagator::updateDialResponses"
        or jobName == "Propagator::refillSampleHistograms"
+       or jobName == "Propagator::reweightAndFill"
+       or jobName == "Propagator::reduceSampleHistograms"
        or jobName == "Propagator::applyResponseFunctions"
         ){
       jobNameRemoveList.emplace_back(jobName);
@@ -49,6 +52,9 @@ void Propagator::reset() {
 
   _responseFunctionsSamplesMcHistogram_.clear();
   _nominalSamplesMcHistogram_.clear();
+  _eventDialCache_.clear();
+  _likelihoodGradient_.clear();
+  _parameterPointEngine_.clear();
 }
 
 void Propagator::setShowTimeStats(bool showTimeStats) {
@@ -76,6 +82,36 @@ void Propagator::initialize() {
 
   // Monitoring parameters
   _showEventBreakdown_ = JsonUtils::fetchValue(_config_, "showEventBreakdown", _showEventBreakdown_);
+  _useColumnarEventStore_ = JsonUtils::fetchValue(_config_, "useColumnarEventStore", _useColumnarEventStore_);
+  _mergeEquivalentEvents_ = JsonUtils::fetchValue(_config_, "mergeEquivalentEvents", _mergeEquivalentEvents_);
+  _sortEventsByBin_ = JsonUtils::fetchValue(_config_, "sortEventsByBin", _sortEventsByBin_);
+#ifdef GUNDAM_USING_CACHE_MANAGER
+  if( GlobalVariables::getEnableCacheManager() ){ _useEventDialCache_ = false; } // the GPU does the dial evaluation
+#endif
+  _useEventDialCache_ = JsonUtils::fetchValue(_config_, "useEventDialCache", _useEventDialCache_);
+  _validateEventDialCache_ = JsonUtils::fetchValue(_config_, "validateEventDialCache", _validateEventDialCache_);
+  _useDirtyParameterTracking_ = JsonUtils::fetchValue(_config_, "useDirtyParameterTracking", _useDirtyParameterTracking_);
+  _useFusedReweightAndFill_ = JsonUtils::fetchValue(_config_, "useFusedReweightAndFill", _useFusedReweightAndFill_);
+  _useStaticEventPartition_ = JsonUtils::fetchValue(_config_, "useStaticEventPartition", _useStaticEventPartition_);
+  _usePerSetPartialWeights_ = JsonUtils::fetchValue(_config_, "usePerSetPartialWeights", _usePerSetPartialWeights_);
+  _useIncrementalHistogramUpdate_ = JsonUtils::fetchValue(_config_, "useIncrementalHistogramUpdate", _useIncrementalHistogramUpdate_);
+  _useSplineBatchEval_ = JsonUtils::fetchValue(_config_, "useSplineBatchEval", _useSplineBatchEval_);
+  _useDialDirectory_ = JsonUtils::fetchValue(_config_, "useDialDirectory", _useDialDirectory_);
+  _maxIncrementalHistogramDrift_ = JsonUtils::fetchValue(_config_, "maxIncrementalHistogramDrift", _maxIncrementalHistogramDrift_);
+  _nbPointsPerPass_ = JsonUtils::fetchValue(_config_, "nbPointsPerPass", _nbPointsPerPass_);
+  _releaseEventDialPtrLists_ = JsonUtils::fetchValue(_config_, "releaseEventDialPtrLists", _releaseEventDialPtrLists_);
+  _slimSplineDials_ = JsonUtils::fetchValue(_config_, "slimSplineDials", _slimSplineDials_);
+  _validateFloatStorage_ = JsonUtils::fetchValue(_config_, "validateFloatStorage", _validateFloatStorage_);
+#ifdef GUNDAM_USING_CACHE_MANAGER
+  LogThrowIf(_useColumnarEventStore_ and GlobalVariables::getEnableCacheManager(),
+             "useColumnarEventStore can't be used while the Cache::Manager is enabled.");
+  LogThrowIf(_useEventDialCache_ and GlobalVariables::getEnableCacheManager(),
+             "useEventDialCache can't be used while the Cache::Manager is enabled.");
+  LogThrowIf(_mergeEquivalentEvents_ and GlobalVariables::getEnableCacheManager(),
+             "mergeEquivalentEvents can't be used while the Cache::Manager is enabled.");
+  LogThrowIf(_slimSplineDials_ and GlobalVariables::getEnableCacheManager(),
+             "slimSplineDials can't be used while the Cache::Manager is enabled.");
+#endif
 
   LogInfo << std::endl << GenericToolbox::addUpDownBars("Initializing parameters...") << std::endl;
   auto parameterSetListConfig = JsonUtils::fetchValue(_config_, "parameterSetListConfig", nlohmann::json());
@@ -233,10 +269,13 @@ void Propagator::initialize() {
     }
   }
 
-//  if( GlobalVariables::isEnableDevMode() ){
-//    LogInfo << "Loading dials stack..." << std::endl;
-//    fillDialsStack();
-//  }
+  if( _sortEventsByBin_ ){
+    // before anything keeps pointers to the events
+    for( auto& sample : _fitSampleSet_.getFitSampleList() ){
+      sample.getMcContainer().sortEventsByBin();
+      sample.getDataContainer().sortEventsByBin();
+    }
+  }
 
 #ifdef GUNDAM_USING_CACHE_MANAGER
   // After all of the data has been loaded.  Specifically, this must be after
@@ -308,12 +347,57 @@ void Propagator::initialize() {
     t.printTable();
   }
 
+  if( _mergeEquivalentEvents_ ){
+    LogInfo << "Merging equivalent MC events..." << std::endl;
+    for( auto& sample : _fitSampleSet_.getFitSampleList() ){ sample.getMcContainer().mergeEquivalentEvents(); }
+  }
+
   _plotGenerator_.setFitSampleSetPtr(&_fitSampleSet_);
   _plotGenerator_.defineHistogramHolders();
 
   LogInfo << "Filling up sample bin caches..." << std::endl;
   _fitSampleSet_.updateSampleBinEventList();
 
+  if( _useColumnarEventStore_ ){
+    // Only the MC gets reweighted. With the event dial cache, the columns don't need their own dial ranges: the
+    // legacy evaluation (setEnableEventDialCache(false)) then goes through the PhysicsEvent dial lists.
+    for( auto& sample : _fitSampleSet_.getFitSampleList() ){
+      sample.getMcContainer().buildEventColumns(not _useEventDialCache_);
+    }
+  }
+
+  if( _slimSplineDials_ or (_useEventDialCache_ and (_useSplineBatchEval_ or _useDialDirectory_)) ){
+    // all the dials are initialized at this point: TSpline3 objects are only rebuilt on demand (writeSpline)
+    // The batched spline evaluation and the DialDirectory read the packed data in place.
+    LogInfo << "Packing the spline dial data" << (_slimSplineDials_ ? " and releasing the TSpline3 objects" : "") << "..." << std::endl;
+    for( auto& parSet : _parameterSetsList_ ){
+      for( auto& par : parSet.getParameterList() ){
+        for( auto& dialSet : par.getDialSetList() ){ dialSet.packSplineData(_slimSplineDials_); }
+      }
+    }
+  }
+
+  if( _useEventDialCache_ ){
+    LogInfo << "Building the event dial cache..." << std::endl;
+    _eventDialCache_.setUseDirtyParameterTracking(_useDirtyParameterTracking_);
+    _eventDialCache_.setUsePerSetPartialWeights(_usePerSetPartialWeights_);
+    _eventDialCache_.setUseFusedFill(_useFusedReweightAndFill_);
+    _eventDialCache_.setUseIncrementalHistogramUpdate(_useIncrementalHistogramUpdate_);
+    _eventDialCache_.setMaxHistogramDrift(_maxIncrementalHistogramDrift_);
+    _eventDialCache_.setUseSplineBatchEval(_useSplineBatchEval_);
+    _eventDialCache_.setUseDialDirectory(_useDialDirectory_);
+    _eventDialCache_.build(_fitSampleSet_);
+    if( _validateEventDialCache_ ){ this->validateEventDialCache(); }
+    if( _validateFloatStorage_ ){ this->validateFloatStorage(); }
+    if( _releaseEventDialPtrLists_ ){ _eventDialCache_.releaseEventDialPtrLists(); }
+  }
+  else if( _validateFloatStorage_ ){ this->validateFloatStorage(); }
+
+  if( _useStaticEventPartition_ ){
+    LogThrowIf(not _eventDialCache_.isEnabled(), "useStaticEventPartition requires useEventDialCache.");
+    this->updateEventPartition();
+  }
+
   LogInfo << "Filling up sample histograms..." << std::endl;
   _fitSampleSet_.updateSampleHistograms();
 
@@ -322,6 +406,7 @@ void Propagator::initialize() {
     if( _throwAsimovToyParameters_ and _enableStatThrowInToys_ ){ sample.getDataContainer().throwStatError(); }
     sample.getDataContainer().isLocked = true;
   }
+  _fitSampleSet_.cacheLikelihoodDataTerms();
 
   _useResponseFunctions_ = JsonUtils::fetchValue<nlohmann::json>(_config_, "DEV_useResponseFunctions", false);
   if( _useResponseFunctions_ ){ this->makeResponseFunctions(); }
@@ -375,7 +460,6 @@ void Propagator::propagateParametersOnSamples(){
   }
 
   if(not _useResponseFunctions_ or not _isRfPropagationEnabled_ ){
-//    if(GlobalVariables::isEnableDevMode()) updateDialResponses();
     reweightMcEvents();
     refillSampleHistograms();
   }
@@ -417,8 +501,26 @@ void Propagator::reweightMcEvents() {
   usedGPU = Cache::Manager::Fill();
 #endif
   if( not usedGPU ){
+    if( _eventDialCache_.isEnabled() ){
+      if( _eventDialCache_.isPartitionStale() ){ this->updateEventPartition(); }
+      _eventDialCache_.prepareUpdate();
+      this->updateDialResponses();
+    }
     GenericToolbox::getElapsedTimeSinceLastCallInMicroSeconds(__METHOD_NAME__);
-    GlobalVariables::getParallelWorker().runJob("Propagator::reweightMcEvents");
+    if( _eventDialCache_.isEnabled() and _eventDialCache_.isUseFusedFill()
+        and ( not _eventDialCache_.isPartialUpdate() or not _eventDialCache_.canUpdateHistogramsIncrementally() ) ){
+      // the bin contents are accumulated in the same pass. A partial update is only worth it if its deltas
+      // (w and w^2) can be applied to the histograms, otherwise a full fill would follow anyway.
+      GlobalVariables::getParallelWorker().runJob("Propagator::reweightAndFill");
+    }
+    else{
+      GlobalVariables::getParallelWorker().runJob("Propagator::reweightMcEvents");
+    }
+  }
+
+  // The current parameter values are now propagated
+  for( auto& parSet : _parameterSetsList_ ){
+    for( auto& par : parSet.getParameterList() ){ par.setIsDirty(false); }
   }
   weightProp.counts++;
   weightProp.cumulated += GenericToolbox::getElapsedTimeSinceLastCallInMicroSeconds(__METHOD_NAME__);
@@ -426,7 +528,16 @@ void Propagator::reweightMcEvents() {
 
 void Propagator::refillSampleHistograms(){
   GenericToolbox::getElapsedTimeSinceLastCallInMicroSeconds(__METHOD_NAME__);
-  GlobalVariables::getParallelWorker().runJob("Propagator::refillSampleHistograms");
+  if( _eventDialCache_.isEnabled() and _eventDialCache_.hasPendingFullFill() ){
+    GlobalVariables::getParallelWorker().runJob("Propagator::reduceSampleHistograms");
+  }
+  else if( _eventDialCache_.canUpdateHistogramsIncrementally() ){ _eventDialCache_.updateHistogramsIncrementally(); }
+  else if( _eventDialCache_.isEnabled() and _eventDialCache_.isUseFusedFill() ){
+    // the partial update drifted too much: the weights are up-to-date, but that's the only way to get the w^2 sums
+    GlobalVariables::getParallelWorker().runJob("Propagator::reweightAndFill");
+    GlobalVariables::getParallelWorker().runJob("Propagator::reduceSampleHistograms");
+  }
+  else{ GlobalVariables::getParallelWorker().runJob("Propagator::refillSampleHistograms"); }
   fillProp.counts++; fillProp.cumulated += GenericToolbox::getElapsedTimeSinceLastCallInMicroSeconds(__METHOD_NAME__);
 }
 
@@ -436,6 +547,214 @@ void Propagator::applyResponseFunctions(){
   applyRf.counts++; applyRf.cumulated += GenericToolbox::getElapsedTimeSinceLastCallInMicroSeconds(__METHOD_NAME__);
 }
 
+bool Propagator::canEvalLikelihoodGradient() const{
+  if( not _eventDialCache_.isEnabled() or _useResponseFunctions_ ) return false;
+#ifdef GUNDAM_USING_CACHE_MANAGER
+  if( Cache::Manager::Get() != nullptr ) return false; // the event weights are computed elsewhere
+#endif
+  return _fitSampleSet_.canEvalLikelihoodBinDerivatives();
+}
+void Propagator::evalLikelihoodGradient(){
+  LogThrowIf(not this->canEvalLikelihoodGradient(), "The likelihood gradient can't be computed with this configuration.");
+  GenericToolbox::getElapsedTimeSinceLastCallInMicroSeconds(__METHOD_NAME__);
+
+  // dLLH/d(bin) wrt the unscaled bins: the histograms are scaled by histScale, their sum of w^2 by histScale^2
+  _likelihoodGradient_.prepare();
+  auto& binContentDerivativeList = _likelihoodGradient_.getBinContentDerivativeList();
+  auto& binSumw2DerivativeList = _likelihoodGradient_.getBinSumw2DerivativeList();
+  auto& fitSampleList = _fitSampleSet_.getFitSampleList();
+  for( auto& sampleIndex : _eventDialCache_.getSampleDialIndexList() ){
+    auto* mcContainer = sampleIndex.samplePtr;
+    auto sampleIt = std::find_if(fitSampleList.begin(), fitSampleList.end(), [&](const FitSample& sample_){
+      return &sample_.getMcContainer() == mcContainer;
+    });
+    if( sampleIt == fitSampleList.end() or mcContainer->isLocked ) continue;
+
+    size_t nBins{mcContainer->perBinEventPtrList.size()};
+    double* binContentDerivative = &binContentDerivativeList[sampleIndex.globalBinOffset];
+    double* binSumw2Derivative = &binSumw2DerivativeList[sampleIndex.globalBinOffset];
+    _fitSampleSet_.evalLikelihoodBinDerivatives(sampleIt - fitSampleList.begin(), binContentDerivative, binSumw2Derivative);
+    for( size_t iBin = 0 ; iBin < nBins ; iBin++ ){
+      binContentDerivative[iBin] *= mcContainer->histScale;
+      binSumw2Derivative[iBin] *= mcContainer->histScale * mcContainer->histScale;
+    }
+  }
+
+  GlobalVariables::getParallelWorker().runJob("Propagator::evalResponseDerivatives");
+  GlobalVariables::getParallelWorker().runJob("Propagator::accumulateLikelihoodGradient");
+  auto& gradient = _likelihoodGradient_.reduce();
+
+  _llhGradientList_.resize(_parameterSetsList_.size());
+  for( size_t iParSet = 0 ; iParSet < _parameterSetsList_.size() ; iParSet++ ){
+    _llhGradientList_[iParSet].assign(_parameterSetsList_[iParSet].getParameterList().size(), 0);
+  }
+  auto& parList = _eventDialCache_.getParameterList();
+  for( size_t iPar = 0 ; iPar < parList.size() ; iPar++ ){
+    size_t iParSet = parList[iPar]->getOwner() - &_parameterSetsList_[0];
+    _llhGradientList_[iParSet][parList[iPar]->getParameterIndex()] += gradient[iPar];
+  }
+
+  gradientProp.counts++; gradientProp.cumulated += GenericToolbox::getElapsedTimeSinceLastCallInMicroSeconds(__METHOD_NAME__);
+}
+
+bool Propagator::canPropagateParameterPoints() const{
+  if( not _eventDialCache_.isEnabled() or _useResponseFunctions_ ) return false;
+#ifdef GUNDAM_USING_CACHE_MANAGER
+  if( Cache::Manager::Get() != nullptr ) return false; // the event weights are computed elsewhere
+#endif
+  return true;
+}
+Propagator::ParameterState Propagator::getParameterState(){
+  ParameterState out;
+  for( auto& parSet : _parameterSetsList_ ){
+    out.valueList.emplace_back();
+    out.dirtyList.emplace_back();
+    for( auto& par : parSet.getParameterList() ){
+      out.valueList.back().emplace_back(par.getParameterValue());
+      out.dirtyList.back().emplace_back(par.isDirty());
+    }
+    out.eigenValueList.emplace_back();
+    out.eigenDirtyList.emplace_back();
+    if( not parSet.isUseEigenDecompInFit() ) continue;
+    for( auto& eigenPar : parSet.getEigenParameterList() ){
+      out.eigenValueList.back().emplace_back(eigenPar.getParameterValue());
+      out.eigenDirtyList.back().emplace_back(eigenPar.isDirty());
+    }
+  }
+  return out;
+}
+void Propagator::restoreParameterState(const ParameterState& state_){
+  LogThrowIf(state_.valueList.size() != _parameterSetsList_.size(), "Parameter state size mismatch.");
+  auto restoreList = [](std::vector<FitParameter>& parList_, const std::vector<double>& valueList_, const std::vector<char>& dirtyList_){
+    for( size_t iPar = 0 ; iPar < valueList_.size() ; iPar++ ){
+      parList_[iPar].setParameterValue(valueList_[iPar]);
+      parList_[iPar].setIsDirty(dirtyList_[iPar]);
+    }
+  };
+  for( size_t iParSet = 0 ; iParSet < _parameterSetsList_.size() ; iParSet++ ){
+    auto& parSet = _parameterSetsList_[iParSet];
+    LogThrowIf(state_.valueList[iParSet].size() != parSet.getParameterList().size(), "Parameter state size mismatch for \"" << parSet.getName() << "\".");
+    restoreList(parSet.getParameterList(), state_.valueList[iParSet], state_.dirtyList[iParSet]);
+    if( parSet.isUseEigenDecompInFit() ){
+      LogThrowIf(state_.eigenValueList[iParSet].size() != parSet.getEigenParameterList().size(), "Eigen parameter state size mismatch for \"" << parSet.getName() << "\".");
+      restoreList(parSet.getEigenParameterList(), state_.eigenValueList[iParSet], state_.eigenDirtyList[iParSet]);
+    }
+  }
+}
+std::vector<std::vector<double>> Propagator::getParameterPoint(){
+  // propagateEigenToOriginal() moves the original parameters: they are put back afterwards
+  auto parState = this->getParameterState();
+  std::vector<std::vector<double>> out(_parameterSetsList_.size());
+  for( size_t iParSet = 0 ; iParSet < _parameterSetsList_.size() ; iParSet++ ){
+    auto& parSet = _parameterSetsList_[iParSet];
+    if( parSet.isUseEigenDecompInFit() ) parSet.propagateEigenToOriginal();
+    for( auto& par : parSet.getParameterList() ){ out[iParSet].emplace_back(par.getParameterValue()); }
+  }
+  this->restoreParameterState(parState);
+  return out;
+}
+void Propagator::propagateParameterPoints(const std::vector<std::vector<std::vector<double>>>& pointList_, bool storeEventWeights_){
+  LogThrowIf(not this->canPropagateParameterPoints(), "The parameter points can't be propagated with this configuration.");
+  LogThrowIf(_nbPointsPerPass_ < 1, GET_VAR_NAME_VALUE(_nbPointsPerPass_));
+  GenericToolbox::getElapsedTimeSinceLastCallInMicroSeconds(__METHOD_NAME__);
+
+  // the parameters are restored afterwards, with their dirty flags (partial propagation, static partition check)
+  auto parState = this->getParameterState();
+  auto setParameterPoint = [&](const std::vector<std::vector<double>>& point_){
+    LogThrowIf(point_.size() != _parameterSetsList_.size(), "Parameter point size mismatch.");
+    for( size_t iParSet = 0 ; iParSet < _parameterSetsList_.size() ; iParSet++ ){
+      auto& parList = _parameterSetsList_[iParSet].getParameterList();
+      LogThrowIf(point_[iParSet].size() != parList.size(), "Parameter point size mismatch for \"" << _parameterSetsList_[iParSet].getName() << "\".");
+      for( size_t iPar = 0 ; iPar < parList.size() ; iPar++ ){ parList[iPar].setParameterValue(point_[iParSet][iPar]); }
+    }
+  };
+
+  // the dial responses of the last propagation are put back afterwards: the next propagation can be a partial one
+  _parameterPointEngine_.clearPoints(pointList_.size(), storeEventWeights_);
+  _eventDialCache_.saveResponses();
+  for( size_t firstPoint = 0 ; firstPoint < pointList_.size() ; firstPoint += _nbPointsPerPass_ ){
+    size_t nChunkPoints{std::min(size_t(_nbPointsPerPass_), pointList_.size() - firstPoint)};
+    _parameterPointEngine_.beginChunk(firstPoint, nChunkPoints);
+    for( size_t iChunkPoint = 0 ; iChunkPoint < nChunkPoints ; iChunkPoint++ ){
+      setParameterPoint(pointList_[firstPoint + iChunkPoint]);
+      _eventDialCache_.prepareFullUpdate();
+      this->updateDialResponses();
+      _parameterPointEngine_.storeResponses(iChunkPoint);
+    }
+    GlobalVariables::getParallelWorker().runJob("Propagator::fillParameterPoints");
+    GlobalVariables::getParallelWorker().runJob("Propagator::reduceParameterPoints");
+  }
+  _eventDialCache_.restoreResponses();
+
+  this->restoreParameterState(parState);
+  pointProp.counts++; pointProp.cumulated += GenericToolbox::getElapsedTimeSinceLastCallInMicroSeconds(__METHOD_NAME__);
+}
+void Propagator::loadPointHistograms(size_t iPoint_){
+  auto& binContentList = _parameterPointEngine_.getPointBinContentList();
+  auto& binSumw2List = _parameterPointEngine_.getPointBinSumw2List();
+  LogThrowIf(iPoint_ >= binContentList.size(), "No propagated point #" << iPoint_);
+
+  auto& sampleIndexList = _eventDialCache_.getSampleDialIndexList();
+  if( _nominalHistogramList_.empty() ){
+    // saved for restoreNominalSamples()
+    _nominalHistogramList_.resize(sampleIndexList.size());
+    for( size_t iSample = 0 ; iSample < sampleIndexList.size() ; iSample++ ){
+      auto* sample = sampleIndexList[iSample].samplePtr;
+      size_t nBins{sample->perBinEventPtrList.size()};
+      auto& nominalHistogram = _nominalHistogramList_[iSample];
+      nominalHistogram.assign(sample->histogram->GetArray() + 1, sample->histogram->GetArray() + 1 + nBins);
+      nominalHistogram.insert(nominalHistogram.end(), sample->histogram->GetSumw2()->GetArray() + 1, sample->histogram->GetSumw2()->GetArray() + 1 + nBins);
+    }
+  }
+
+  // same as a refill + rescale
+  for( auto& sampleIndex : sampleIndexList ){
+    auto* sample = sampleIndex.samplePtr;
+    if( sample->isLocked ) continue;
+    auto* binContentArray = sample->histogram->GetArray();
+    auto* binErrorArray = sample->histogram->GetSumw2()->GetArray();
+    size_t nBins{sample->perBinEventPtrList.size()};
+    for( size_t iBin = 0 ; iBin < nBins ; iBin++ ){
+      binContentArray[iBin + 1] = binContentList[iPoint_][sampleIndex.globalBinOffset + iBin] * sample->histScale;
+      binErrorArray[iBin + 1] = binSumw2List[iPoint_][sampleIndex.globalBinOffset + iBin] * sample->histScale * sample->histScale;
+    }
+  }
+}
+void Propagator::loadPointEventWeights(size_t iPoint_){
+  auto& eventWeightList = _parameterPointEngine_.getPointEventWeightList();
+  LogThrowIf(iPoint_ >= eventWeightList.size(), "No event weights stored for point #" << iPoint_);
+
+  auto& sampleIndexList = _eventDialCache_.getSampleDialIndexList();
+  bool saveNominal{_nominalEventWeightList_.empty()}; // for restoreNominalSamples()
+  if( saveNominal ){ _nominalEventWeightList_.resize(sampleIndexList.size()); }
+  for( size_t iSample = 0 ; iSample < sampleIndexList.size() ; iSample++ ){
+    auto* sample = sampleIndexList[iSample].samplePtr;
+    if( sample->isLocked ) continue;
+    const double* pointEventWeight = &eventWeightList[iPoint_][sampleIndexList[iSample].globalEventOffset];
+    for( size_t iEvent = 0 ; iEvent < sample->eventList.size() ; iEvent++ ){
+      if( saveNominal ){ _nominalEventWeightList_[iSample].emplace_back(sample->eventList[iEvent].getEventWeight()); }
+      sample->eventList[iEvent].setEventWeight(pointEventWeight[iEvent]);
+    }
+  }
+}
+void Propagator::restoreNominalSamples(){
+  auto& sampleIndexList = _eventDialCache_.getSampleDialIndexList();
+  for( size_t iSample = 0 ; iSample < _nominalHistogramList_.size() ; iSample++ ){
+    auto* sample = sampleIndexList[iSample].samplePtr;
+    size_t nBins{sample->perBinEventPtrList.size()};
+    auto& nominalHistogram = _nominalHistogramList_[iSample];
+    std::copy(nominalHistogram.begin(), nominalHistogram.begin() + long(nBins), sample->histogram->GetArray() + 1);
+    std::copy(nominalHistogram.begin() + long(nBins), nominalHistogram.end(), sample->histogram->GetSumw2()->GetArray() + 1);
+  }
+  for( size_t iSample = 0 ; iSample < _nominalEventWeightList_.size() ; iSample++ ){
+    auto& eventList = sampleIndexList[iSample].samplePtr->eventList;
+    auto& nominalEventWeight = _nominalEventWeightList_[iSample];
+    for( size_t iEvent = 0 ; iEvent < nominalEventWeight.size() ; iEvent++ ){ eventList[iEvent].setEventWeight(nominalEventWeight[iEvent]); }
+  }
+  _nominalHistogramList_.clear();
+  _nominalEventWeightList_.clear();
+}
+
 void Propagator::preventRfPropagation(){
   if(_isRfPropagationEnabled_){
 //    LogInfo << "Parameters propagation using Response Function is now disabled." << std::endl;
@@ -449,19 +768,114 @@ void Propagator::allowRfPropagation(){
   }
 }
 
-void Propagator::fillDialsStack(){
-  for( auto& parSet : _parameterSetsList_ ){
-    if( not parSet.isUseEigenDecompInFit() ){
-      for( auto& par : parSet.getParameterList() ){
-        for( auto& dialSet : par.getDialSetList() ){
-          if(dialSet.getGlobalDialType() == DialType::Norm){ continue; } // no cache needed
-          for( auto& dial : dialSet.getDialList() ){
-            if(dial->isReferenced()) _dialsStack_.emplace_back(dial.get());
-          } // dial
-        } // dialSet
-      } // par
+void Propagator::setEnableEventDialCache(bool enable_){
+  LogThrowIf(not enable_ and _eventDialCache_.isEventDialPtrListsReleased(),
+             "Can't switch back to the per-event dial evaluation: the event dial lists have been released (set \"releaseEventDialPtrLists\" to false).");
+  _eventDialCache_.setIsEnabled(enable_);
+}
+
+void Propagator::updateEventPartition(){
+  LogInfo << "Updating the static/dynamic event partition..." << std::endl;
+  LogThrowIf(not _eventDialCache_.isEnabled(), "The event partition needs the event dial cache.");
+
+  // all the events have to be up-to-date before freezing the static ones
+  _eventDialCache_.clearPartition();
+  _eventDialCache_.prepareUpdate();
+  this->updateDialResponses();
+  GlobalVariables::getParallelWorker().runJob("Propagator::reweightMcEvents");
+
+  _eventDialCache_.buildPartition();
+}
+void Propagator::validateEventDialCache(){
+  LogWarning << __METHOD_NAME__ << std::endl;
+  LogThrowIf(not _eventDialCache_.isBuilt(), "Event dial cache not built.");
+  LogThrowIf(_eventDialCache_.isEventDialPtrListsReleased(), "Event dial lists already released.");
+
+  if( _eventDialCache_.getDialDirectory().isInitialized() ){ _eventDialCache_.getDialDirectory().validate(); }
+
+  auto fetchWeights = [&](){
+    std::vector<double> out;
+    for( auto& sample : _fitSampleSet_.getFitSampleList() ){
+      for( auto& event : sample.getMcContainer().eventList ){ out.emplace_back(event.getEventWeight()); }
     }
-  } // parSet
+    return out;
+  };
+
+  bool wasEnabled = _eventDialCache_.isEnabled();
+  this->setEnableEventDialCache(false);
+  this->reweightMcEvents();
+  auto legacyWeights = fetchWeights();
+
+  this->setEnableEventDialCache(true);
+  this->reweightMcEvents();
+  auto cacheWeights = fetchWeights();
+  this->setEnableEventDialCache(wasEnabled);
+
+  double maxRelDiff{0};
+  size_t nDiff{0};
+  for( size_t iEvent = 0 ; iEvent < legacyWeights.size() ; iEvent++ ){
+    if( legacyWeights[iEvent] == cacheWeights[iEvent] ) continue;
+    nDiff++;
+    double relDiff = std::abs(cacheWeights[iEvent] - legacyWeights[iEvent]) / std::max(std::abs(legacyWeights[iEvent]), 1E-20);
+    maxRelDiff = std::max(maxRelDiff, relDiff);
+  }
+  LogInfo << "Event dial cache vs legacy evaluation: " << nDiff << "/" << legacyWeights.size()
+  << " event weights differ, max relative difference: " << maxRelDiff << std::endl;
+}
+void Propagator::validateFloatStorage(){
+  LogWarning << __METHOD_NAME__ << std::endl;
+  LogThrowIf(_eventDialCache_.isEventDialPtrListsReleased(), "Event dial lists already released.");
+
+  // As configured: with WITH_FLOAT_STORAGE, the caches hold the tree weights (and the Cache::Manager buffers) as float
+  this->reweightMcEvents();
+  this->refillSampleHistograms();
+  double llh{_fitSampleSet_.evalLikelihood()};
+
+  // Reference: PhysicsEvent tree weights and dial responses evaluated from the dial objects, all in double.
+  // The dial caches might hold responses computed from the float data: bypass them.
+  bool disableDialCache{Dial::disableDialCache};
+  Dial::disableDialCache = true;
+  std::vector<std::vector<double>> binContentList;
+  size_t nBins{0}, nDiff{0};
+  double maxRelDiff{0};
+  for( auto& sample : _fitSampleSet_.getFitSampleList() ){
+    auto& mcContainer = sample.getMcContainer();
+    auto* binContentArray = mcContainer.histogram->GetArray();
+    binContentList.emplace_back(binContentArray + 1, binContentArray + 1 + mcContainer.perBinEventPtrList.size());
+    for( size_t iBin = 0 ; iBin < mcContainer.perBinEventPtrList.size() ; iBin++ ){
+      double content{0};
+      for( auto* eventPtr : mcContainer.perBinEventPtrList[iBin] ){
+        double weight{eventPtr->getTreeWeight()};
+        for( auto* dialPtr : eventPtr->getRawDialPtrList() ){
+          if( dialPtr == nullptr ) break;
+          if( Dial::enableMaskCheck and dialPtr->isMasked() ){ continue; }
+          weight *= dialPtr->evalResponse();
+        }
+        content += weight;
+      }
+      content *= mcContainer.histScale;
+
+      nBins++;
+      if( content != binContentArray[iBin+1] ){
+        nDiff++;
+        maxRelDiff = std::max(maxRelDiff, std::abs(binContentArray[iBin+1] - content) / std::max(std::abs(content), 1E-20));
+      }
+      binContentArray[iBin+1] = content; // the bin errors are kept
+    }
+  }
+  Dial::disableDialCache = disableDialCache;
+  double referenceLlh{_fitSampleSet_.evalLikelihood()};
+
+  // Back to the propagated bin contents
+  for( size_t iSample = 0 ; iSample < binContentList.size() ; iSample++ ){
+    auto* binContentArray = _fitSampleSet_.getFitSampleList()[iSample].getMcContainer().histogram->GetArray();
+    std::copy(binContentList[iSample].begin(), binContentList[iSample].end(), binContentArray + 1);
+  }
+
+  LogInfo << "Float storage vs double precision: " << nDiff << "/" << nBins
+  << " bin contents differ, max relative difference: " << maxRelDiff << std::endl;
+  LogInfo << "Likelihood: " << llh << " (double precision: " << referenceLlh << "), relative difference: "
+  << std::abs(llh - referenceLlh) / std::max(std::abs(referenceLlh), 1E-20) << std::endl;
 }
 
 
@@ -484,6 +898,7 @@ void Propagator::initializeThreads() {
       sample.getMcContainer().refillHistogram(iThread);
       sample.getDataContainer().refillHistogram(iThread);
     }
+    if( _eventDialCache_.isEnabled() ){ _eventDialCache_.syncBinContents(iThread, GlobalVariables::getNbThreads()); }
   };
   std::function<void()> refillSampleHistogramsPostParallelFct = [this](){
     for( auto& sample : _fitSampleSet_.getFitSampleList() ){
@@ -494,6 +909,37 @@ void Propagator::initializeThreads() {
   GlobalVariables::getParallelWorker().addJob("Propagator::refillSampleHistograms", refillSampleHistogramsFct);
   GlobalVariables::getParallelWorker().setPostParallelJob("Propagator::refillSampleHistograms", refillSampleHistogramsPostParallelFct);
 
+  std::function<void(int)> reweightAndFillFct = [this](int iThread){
+    _eventDialCache_.reweightAndFill(iThread, GlobalVariables::getNbThreads());
+  };
+  GlobalVariables::getParallelWorker().addJob("Propagator::reweightAndFill", reweightAndFillFct);
+
+  std::function<void(int)> reduceSampleHistogramsFct = [this](int iThread){
+    _eventDialCache_.reduceBinContents(iThread, GlobalVariables::getNbThreads());
+  };
+  GlobalVariables::getParallelWorker().addJob("Propagator::reduceSampleHistograms", reduceSampleHistogramsFct);
+  GlobalVariables::getParallelWorker().setPostParallelJob("Propagator::reduceSampleHistograms", refillSampleHistogramsPostParallelFct);
+
+  std::function<void(int)> evalResponseDerivativesFct = [this](int iThread){
+    _likelihoodGradient_.evalResponseDerivatives(iThread, GlobalVariables::getNbThreads());
+  };
+  GlobalVariables::getParallelWorker().addJob("Propagator::evalResponseDerivatives", evalResponseDerivativesFct);
+
+  std::function<void(int)> accumulateLikelihoodGradientFct = [this](int iThread){
+    _likelihoodGradient_.accumulate(iThread, GlobalVariables::getNbThreads());
+  };
+  GlobalVariables::getParallelWorker().addJob("Propagator::accumulateLikelihoodGradient", accumulateLikelihoodGradientFct);
+
+  std::function<void(int)> fillParameterPointsFct = [this](int iThread){
+    _parameterPointEngine_.fill(iThread, GlobalVariables::getNbThreads());
+  };
+  GlobalVariables::getParallelWorker().addJob("Propagator::fillParameterPoints", fillParameterPointsFct);
+
+  std::function<void(int)> reduceParameterPointsFct = [this](int iThread){
+    _parameterPointEngine_.reduce(iThread, GlobalVariables::getNbThreads());
+  };
+  GlobalVariables::getParallelWorker().addJob("Propagator::reduceParameterPoints", reduceParameterPointsFct);
+
   std::function<void(int)> applyResponseFunctionsFct = [this](int iThread){
     this->applyResponseFunctions(iThread);
   };
@@ -569,13 +1015,9 @@ void Propagator::updateDialResponses(int iThread_){
     nThreads = 1;
     iThread_ = 0;
   }
-  int iDial{0};
-  int nDials(int(_dialsStack_.size()));
 
-  while( iDial < nDials ){
-    _dialsStack_[iDial]->evalResponse();
-    iDial += nThreads;
-  }
+  if( not _eventDialCache_.isEnabled() ) return;
+  _eventDialCache_.updateResponses(iThread_, nThreads);
 
 }
 
@@ -591,9 +1033,32 @@ void Propagator::reweightMcEvents(int iThread_) {
   long nToProcess;
   long offset;
   std::vector<PhysicsEvent>* eList;
+
+  if( _eventDialCache_.isEnabled() ){
+    if( _eventDialCache_.isPartialUpdate() ){
+      _eventDialCache_.reweightTouchedEvents(iThread_, nThreads);
+      return;
+    }
+    for( auto& sampleIndex : _eventDialCache_.getSampleDialIndexList() ){
+      long nEvents = long(sampleIndex.getNbEventsToReweight());
+      if( nEvents <= 0 ) continue;
+      nToProcess = nEvents/nThreads;
+      offset = iThread_*nToProcess;
+      if( iThread_+1==nThreads ) nToProcess += nEvents%nThreads;
+      _eventDialCache_.reweight(sampleIndex, offset, offset+nToProcess);
+    }
+    return;
+  }
   std::for_each(
     _fitSampleSet_.getFitSampleList().begin(), _fitSampleSet_.getFitSampleList().end(),
     [&](auto& s){
+      if( s.getMcContainer().eventColumns.hasDialRanges() ){
+        nToProcess = long(s.getMcContainer().eventColumns.size())/nThreads;
+        offset = iThread_*nToProcess;
+        if( iThread_+1==nThreads ) nToProcess += long(s.getMcContainer().eventColumns.size())%nThreads;
+        s.getMcContainer().eventColumns.reweight(offset, offset+nToProcess);
+        return;
+      }
       if( s.getMcContainer().eventList.empty() ) return;
       nToProcess = long(s.getMcContainer().eventList.size())/nThreads;
       offset = iThread_*nToProcess;
@@ -26,9 +26,10 @@
 
 // Place in a private name space so it plays nicely with CUDA
 namespace {
-    // Interpolate one point a spline with non-uniform points.  The spline can
-    // have at most 15 knots defined.  With optimization (O1 or more), this
-    // about forty times faster than TSpline3.
+    // Interpolate one point a spline with non-uniform points.  The knot
+    // interval is found with a binary search, so any number of knots can be
+    // used.  With optimization (O1 or more), this about forty times faster
+    // than TSpline3.
     //
     // This takes the "index" of the point in the data, the parameter value
     // (that made the index), a minimum and maximum bound, the buffer of data
@@ -46,24 +47,17 @@ namespace {
                                   const DEVICE_FLOATING_POINT* data,
                                   const int dim) {
 
-        // Check to find a point that is less than x.
+        // Find the knot interval containing x with a branch-free binary
+        // search: ix is the last knot in [0, knotCount-2] that is below x
+        // (or the first knot).  The number of steps only depends on the
+        // number of knots, so the threads of a GPU warp stay in lock step.
         const int knotCount = (dim-2)/3;
         int ix = 0;
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 1
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 2
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 3
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 4
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 5
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 6
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 7
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 8
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 9
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 10
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 11
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 12
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 13
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 14
-        if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix; // 15
+        for (int n = knotCount-1; n > 1; ) {
+            const int half = n/2;
+            ix = (x > data[2+3*(ix+half)+2]) ? ix+half : ix;
+            n -= half;
+        }
 
         const double x1 = data[2+3*ix+2];
         const double x2 = data[2+3*(ix+1)+2];
@@ -0,0 +1,125 @@
+#ifndef CALCULATE_GRAPH_H_SEEN
+#define CALCULATE_GRAPH_H_SEEN
+// Calculate a linear interpolation between the points of a graph.  This adds
+// a function that can be called from CPU (with c++), or a GPU (with CUDA).
+// It gives the same result as TGraph::Eval (with a sorted graph), without the
+// ROOT overhead.
+
+// Wrap the CUDA compiler attributes into a definition.  When this is compiled
+// with a CUDA compiler __CUDACC__ will be defined.  In that case, the code
+// will be compiled with cuda attributes for both the host (i.e. __host__) and
+// gpu (i.e. __device__).  If it's compiled with a normal C compiler, this is
+// compiled as inline.
+#ifndef DEVICE_CALLABLE_INLINE
+#ifdef __CUDACC__
+// This is used with a cuda compiler (i.e. nvcc)
+#define DEVICE_CALLABLE_INLINE __host__ __device__ inline
+#else
+// This is used for a non-cuda compiler
+#define DEVICE_CALLABLE_INLINE /* __host__ __device__ inline */
+#endif
+#endif
+
+// Allow the floating point type to be overriden.  This would normally be done
+// using a typedef, but that doesn't play well with the CUDA compiler.
+#ifndef DEVICE_FLOATING_POINT
+#define DEVICE_FLOATING_POINT double
+#endif
+
+// Place in a private name space so it plays nicely with CUDA
+namespace {
+    // Interpolate one point of a graph.  Outside of the graph, the value of
+    // the first (last) point is returned.  The interval containing x is
+    // found directly when the points are uniformly spaced, with a short
+    // linear scan for small graphs, and with a binary search otherwise.
+    //
+    // This takes the parameter value, a minimum and maximum bound, the
+    // buffer of data for this graph, and the number of data elements in the
+    // graph data.  The input data is arrange as
+    //
+    // data[0] -- graph lower bound
+    // data[1] -- graph inverse step (zero if the points are not uniform)
+    // data[2+2*n+0] -- The function value for point n
+    // data[2+2*n+1] -- The place of point n
+    //
+    // The points must be sorted by place.  The inverse step is only a hint:
+    // the interval is checked against the point places, so any graph with
+    // almost uniform points can use it.
+    DEVICE_CALLABLE_INLINE
+    double CalculateGraph(const double x,
+                          const double lowerBound, double upperBound,
+                          const DEVICE_FLOATING_POINT* data,
+                          const int dim) {
+        const int pointCount = (dim-2)/2;
+
+        double v;
+        if (x <= data[3]) v = data[2];
+        else if (x >= data[2+2*(pointCount-1)+1]) {
+            v = data[2+2*(pointCount-1)];
+        }
+        else {
+            // The last point in [0, pointCount-2] that is below (or at) x.
+            int ix = 0;
+            if (data[1] > 0.0) {
+                ix = (x-data[0])*data[1];
+                if (ix < 0) ix = 0;
+                if (ix > pointCount-2) ix = pointCount-2;
+                if (ix > 0 && x < data[2+2*ix+1]) --ix;
+                else if (ix < pointCount-2 && x >= data[2+2*(ix+1)+1]) ++ix;
+            }
+            else if (pointCount <= 8) {
+                while (ix < pointCount-2 && x >= data[2+2*(ix+1)+1]) ++ix;
+            }
+            else {
+                for (int n = pointCount-1; n > 1; ) {
+                    const int half = n/2;
+                    ix = (x >= data[2+2*(ix+half)+1]) ? ix+half : ix;
+                    n -= half;
+                }
+            }
+
+            const double xLow = data[2+2*ix+1];
+            const double yLow = data[2+2*ix];
+            const double xUp = data[2+2*(ix+1)+1];
+            const double yUp = data[2+2*(ix+1)];
+
+            // Same expression as TGraph::Eval
+            if (xLow == xUp) v = yLow;
+            else v = yUp + (x - xUp) * (yLow - yUp) / (xLow - xUp);
+        }
+
+        if (v < lowerBound) v = lowerBound;
+        if (v > upperBound) v = upperBound;
+
+        return v;
+    }
+}
+
+// An MIT Style License
+
+// Copyright (c) 2022 Clark McGrew
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:4
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
+#endif
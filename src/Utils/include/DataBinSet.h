@@ -7,6 +7,7 @@
 
 #include "vector"
 #include "string"
+#include "cstdint"
 
 #include "DataBin.h"
 
@@ -26,7 +27,13 @@ public:
   // Management
   void addBinContent(int binIndex_, double weight_);
 
+  // Bin search: the values are given in the order of getBinVariables()
+  void buildSearchIndex(); // done by readBinningDefinition() and addBin()
+  int findBin(const std::vector<double>& valueList_) const; // first bin holding the values, -1 if none
+  int findBin(const double* valueList_) const;
+
   // Getters
+  bool isSearchIndexBuilt() const{ return _isSearchIndexBuilt_; }
   const std::vector<DataBin> &getBinsList() const;
   const std::string &getFilePath() const;
   const std::vector<std::string> &getBinVariables() const;
@@ -39,6 +46,10 @@ public:
   // Globals
   static void setVerbosity(int maxLogLevel_);
 
+protected:
+  bool isInBin(size_t binIndex_, const double* valueList_) const;
+  static size_t findSlot(const std::vector<double>& boundaryList_, double value_);
+
 private:
   std::string _name_;
   std::string _filePath_;
@@ -46,6 +57,22 @@ private:
   std::vector<double> _binContent_{};
   std::vector<std::string> _binVariables_{};
 
+  /*
+   * Search index: the sorted edges of each variable split its axis into elementary slots (below the first edge, each
+   * edge value, each open interval between two edges, above the last edge). A bin holds a contiguous range of slots
+   * for each of its variables.
+   * - grid-like binnings: dense table of the first bin of each slot combination (one lookup per event)
+   * - irregular ones (table too large): candidate bins of each slot of the variable with the most edges
+   * */
+  bool _isSearchIndexBuilt_{false};
+  std::vector<std::vector<int>> _binVarIndexList_{}; // [iBin][iEdge] -> index in _binVariables_
+  std::vector<std::vector<double>> _varBoundaryList_{}; // sorted unique edges of each variable
+  std::vector<size_t> _slotStrideList_{};
+  std::vector<int> _cellBinList_{};
+  int _searchVarIndex_{-1};
+  std::vector<uint32_t> _slotCandidateOffsetList_{};
+  std::vector<uint32_t> _slotCandidateList_{};
+
 };
 
 
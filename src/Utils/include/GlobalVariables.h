@@ -15,6 +15,14 @@
 #include <mutex>
 #include <memory>
 
+// Type of the event tree weights held by the propagation caches. With the WITH_FLOAT_STORAGE build option, they are
+// stored in single precision while the computations stay in double (the GPU buffers use WEIGHT_BUFFER_FLOAT).
+#ifdef GUNDAM_FLOAT_STORAGE
+typedef float StorageFloat;
+#else
+typedef double StorageFloat;
+#endif
+
 
 class GlobalVariables{
 
@@ -0,0 +1,54 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#ifndef GUNDAM_SPLINEBATCH_H
+#define GUNDAM_SPLINEBATCH_H
+
+#include "string"
+#include "cstddef"
+
+
+/*
+ * Batched versions of CalculateUniformSpline, CalculateGeneralSpline and CalculateMonotonicSpline.
+ * - evalXxxSplines(): many splines of the same kind and the same data size evaluated at one x (all the spline dials of
+ *   a given parameter share their input). The data of spline i is dataBlock_[ i*dim_ : (i+1)*dim_ ] with the layout
+ *   of the corresponding Calculate*Spline function.
+ * - evalXxxSpline(): one spline evaluated at a batch of x (scans).
+ * Like SplineDial::calcDial, x is clamped within the knot range of each spline before the interpolation.
+ * On x86-64, AVX2 or AVX-512 kernels are picked at runtime according to the CPU. Other platforms use the scalar loop.
+ * */
+
+namespace SplineBatch{
+
+  enum class SimdLevel{
+    Scalar = 0,
+    Avx2,
+    Avx512
+  };
+
+  SimdLevel getSimdLevel(); // active level, detected at the first call
+  SimdLevel getMaxSimdLevel(); // best level supported by the CPU and the build
+  void setSimdLevel(SimdLevel simdLevel_); // capped to getMaxSimdLevel(), mostly for benchmarks
+  std::string toString(SimdLevel simdLevel_);
+
+  // Many splines at one x
+  void evalUniformSplines(double x_, const double* dataBlock_, int dim_, size_t nSplines_, double* out_,
+                          double lowerBound_ = -1E20, double upperBound_ = 1E20);
+  void evalGeneralSplines(double x_, const double* dataBlock_, int dim_, size_t nSplines_, double* out_,
+                          double lowerBound_ = -1E20, double upperBound_ = 1E20);
+  void evalMonotonicSplines(double x_, const double* dataBlock_, int dim_, size_t nSplines_, double* out_,
+                            double lowerBound_ = -1E20, double upperBound_ = 1E20);
+
+  // One spline at many x
+  void evalUniformSpline(const double* xList_, size_t nX_, const double* data_, int dim_, double* out_,
+                         double lowerBound_ = -1E20, double upperBound_ = 1E20);
+  void evalGeneralSpline(const double* xList_, size_t nX_, const double* data_, int dim_, double* out_,
+                         double lowerBound_ = -1E20, double upperBound_ = 1E20);
+  void evalMonotonicSpline(const double* xList_, size_t nX_, const double* data_, int dim_, double* out_,
+                           double lowerBound_ = -1E20, double upperBound_ = 1E20);
+
+}
+
+
+#endif //GUNDAM_SPLINEBATCH_H
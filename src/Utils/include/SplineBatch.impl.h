@@ -0,0 +1,278 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#ifndef GUNDAM_SPLINEBATCH_IMPL_H
+#define GUNDAM_SPLINEBATCH_IMPL_H
+
+// Internal header: only included by the SplineBatch translation units, each compiled for a given instruction set.
+
+#include "SplineBatch.h"
+
+#include "CalculateUniformSpline.h"
+#include "CalculateGeneralSpline.h"
+#include "CalculateMonotonicSpline.h"
+
+#include "cstddef"
+#include "cmath"
+
+
+namespace SplineBatch{
+
+  // One table of kernels per instruction set
+  struct KernelTable{
+    void (*evalUniformSplines)(double, const double*, int, size_t, double*, double, double);
+    void (*evalGeneralSplines)(double, const double*, int, size_t, double*, double, double);
+    void (*evalMonotonicSplines)(double, const double*, int, size_t, double*, double, double);
+    void (*evalUniformSpline)(const double*, size_t, const double*, int, double*, double, double);
+    void (*evalGeneralSpline)(const double*, size_t, const double*, int, double*, double, double);
+    void (*evalMonotonicSpline)(const double*, size_t, const double*, int, double*, double, double);
+  };
+
+  const KernelTable& getScalarKernelTable();
+#ifdef GUNDAM_SPLINE_BATCH_X86
+  const KernelTable& getAvx2KernelTable();
+  const KernelTable& getAvx512KernelTable();
+#endif
+
+  // The content of Impl has internal linkage: the same inline function compiled with AVX flags in one translation unit
+  // must not be picked by the linker for the others (hence no std::min/std::max either).
+  namespace Impl{ namespace {
+
+    inline double clamp(double x_, double min_, double max_){ return x_ < min_ ? min_ : (x_ > max_ ? max_ : x_); }
+
+    // Scalar reference: the knot range clamp of SplineDial::calcDial, then the shared Calculate*Spline functions
+    inline double evalUniformScalar(double x_, const double* data_, int dim_, double lowerBound_, double upperBound_){
+      const double xMax{data_[0] + data_[1]*((dim_-2)/2 - 1)};
+      x_ = clamp(x_, data_[0], xMax);
+      return CalculateUniformSpline(x_, lowerBound_, upperBound_, data_, dim_);
+    }
+    inline double evalGeneralScalar(double x_, const double* data_, int dim_, double lowerBound_, double upperBound_){
+      const int nKnots{(dim_-2)/3};
+      x_ = clamp(x_, data_[2+2], data_[2+3*(nKnots-1)+2]);
+      return CalculateGeneralSpline(x_, lowerBound_, upperBound_, data_, dim_);
+    }
+    inline double evalMonotonicScalar(double x_, const double* data_, int dim_, double lowerBound_, double upperBound_){
+      // CalculateMonotonicSpline expects the number of knots (as the GPU kernel does), not the data size
+      const double xMax{data_[0] + data_[1]*(dim_-3)};
+      x_ = clamp(x_, data_[0], xMax);
+      return CalculateMonotonicSpline(x_, lowerBound_, upperBound_, data_, dim_-2);
+    }
+
+    /*
+     * Vector kernels. Pack provides:
+     *   Reg / Idx / Mask types, width,
+     *   set1, load, store, add, sub, mul, div, min, max, trunc, gt, le, maskOr, select(mask, ifTrue, ifFalse),
+     *   laneOffset(stride), toIdx(Reg), addIdx(Idx, Idx), gather(const double* base, Idx) and
+     *   loadRows4(const double* base, Idx, Reg out[4]) which loads 4 contiguous values per lane, transposed.
+     * laneOffset_ holds the offset of the data of each lane relative to base_ (i*dim for many splines, 0 for a scan).
+     * */
+    template<class Pack> inline typename Pack::Reg evalHermite(
+        typename Pack::Reg fx_, typename Pack::Reg fxx_, typename Pack::Reg fxxx_,
+        typename Pack::Reg p1_, typename Pack::Reg m1_, typename Pack::Reg p2_, typename Pack::Reg m2_,
+        double lowerBound_, double upperBound_
+    ){
+      using Reg = typename Pack::Reg;
+      // v = p1 - p1*t + m1*(fxxx-2.0*fxx+fx) + p2*t + m2*(fxxx-fxx), with t = 3.0*fxx-2.0*fxxx
+      const Reg t{Pack::sub(Pack::mul(Pack::set1(3), fxx_), Pack::mul(Pack::set1(2), fxxx_))};
+      Reg v{Pack::sub(p1_, Pack::mul(p1_, t))};
+      v = Pack::add(v, Pack::mul(m1_, Pack::add(Pack::sub(fxxx_, Pack::mul(Pack::set1(2), fxx_)), fx_)));
+      v = Pack::add(v, Pack::mul(p2_, t));
+      v = Pack::add(v, Pack::mul(m2_, Pack::sub(fxxx_, fxx_)));
+      return Pack::min(Pack::max(v, Pack::set1(lowerBound_)), Pack::set1(upperBound_));
+    }
+
+    template<class Pack> inline typename Pack::Reg evalUniform(
+        typename Pack::Reg x_, const double* base_, typename Pack::Idx laneOffset_, int dim_, double lowerBound_, double upperBound_
+    ){
+      using Reg = typename Pack::Reg;
+      const Reg low{Pack::gather(base_, laneOffset_)};
+      const Reg step{Pack::gather(base_ + 1, laneOffset_)};
+      const Reg xMax{Pack::add(low, Pack::mul(step, Pack::set1(double((dim_-2)/2 - 1))))};
+      x_ = Pack::min(Pack::max(x_, low), xMax);
+
+      const Reg xx{Pack::div(Pack::sub(x_, low), step)};
+      Reg ix{Pack::max(Pack::trunc(xx), Pack::set1(0))};
+      ix = Pack::select(Pack::gt(ix, Pack::set1(0.5*(dim_-7))), Pack::set1(double((dim_-2)/2 - 2)), ix);
+
+      const Reg fx{Pack::sub(xx, ix)};
+      const Reg fxx{Pack::mul(fx, fx)};
+      const Reg fxxx{Pack::mul(fx, fxx)};
+
+      // p1, m1, p2, m2 are contiguous
+      Reg knotData[4];
+      Pack::loadRows4(base_ + 2, Pack::addIdx(laneOffset_, Pack::toIdx(Pack::add(ix, ix))), knotData);
+
+      return evalHermite<Pack>(
+          fx, fxx, fxxx, knotData[0], Pack::mul(knotData[1], step), knotData[2], Pack::mul(knotData[3], step),
+          lowerBound_, upperBound_
+      );
+    }
+
+    template<class Pack> inline typename Pack::Reg evalGeneral(
+        typename Pack::Reg x_, const double* base_, typename Pack::Idx laneOffset_, int dim_, double lowerBound_, double upperBound_
+    ){
+      using Reg = typename Pack::Reg;
+      const int nKnots{(dim_-2)/3};
+      x_ = Pack::min(
+          Pack::max(x_, Pack::gather(base_ + 2+2, laneOffset_)),
+          Pack::gather(base_ + 2+3*(nKnots-1)+2, laneOffset_)
+      );
+
+      // Interval search, branch-free. The knots are sorted: for short splines, counting the inner knots below x only
+      // needs independent loads. Longer splines use the binary search of CalculateGeneralSpline (dependent loads).
+      Reg ix{Pack::set1(0)};
+      if( nKnots <= 16 ){
+        for( int iKnot = 1 ; iKnot <= nKnots-2 ; iKnot++ ){
+          ix = Pack::add(ix, Pack::select(
+              Pack::gt(x_, Pack::gather(base_ + 2+3*iKnot+2, laneOffset_)), Pack::set1(1), Pack::set1(0)
+          ));
+        }
+      }
+      else{
+        for( int n = nKnots-1 ; n > 1 ; ){
+          const int half{n/2};
+          const Reg candidate{Pack::add(ix, Pack::set1(half))};
+          const auto idx{Pack::addIdx(laneOffset_, Pack::toIdx(Pack::mul(candidate, Pack::set1(3))))};
+          ix = Pack::select(Pack::gt(x_, Pack::gather(base_ + 2+2, idx)), candidate, ix);
+          n -= half;
+        }
+      }
+
+      // p1, m1, x1, p2 are contiguous, followed by m2, x2
+      const auto idx{Pack::addIdx(laneOffset_, Pack::toIdx(Pack::mul(ix, Pack::set1(3))))};
+      Reg knotData[4];
+      Pack::loadRows4(base_ + 2, idx, knotData);
+      const Reg x1{knotData[2]};
+      const Reg x2{Pack::gather(base_ + 7, idx)};
+      const Reg step{Pack::sub(x2, x1)};
+
+      const Reg fx{Pack::div(Pack::sub(x_, x1), step)};
+      const Reg fxx{Pack::mul(fx, fx)};
+      const Reg fxxx{Pack::mul(fx, fxx)};
+
+      return evalHermite<Pack>(
+          fx, fxx, fxxx, knotData[0], Pack::mul(knotData[1], step), knotData[3], Pack::mul(Pack::gather(base_ + 6, idx), step),
+          lowerBound_, upperBound_
+      );
+    }
+
+    template<class Pack> inline typename Pack::Reg evalMonotonic(
+        typename Pack::Reg x_, const double* base_, typename Pack::Idx laneOffset_, int dim_, double lowerBound_, double upperBound_
+    ){
+      using Reg = typename Pack::Reg;
+      const int nKnots{dim_-2};
+      const Reg low{Pack::gather(base_, laneOffset_)};
+      const Reg step{Pack::gather(base_ + 1, laneOffset_)};
+      const Reg xMax{Pack::add(low, Pack::mul(step, Pack::set1(double(nKnots-1))))};
+      x_ = Pack::min(Pack::max(x_, low), xMax);
+
+      const Reg xx{Pack::div(Pack::sub(x_, low), step)};
+      const Reg ix{Pack::trunc(xx)};
+
+      // same index clamps as CalculateMonotonicSpline
+      const Reg zero{Pack::set1(0)};
+      const Reg lastIndex{Pack::set1(double(nKnots-2))};
+      auto clampIndex = [&](const Reg& index_){ return Pack::min(Pack::max(index_, zero), lastIndex); };
+      const Reg d21{clampIndex(Pack::sub(ix, Pack::set1(1)))};
+      const Reg d32{clampIndex(ix)};
+      const Reg d43{clampIndex(Pack::add(ix, Pack::set1(1)))};
+      const Reg d54{clampIndex(Pack::add(ix, Pack::set1(2)))};
+
+      auto knotDelta = [&](const Reg& index_){
+        const auto idx{Pack::addIdx(laneOffset_, Pack::toIdx(index_))};
+        return Pack::sub(Pack::gather(base_ + 3, idx), Pack::gather(base_ + 2, idx));
+      };
+      const auto idx32{Pack::addIdx(laneOffset_, Pack::toIdx(d32))};
+      const Reg p2{Pack::gather(base_ + 2, idx32)};
+      const Reg p3{Pack::gather(base_ + 3, idx32)};
+
+      const Reg fx{Pack::sub(xx, d32)};
+      const Reg fxx{Pack::mul(fx, fx)};
+      const Reg fxxx{Pack::mul(fx, fxx)};
+
+      const Reg delta21{knotDelta(d21)};
+      const Reg delta32{Pack::sub(p3, p2)};
+      const Reg delta43{knotDelta(d43)};
+      const Reg delta54{knotDelta(d54)};
+
+      const Reg half{Pack::set1(0.5)};
+      Reg m2{Pack::mul(half, Pack::add(delta21, delta32))};
+      Reg m3{Pack::mul(half, Pack::add(delta32, delta43))};
+      Reg m4{Pack::mul(half, Pack::add(delta43, delta54))};
+
+      // Deal with cusp points and flat areas.
+      m2 = Pack::select(Pack::le(Pack::mul(delta32, delta21), zero), zero, m2);
+      m3 = Pack::select(Pack::le(Pack::mul(delta43, delta32), zero), zero, m3);
+      m4 = Pack::select(Pack::le(Pack::mul(delta54, delta43), zero), zero, m4);
+
+      // Find the alphas and betas
+      auto safeRatio = [&](const Reg& num_, const Reg& den_){
+        return Pack::select(Pack::gt(den_, zero), Pack::div(num_, den_), zero);
+      };
+      const Reg b1{safeRatio(m2, delta21)};
+      const Reg a2{safeRatio(m2, delta32)};
+      const Reg b2{safeRatio(m3, delta32)};
+      const Reg a3{safeRatio(m3, delta43)};
+      const Reg b3{safeRatio(m4, delta43)};
+
+      // Find places where can only be piecewise monotonic.
+      m2 = Pack::select(Pack::le(b1, zero), zero, m2);
+      m3 = Pack::select(Pack::le(b2, zero), zero, m3);
+      m2 = Pack::select(Pack::le(a2, zero), zero, m2);
+      m3 = Pack::select(Pack::le(a3, zero), zero, m3);
+
+      // Limit the slopes so there isn't overshoot.
+      const Reg three{Pack::set1(3)};
+      m2 = Pack::select(Pack::maskOr(Pack::gt(a2, three), Pack::gt(b2, three)), Pack::mul(three, delta32), m2);
+      m3 = Pack::select(Pack::maskOr(Pack::gt(a3, three), Pack::gt(b3, three)), Pack::mul(three, delta43), m3);
+
+      return evalHermite<Pack>(fx, fxx, fxxx, p2, m2, p3, m3, lowerBound_, upperBound_);
+    }
+
+    // Drivers: full packs with the vector kernel, the remainder with the scalar reference
+#define GUNDAM_SPLINE_BATCH_DRIVERS(KIND)                                                                             \
+    template<class Pack> void eval##KIND##Splines(                                                                    \
+        double x_, const double* dataBlock_, int dim_, size_t nSplines_, double* out_, double lowerBound_, double upperBound_ \
+    ){                                                                                                                \
+      const auto laneOffset{Pack::laneOffset(dim_)};                                                                  \
+      const auto x{Pack::set1(x_)};                                                                                   \
+      size_t iSpline{0};                                                                                              \
+      for( ; iSpline + Pack::width <= nSplines_ ; iSpline += Pack::width ){                                           \
+        Pack::store(out_ + iSpline, eval##KIND<Pack>(x, dataBlock_ + iSpline*dim_, laneOffset, dim_, lowerBound_, upperBound_)); \
+      }                                                                                                               \
+      for( ; iSpline < nSplines_ ; iSpline++ ){                                                                       \
+        out_[iSpline] = eval##KIND##Scalar(x_, dataBlock_ + iSpline*dim_, dim_, lowerBound_, upperBound_);            \
+      }                                                                                                               \
+    }                                                                                                                 \
+    template<class Pack> void eval##KIND##Spline(                                                                     \
+        const double* xList_, size_t nX_, const double* data_, int dim_, double* out_, double lowerBound_, double upperBound_ \
+    ){                                                                                                                \
+      const auto laneOffset{Pack::laneOffset(0)};                                                                     \
+      size_t iX{0};                                                                                                   \
+      for( ; iX + Pack::width <= nX_ ; iX += Pack::width ){                                                           \
+        Pack::store(out_ + iX, eval##KIND<Pack>(Pack::load(xList_ + iX), data_, laneOffset, dim_, lowerBound_, upperBound_)); \
+      }                                                                                                               \
+      for( ; iX < nX_ ; iX++ ){                                                                                       \
+        out_[iX] = eval##KIND##Scalar(xList_[iX], data_, dim_, lowerBound_, upperBound_);                             \
+      }                                                                                                               \
+    }
+
+    GUNDAM_SPLINE_BATCH_DRIVERS(Uniform)
+    GUNDAM_SPLINE_BATCH_DRIVERS(General)
+    GUNDAM_SPLINE_BATCH_DRIVERS(Monotonic)
+#undef GUNDAM_SPLINE_BATCH_DRIVERS
+
+    template<class Pack> KernelTable makeKernelTable(){
+      return {
+          &evalUniformSplines<Pack>, &evalGeneralSplines<Pack>, &evalMonotonicSplines<Pack>,
+          &evalUniformSpline<Pack>, &evalGeneralSpline<Pack>, &evalMonotonicSpline<Pack>
+      };
+    }
+
+  } }
+
+}
+
+
+#endif //GUNDAM_SPLINEBATCH_IMPL_H
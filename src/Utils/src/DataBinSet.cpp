@@ -7,6 +7,7 @@
 #include "stdexcept"
 #include "string"
 #include "sstream"
+#include "algorithm"
 
 #include "GenericToolbox.h"
 #include "Logger.h"
@@ -24,6 +25,14 @@ DataBinSet::~DataBinSet() { this->reset(); }
 void DataBinSet::reset() {
   _binsList_.clear();
   _binVariables_.clear();
+  _isSearchIndexBuilt_ = false;
+  _binVarIndexList_.clear();
+  _varBoundaryList_.clear();
+  _slotStrideList_.clear();
+  _cellBinList_.clear();
+  _searchVarIndex_ = -1;
+  _slotCandidateOffsetList_.clear();
+  _slotCandidateList_.clear();
 }
 
 // Setters
@@ -146,10 +155,16 @@ void DataBinSet::readBinningDefinition(const std::string &filePath_) {
 
     }
   }
+
+  this->buildSearchIndex();
 }
 void DataBinSet::addBin(const DataBin& bin_){
   _binsList_.emplace_back(bin_);
   _binContent_.emplace_back(0);
+  for( auto& varName : bin_.getVariableNameList() ){
+    if( not GenericToolbox::doesElementIsInVector(varName, _binVariables_) ) _binVariables_.emplace_back(varName);
+  }
+  this->buildSearchIndex();
 }
 void DataBinSet::setVerbosity(int maxLogLevel_) {
   Logger::setMaxLogLevel(maxLogLevel_);
@@ -169,6 +184,145 @@ std::string DataBinSet::getSummary() const{
   return ss.str();
 }
 
+void DataBinSet::buildSearchIndex(){
+  _isSearchIndexBuilt_ = false;
+  _binVarIndexList_.clear();
+  _varBoundaryList_.clear();
+  _slotStrideList_.clear();
+  _cellBinList_.clear();
+  _searchVarIndex_ = -1;
+  _slotCandidateOffsetList_.clear();
+  _slotCandidateList_.clear();
+
+  size_t nBins{_binsList_.size()};
+  size_t nVars{_binVariables_.size()};
+  _varBoundaryList_.resize(nVars);
+  _binVarIndexList_.resize(nBins);
+  for( size_t iBin = 0 ; iBin < nBins ; iBin++ ){
+    auto& bin = _binsList_[iBin];
+    if( bin.getVariableNameList().size() != bin.getEdgesList().size() ){
+      LogDebug << "Bin #" << iBin << " has no variable names: no search index for " << _filePath_ << std::endl;
+      _binVarIndexList_.clear(); _varBoundaryList_.clear();
+      return;
+    }
+    for( size_t iEdge = 0 ; iEdge < bin.getEdgesList().size() ; iEdge++ ){
+      int iVar = GenericToolbox::findElementIndex(bin.getVariableNameList()[iEdge], _binVariables_);
+      LogThrowIf(iVar == -1, bin.getVariableNameList()[iEdge] << " is not a variable of the binning " << _filePath_);
+      _binVarIndexList_[iBin].emplace_back(iVar);
+      _varBoundaryList_[iVar].emplace_back(bin.getEdgesList()[iEdge].first);
+      _varBoundaryList_[iVar].emplace_back(bin.getEdgesList()[iEdge].second);
+    }
+  }
+  for( auto& boundaryList : _varBoundaryList_ ){
+    std::sort(boundaryList.begin(), boundaryList.end());
+    boundaryList.erase(std::unique(boundaryList.begin(), boundaryList.end()), boundaryList.end());
+  }
+
+  // slot range [first, second] of each bin on each variable (all the slots if the bin doesn't use the variable)
+  std::vector<std::vector<std::pair<size_t, size_t>>> binSlotRangeList(nBins);
+  for( size_t iBin = 0 ; iBin < nBins ; iBin++ ){
+    binSlotRangeList[iBin].resize(nVars);
+    for( size_t iVar = 0 ; iVar < nVars ; iVar++ ){ binSlotRangeList[iBin][iVar] = {0, 2*_varBoundaryList_[iVar].size()}; }
+    for( size_t iEdge = 0 ; iEdge < _binVarIndexList_[iBin].size() ; iEdge++ ){
+      auto& boundaryList = _varBoundaryList_[_binVarIndexList_[iBin][iEdge]];
+      auto& edges = _binsList_[iBin].getEdgesList()[iEdge];
+      size_t lowIndex = std::lower_bound(boundaryList.begin(), boundaryList.end(), edges.first) - boundaryList.begin();
+      size_t highIndex = std::lower_bound(boundaryList.begin(), boundaryList.end(), edges.second) - boundaryList.begin();
+      // [low, high[ holds the low edge value, and every slot up to the interval below the high edge
+      binSlotRangeList[iBin][_binVarIndexList_[iBin][iEdge]] = {2*lowIndex+1, ( edges.first == edges.second ? 2*lowIndex+1 : 2*highIndex )};
+    }
+  }
+
+  // dense table if the slot combinations (and the cost of filling them) stay reasonable
+  double maxNbCells = std::max(double(1 << 20), 16.*double(nBins));
+  double nbCells{1}; double fillCost{0};
+  for( auto& boundaryList : _varBoundaryList_ ){ nbCells *= double(2*boundaryList.size()+1); }
+  for( auto& slotRangeList : binSlotRangeList ){
+    double binCost{1};
+    for( auto& slotRange : slotRangeList ){ binCost *= double(slotRange.second - slotRange.first + 1); }
+    fillCost += binCost;
+  }
+
+  if( nbCells <= maxNbCells and fillCost <= maxNbCells ){
+    _slotStrideList_.resize(nVars, 1);
+    for( size_t iVar = 1 ; iVar < nVars ; iVar++ ){
+      _slotStrideList_[iVar] = _slotStrideList_[iVar-1] * (2*_varBoundaryList_[iVar-1].size()+1);
+    }
+    _cellBinList_.assign(size_t(nbCells), -1);
+    std::vector<size_t> slotList(nVars);
+    for( size_t iBin = 0 ; iBin < nBins ; iBin++ ){
+      auto& slotRangeList = binSlotRangeList[iBin];
+      for( size_t iVar = 0 ; iVar < nVars ; iVar++ ){ slotList[iVar] = slotRangeList[iVar].first; }
+      while( true ){
+        size_t iCell{0};
+        for( size_t iVar = 0 ; iVar < nVars ; iVar++ ){ iCell += slotList[iVar] * _slotStrideList_[iVar]; }
+        if( _cellBinList_[iCell] == -1 ) _cellBinList_[iCell] = int(iBin); // the first defined bin wins, as a linear search
+        size_t iVar{0};
+        for( ; iVar < nVars ; iVar++ ){
+          if( ++slotList[iVar] <= slotRangeList[iVar].second ) break;
+          slotList[iVar] = slotRangeList[iVar].first;
+        }
+        if( iVar == nVars ) break;
+      }
+    }
+  }
+  else{
+    _searchVarIndex_ = 0;
+    for( size_t iVar = 1 ; iVar < nVars ; iVar++ ){
+      if( _varBoundaryList_[iVar].size() > _varBoundaryList_[_searchVarIndex_].size() ) _searchVarIndex_ = int(iVar);
+    }
+    size_t nSlots{2*_varBoundaryList_[_searchVarIndex_].size()+1};
+    _slotCandidateOffsetList_.assign(nSlots+1, 0);
+    for( auto& slotRangeList : binSlotRangeList ){
+      for( size_t iSlot = slotRangeList[_searchVarIndex_].first ; iSlot <= slotRangeList[_searchVarIndex_].second ; iSlot++ ){
+        _slotCandidateOffsetList_[iSlot+1]++;
+      }
+    }
+    for( size_t iSlot = 0 ; iSlot < nSlots ; iSlot++ ){ _slotCandidateOffsetList_[iSlot+1] += _slotCandidateOffsetList_[iSlot]; }
+    _slotCandidateList_.resize(_slotCandidateOffsetList_.back());
+    auto fillOffsetList = _slotCandidateOffsetList_;
+    for( size_t iBin = 0 ; iBin < nBins ; iBin++ ){ // the candidates stay sorted by bin index
+      auto& slotRange = binSlotRangeList[iBin][_searchVarIndex_];
+      for( size_t iSlot = slotRange.first ; iSlot <= slotRange.second ; iSlot++ ){
+        _slotCandidateList_[fillOffsetList[iSlot]++] = uint32_t(iBin);
+      }
+    }
+  }
+
+  _isSearchIndexBuilt_ = true;
+}
+int DataBinSet::findBin(const std::vector<double>& valueList_) const{
+  LogThrowIf(valueList_.size() != _binVariables_.size(),
+             "Provided " << GET_VAR_NAME_VALUE(valueList_.size()) << " does not match " << GET_VAR_NAME_VALUE(_binVariables_.size()));
+  return this->findBin(valueList_.data());
+}
+int DataBinSet::findBin(const double* valueList_) const{
+  LogThrowIf(not _isSearchIndexBuilt_, "No search index for the binning " << _filePath_);
+  if( _binsList_.empty() ) return -1;
+
+  for( size_t iVar = 0 ; iVar < _binVariables_.size() ; iVar++ ){
+    if( valueList_[iVar] != valueList_[iVar] ){
+      // NaN values can't be placed in a slot: same answer as the linear search
+      for( size_t iBin = 0 ; iBin < _binsList_.size() ; iBin++ ){ if( this->isInBin(iBin, valueList_) ) return int(iBin); }
+      return -1;
+    }
+  }
+
+  if( not _cellBinList_.empty() ){
+    size_t iCell{0};
+    for( size_t iVar = 0 ; iVar < _binVariables_.size() ; iVar++ ){
+      iCell += DataBinSet::findSlot(_varBoundaryList_[iVar], valueList_[iVar]) * _slotStrideList_[iVar];
+    }
+    return _cellBinList_[iCell];
+  }
+
+  size_t iSlot = DataBinSet::findSlot(_varBoundaryList_[_searchVarIndex_], valueList_[_searchVarIndex_]);
+  for( uint32_t iEntry = _slotCandidateOffsetList_[iSlot] ; iEntry < _slotCandidateOffsetList_[iSlot+1] ; iEntry++ ){
+    if( this->isInBin(_slotCandidateList_[iEntry], valueList_) ) return int(_slotCandidateList_[iEntry]);
+  }
+  return -1;
+}
+
 void DataBinSet::addBinContent(int binIndex_, double weight_) {
   if( binIndex_ < 0 or binIndex_ >= _binsList_.size() ){
     LogError << GET_VAR_NAME_VALUE(binIndex_) << " is out of range: " << GET_VAR_NAME_VALUE(_binsList_.size()) << std::endl;
@@ -189,4 +343,20 @@ const std::vector<std::string> &DataBinSet::getBinVariables() const {
 
 std::vector<DataBin> &DataBinSet::getBinsList(){
   return _binsList_;
+}
+
+// Protected
+bool DataBinSet::isInBin(size_t binIndex_, const double* valueList_) const{
+  const auto& edgesList = _binsList_[binIndex_].getEdgesList();
+  const auto& varIndexList = _binVarIndexList_[binIndex_];
+  for( size_t iEdge = 0 ; iEdge < edgesList.size() ; iEdge++ ){
+    if( not DataBin::isBetweenEdges(edgesList[iEdge], valueList_[varIndexList[iEdge]]) ) return false;
+  }
+  return true;
+}
+size_t DataBinSet::findSlot(const std::vector<double>& boundaryList_, double value_){
+  // 2i+1: value == boundary i, 2i: between boundaries i-1 and i
+  size_t nBelow = std::upper_bound(boundaryList_.begin(), boundaryList_.end(), value_) - boundaryList_.begin();
+  if( nBelow > 0 and boundaryList_[nBelow-1] == value_ ) return 2*(nBelow-1)+1;
+  return 2*nBelow;
 }
\ No newline at end of file
@@ -0,0 +1,69 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+// Compiled with -mavx2: only called once the CPU support has been checked by SplineBatch.cpp
+
+#include "SplineBatch.impl.h"
+
+#include <immintrin.h>
+
+
+namespace {
+  struct PackAvx2{
+    typedef __m256d Reg;
+    typedef __m128i Idx;
+    typedef __m256d Mask;
+    static constexpr size_t width{4};
+
+    static Reg set1(double x_){ return _mm256_set1_pd(x_); }
+    static Reg load(const double* ptr_){ return _mm256_loadu_pd(ptr_); }
+    static void store(double* ptr_, Reg a_){ _mm256_storeu_pd(ptr_, a_); }
+    static Reg add(Reg a_, Reg b_){ return _mm256_add_pd(a_, b_); }
+    static Reg sub(Reg a_, Reg b_){ return _mm256_sub_pd(a_, b_); }
+    static Reg mul(Reg a_, Reg b_){ return _mm256_mul_pd(a_, b_); }
+    static Reg div(Reg a_, Reg b_){ return _mm256_div_pd(a_, b_); }
+    static Reg min(Reg a_, Reg b_){ return _mm256_min_pd(a_, b_); }
+    static Reg max(Reg a_, Reg b_){ return _mm256_max_pd(a_, b_); }
+    static Reg trunc(Reg a_){ return _mm256_round_pd(a_, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+    static Mask gt(Reg a_, Reg b_){ return _mm256_cmp_pd(a_, b_, _CMP_GT_OQ); }
+    static Mask le(Reg a_, Reg b_){ return _mm256_cmp_pd(a_, b_, _CMP_LE_OQ); }
+    static Mask maskOr(Mask a_, Mask b_){ return _mm256_or_pd(a_, b_); }
+    static Reg select(Mask mask_, Reg ifTrue_, Reg ifFalse_){ return _mm256_blendv_pd(ifFalse_, ifTrue_, mask_); }
+    static Idx laneOffset(int stride_){ return _mm_mullo_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(stride_)); }
+    static Idx toIdx(Reg a_){ return _mm256_cvttpd_epi32(a_); }
+    static Idx addIdx(Idx a_, Idx b_){ return _mm_add_epi32(a_, b_); }
+    static Reg gather(const double* base_, Idx idx_){
+      // scalar loads: faster than vgatherdpd for 4 lanes on most CPUs
+      return _mm256_setr_pd(
+          base_[_mm_extract_epi32(idx_, 0)], base_[_mm_extract_epi32(idx_, 1)],
+          base_[_mm_extract_epi32(idx_, 2)], base_[_mm_extract_epi32(idx_, 3)]
+      );
+    }
+    static void loadRows4(const double* base_, Idx idx_, Reg* out_){
+      // 4 contiguous values per lane: 4 plain loads + a 4x4 transpose beats 4 gathers
+      transpose4(
+          _mm256_loadu_pd(base_ + _mm_extract_epi32(idx_, 0)), _mm256_loadu_pd(base_ + _mm_extract_epi32(idx_, 1)),
+          _mm256_loadu_pd(base_ + _mm_extract_epi32(idx_, 2)), _mm256_loadu_pd(base_ + _mm_extract_epi32(idx_, 3)),
+          out_
+      );
+    }
+    static void transpose4(Reg r0_, Reg r1_, Reg r2_, Reg r3_, Reg* out_){
+      const Reg t0{_mm256_unpacklo_pd(r0_, r1_)};
+      const Reg t1{_mm256_unpackhi_pd(r0_, r1_)};
+      const Reg t2{_mm256_unpacklo_pd(r2_, r3_)};
+      const Reg t3{_mm256_unpackhi_pd(r2_, r3_)};
+      out_[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+      out_[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+      out_[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+      out_[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+    }
+  };
+}
+
+namespace SplineBatch{
+  const KernelTable& getAvx2KernelTable(){
+    static const KernelTable table{Impl::makeKernelTable<PackAvx2>()};
+    return table;
+  }
+}
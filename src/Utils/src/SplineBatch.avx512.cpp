@@ -0,0 +1,82 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+// Compiled with -mavx512f: only called once the CPU support has been checked by SplineBatch.cpp
+
+#include "SplineBatch.impl.h"
+
+#include <immintrin.h>
+
+
+namespace {
+  struct PackAvx512{
+    typedef __m512d Reg;
+    typedef __m256i Idx;
+    typedef __mmask8 Mask;
+    static constexpr size_t width{8};
+
+    static Reg set1(double x_){ return _mm512_set1_pd(x_); }
+    static Reg load(const double* ptr_){ return _mm512_loadu_pd(ptr_); }
+    static void store(double* ptr_, Reg a_){ _mm512_storeu_pd(ptr_, a_); }
+    static Reg add(Reg a_, Reg b_){ return _mm512_add_pd(a_, b_); }
+    static Reg sub(Reg a_, Reg b_){ return _mm512_sub_pd(a_, b_); }
+    static Reg mul(Reg a_, Reg b_){ return _mm512_mul_pd(a_, b_); }
+    static Reg div(Reg a_, Reg b_){ return _mm512_div_pd(a_, b_); }
+    static Reg min(Reg a_, Reg b_){ return _mm512_min_pd(a_, b_); }
+    static Reg max(Reg a_, Reg b_){ return _mm512_max_pd(a_, b_); }
+    static Reg trunc(Reg a_){ return _mm512_roundscale_pd(a_, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+    static Mask gt(Reg a_, Reg b_){ return _mm512_cmp_pd_mask(a_, b_, _CMP_GT_OQ); }
+    static Mask le(Reg a_, Reg b_){ return _mm512_cmp_pd_mask(a_, b_, _CMP_LE_OQ); }
+    static Mask maskOr(Mask a_, Mask b_){ return Mask(a_ | b_); }
+    static Reg select(Mask mask_, Reg ifTrue_, Reg ifFalse_){ return _mm512_mask_blend_pd(mask_, ifFalse_, ifTrue_); }
+    static Idx laneOffset(int stride_){
+      return _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride_));
+    }
+    static Idx toIdx(Reg a_){ return _mm512_cvttpd_epi32(a_); }
+    static Idx addIdx(Idx a_, Idx b_){ return _mm256_add_epi32(a_, b_); }
+    static Reg gather(const double* base_, Idx idx_){
+      // scalar loads: faster than vgatherdpd on most CPUs
+      alignas(32) int idx[8];
+      _mm256_store_si256(reinterpret_cast<__m256i*>(idx), idx_);
+      return _mm512_setr_pd(
+          base_[idx[0]], base_[idx[1]], base_[idx[2]], base_[idx[3]],
+          base_[idx[4]], base_[idx[5]], base_[idx[6]], base_[idx[7]]
+      );
+    }
+    static void loadRows4(const double* base_, Idx idx_, Reg* out_){
+      // 4 contiguous values per lane: 8 plain loads + two 4x4 transposes beat 4 gathers
+      alignas(32) int idx[8];
+      _mm256_store_si256(reinterpret_cast<__m256i*>(idx), idx_);
+      __m256d low[4], high[4];
+      transpose4(
+          _mm256_loadu_pd(base_ + idx[0]), _mm256_loadu_pd(base_ + idx[1]),
+          _mm256_loadu_pd(base_ + idx[2]), _mm256_loadu_pd(base_ + idx[3]), low
+      );
+      transpose4(
+          _mm256_loadu_pd(base_ + idx[4]), _mm256_loadu_pd(base_ + idx[5]),
+          _mm256_loadu_pd(base_ + idx[6]), _mm256_loadu_pd(base_ + idx[7]), high
+      );
+      for( int iRow = 0 ; iRow < 4 ; iRow++ ){
+        out_[iRow] = _mm512_insertf64x4(_mm512_castpd256_pd512(low[iRow]), high[iRow], 1);
+      }
+    }
+    static void transpose4(__m256d r0_, __m256d r1_, __m256d r2_, __m256d r3_, __m256d* out_){
+      const __m256d t0{_mm256_unpacklo_pd(r0_, r1_)};
+      const __m256d t1{_mm256_unpackhi_pd(r0_, r1_)};
+      const __m256d t2{_mm256_unpacklo_pd(r2_, r3_)};
+      const __m256d t3{_mm256_unpackhi_pd(r2_, r3_)};
+      out_[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+      out_[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+      out_[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+      out_[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+    }
+  };
+}
+
+namespace SplineBatch{
+  const KernelTable& getAvx512KernelTable(){
+    static const KernelTable table{Impl::makeKernelTable<PackAvx512>()};
+    return table;
+  }
+}
@@ -0,0 +1,122 @@
+//
+// Created by Nadrino on 16/10/2026.
+//
+
+#include "SplineBatch.impl.h"
+
+#include "Logger.h"
+
+#include <atomic>
+
+LoggerInit([]{ Logger::setUserHeaderStr("[SplineBatch]"); });
+
+
+namespace SplineBatch{
+
+  namespace {
+    template<double (*evalScalar)(double, const double*, int, double, double)> void evalManyScalar(
+        double x_, const double* dataBlock_, int dim_, size_t nSplines_, double* out_, double lowerBound_, double upperBound_
+    ){
+      for( size_t iSpline = 0 ; iSpline < nSplines_ ; iSpline++ ){
+        out_[iSpline] = evalScalar(x_, dataBlock_ + iSpline*dim_, dim_, lowerBound_, upperBound_);
+      }
+    }
+    template<double (*evalScalar)(double, const double*, int, double, double)> void evalScanScalar(
+        const double* xList_, size_t nX_, const double* data_, int dim_, double* out_, double lowerBound_, double upperBound_
+    ){
+      for( size_t iX = 0 ; iX < nX_ ; iX++ ){
+        out_[iX] = evalScalar(xList_[iX], data_, dim_, lowerBound_, upperBound_);
+      }
+    }
+
+    SimdLevel detectMaxSimdLevel(){
+#ifdef GUNDAM_SPLINE_BATCH_X86
+      __builtin_cpu_init();
+      if( __builtin_cpu_supports("avx512f") and __builtin_cpu_supports("avx2") ){ return SimdLevel::Avx512; }
+      if( __builtin_cpu_supports("avx2") ){ return SimdLevel::Avx2; }
+#endif
+      return SimdLevel::Scalar;
+    }
+
+    const KernelTable& getKernelTable(SimdLevel simdLevel_){
+#ifdef GUNDAM_SPLINE_BATCH_X86
+      if( simdLevel_ == SimdLevel::Avx512 ){ return getAvx512KernelTable(); }
+      if( simdLevel_ == SimdLevel::Avx2 ){ return getAvx2KernelTable(); }
+#endif
+      return getScalarKernelTable();
+    }
+
+    std::atomic<const KernelTable*> activeKernelTable{nullptr};
+    std::atomic<SimdLevel> activeSimdLevel{SimdLevel::Scalar};
+
+    const KernelTable& getActiveKernelTable(){
+      const KernelTable* table{activeKernelTable.load(std::memory_order_acquire)};
+      if( table == nullptr ){
+        setSimdLevel(getMaxSimdLevel());
+        table = activeKernelTable.load(std::memory_order_acquire);
+      }
+      return *table;
+    }
+  }
+
+  const KernelTable& getScalarKernelTable(){
+    static const KernelTable table{
+        &evalManyScalar<&Impl::evalUniformScalar>, &evalManyScalar<&Impl::evalGeneralScalar>,
+        &evalManyScalar<&Impl::evalMonotonicScalar>,
+        &evalScanScalar<&Impl::evalUniformScalar>, &evalScanScalar<&Impl::evalGeneralScalar>,
+        &evalScanScalar<&Impl::evalMonotonicScalar>
+    };
+    return table;
+  }
+
+  SimdLevel getSimdLevel(){
+    getActiveKernelTable();
+    return activeSimdLevel.load();
+  }
+  SimdLevel getMaxSimdLevel(){
+    static const SimdLevel maxSimdLevel{detectMaxSimdLevel()};
+    return maxSimdLevel;
+  }
+  void setSimdLevel(SimdLevel simdLevel_){
+    if( int(simdLevel_) > int(getMaxSimdLevel()) ){
+      LogWarning << toString(simdLevel_) << " is not available, using " << toString(getMaxSimdLevel()) << std::endl;
+      simdLevel_ = getMaxSimdLevel();
+    }
+    activeSimdLevel.store(simdLevel_);
+    activeKernelTable.store(&getKernelTable(simdLevel_), std::memory_order_release);
+  }
+  std::string toString(SimdLevel simdLevel_){
+    switch( simdLevel_ ){
+      case SimdLevel::Avx512: return "AVX-512";
+      case SimdLevel::Avx2: return "AVX2";
+      default: return "scalar";
+    }
+  }
+
+  void evalUniformSplines(double x_, const double* dataBlock_, int dim_, size_t nSplines_, double* out_,
+                          double lowerBound_, double upperBound_){
+    getActiveKernelTable().evalUniformSplines(x_, dataBlock_, dim_, nSplines_, out_, lowerBound_, upperBound_);
+  }
+  void evalGeneralSplines(double x_, const double* dataBlock_, int dim_, size_t nSplines_, double* out_,
+                          double lowerBound_, double upperBound_){
+    getActiveKernelTable().evalGeneralSplines(x_, dataBlock_, dim_, nSplines_, out_, lowerBound_, upperBound_);
+  }
+  void evalMonotonicSplines(double x_, const double* dataBlock_, int dim_, size_t nSplines_, double* out_,
+                            double lowerBound_, double upperBound_){
+    getActiveKernelTable().evalMonotonicSplines(x_, dataBlock_, dim_, nSplines_, out_, lowerBound_, upperBound_);
+  }
+
+  void evalUniformSpline(const double* xList_, size_t nX_, const double* data_, int dim_, double* out_,
+                         double lowerBound_, double upperBound_){
+    getActiveKernelTable().evalUniformSpline(xList_, nX_, data_, dim_, out_, lowerBound_, upperBound_);
+  }
+  void evalGeneralSpline(const double* xList_, size_t nX_, const double* data_, int dim_, double* out_,
+                         double lowerBound_, double upperBound_){
+    getActiveKernelTable().evalGeneralSpline(xList_, nX_, data_, dim_, out_, lowerBound_, upperBound_);
+  }
+  void evalMonotonicSpline(const double* xList_, size_t nX_, const double* data_, int dim_, double* out_,
+                           double lowerBound_, double upperBound_){
+    getActiveKernelTable().evalMonotonicSpline(xList_, nX_, data_, dim_, out_, lowerBound_, upperBound_);
+  }
+
+}